@@ -16,9 +16,16 @@
 
 import type {
   EnsureTrainedDataOptions,
+  NativeAddon,
+  TesseractCascadeInitOptions,
   TesseractDocumentApi,
-  TesseractConstructor,
   TesseractInitOptions,
+  TesseractOptions,
+  TesseractProcessedFile,
+  TesseractProcessFilesInput,
+  TesseractProcessFilesOptions,
+  TesseractRecognizeFileOptions,
+  TraineddataCompression,
   TrainingDataDownloadProgress,
 } from "./types";
 
@@ -29,32 +36,85 @@ export type {
   DetectOrientationScriptResult,
   EnsureTrainedDataOptions,
   InitOnlyConfigurationVariables,
+  PixPoolOptions,
+  PixPoolStats,
   ProgressChangedInfo,
   SetBoolConfigurationVariableNames,
   SetConfigurationVariableNames,
   SetNumberConfigurationVariableNames,
   SetStringConfigurationVariableNames,
   SetVariableConfigVariables,
+  TesseractAddProcessPageFromFileOptions,
   TesseractBeginProcessPagesOptions,
+  TesseractCascadeInitOptions,
+  TesseractCascadeItem,
+  TesseractCascadeResult,
+  TesseractClientConstructor,
+  TesseractClientInstance,
+  TesseractClientOptions,
+  TesseractClientRecognizeOptions,
+  TesseractComponentImage,
+  TesseractComponentImagesOptions,
   TesseractConstructor,
+  TesseractDaemonInfo,
   TesseractDocumentApi,
+  TesseractFileOutput,
+  TesseractFrame,
+  TesseractFrameLine,
+  TesseractFrameResult,
+  TesseractImageLimits,
   TesseractInitOptions,
   TesseractInstance,
+  TesseractLayout,
+  TesseractLayoutBaseline,
+  TesseractLayoutBlock,
+  TesseractLayoutBlockType,
+  TesseractLayoutBox,
+  TesseractLayoutLine,
+  TesseractLayoutParagraph,
+  TesseractLayoutWord,
+  TesseractMemoryUsage,
+  TesseractOptions,
+  TesseractPdfPageImageOptions,
+  TesseractProcessedFile,
+  TesseractProcessFilesInput,
+  TesseractProcessFilesOptions,
   TesseractProcessPagesStatus,
+  TesseractProfile,
+  TesseractProfileOptions,
+  TesseractRecognizeCascadeOptions,
+  TesseractRecognizedFile,
+  TesseractRecognizeFileOptions,
+  TesseractRecognizeFrameOptions,
+  TesseractRecognizeOptions,
+  TesseractRecognizeRegionsOptions,
+  TesseractRegion,
+  TesseractRegionResult,
   TesseractSetRectangleOptions,
+  TesseractThreadingConfig,
+  TesseractWorkerStatus,
+  TraineddataCompression,
+  TraineddataHeader,
   TrainingDataDownloadProgress,
 } from "./types";
 export type NativeTesseract = import("./types").TesseractInstance;
 
-import { existsSync, createWriteStream } from "node:fs";
-import { mkdir, rename, rm, copyFile } from "node:fs/promises";
+import { existsSync, createReadStream, createWriteStream } from "node:fs";
+import { mkdir, rename, rm, stat } from "node:fs/promises";
 import os from "node:os";
 import path from "node:path";
+import { createInterface } from "node:readline";
 import { Readable, Transform } from "node:stream";
 import { pipeline } from "node:stream/promises";
-import { createGunzip } from "node:zlib";
+import { fileURLToPath, pathToFileURL } from "node:url";
+import zlib, { createGunzip } from "node:zlib";
 import { lock } from "proper-lockfile";
-import { isValidTraineddata } from "./utils";
+import {
+  isValidTraineddata,
+  linkOrCopy,
+  recordTraineddata,
+  verifyTraineddata,
+} from "./utils";
 
 /**
  * All available languages for tesseract
@@ -311,22 +371,32 @@ const prebuildRoot = existsSync(bindingOptionsFromSource)
   ? rootFromSource
   : process.cwd();
 
-const { Tesseract: NativeTesseract } = require("pkg-prebuilds")(
+const {
+  Tesseract: NativeTesseract,
+  TesseractClient,
+  configurePixPool,
+  getPixPoolStats,
+  inspectTraineddata,
+  traineddataCompressions,
+  enableTracing,
+  dumpTrace,
+} = require("pkg-prebuilds")(
   prebuildRoot,
   require(bindingOptionsPath),
-) as { Tesseract: TesseractConstructor };
+) as NativeAddon;
 
 class Tesseract extends NativeTesseract {
   document: TesseractDocumentApi = {
     begin: this.beginProcessPages.bind(this),
     addPage: this.addProcessPage.bind(this),
+    addPageFromFile: this.addProcessPageFromFile.bind(this),
     finish: this.finishProcessPages.bind(this),
     abort: this.abortProcessPages.bind(this),
     status: this.getProcessPagesStatus.bind(this),
   };
 
-  constructor() {
-    super();
+  constructor(options?: TesseractOptions) {
+    super(options);
   }
   async init(options: TesseractInitOptions = {}) {
     options.langs ??= [];
@@ -339,38 +409,161 @@ class Tesseract extends NativeTesseract {
     const dataPath = path.resolve(options.dataPath);
 
     if (options.ensureTraineddata) {
-      for (const lang of [...options.langs, Language.osd]) {
-        const downloadBaseUrl =
-          options.oem === OcrEngineModes.OEM_LSTM_ONLY
-            ? TESSDATA4_BEST(lang)
-            : TESSDATA4(lang);
-
-        lang &&
-          (await this.ensureTrainingData(
-            { lang, dataPath, cachePath, downloadBaseUrl },
-            options.progressCallback,
-          ));
-      }
+      const mirror = options.mirror ?? process.env.NODE_TESSERACT_MIRROR;
+      // languages are provisioned concurrently; each one holds its own lock
+      await Promise.all(
+        [...new Set([...options.langs, Language.osd])]
+          .filter(Boolean)
+          .map((lang) =>
+            this.ensureTrainingData(
+              {
+                lang,
+                dataPath,
+                cachePath,
+                compression: options.traineddataCompression,
+                downloadBaseUrl:
+                  options.oem === OcrEngineModes.OEM_LSTM_ONLY
+                    ? mirror
+                      ? mirrorBaseUrl(mirror, "best")
+                      : TESSDATA4_BEST(lang)
+                    : mirror
+                      ? mirrorBaseUrl(mirror, "fast")
+                      : TESSDATA4(lang),
+              },
+              options.progressCallback,
+            ),
+          ),
+      );
     }
 
     return super.init(options);
   }
 
+  async initCascade(options: TesseractCascadeInitOptions = {}) {
+    options.langs ??= [];
+    options.ensureTraineddata ??= true;
+    options.cachePath ??= path.join(DEFAULT_CACHE_DIR, "best");
+    options.dataPath ??= options.cachePath;
+    options.oem ??= OcrEngineModes.OEM_LSTM_ONLY;
+
+    const cachePath = path.resolve(options.cachePath);
+    const dataPath = path.resolve(options.dataPath);
+
+    if (options.ensureTraineddata) {
+      const mirror = options.mirror ?? process.env.NODE_TESSERACT_MIRROR;
+      await Promise.all(
+        [...new Set(options.langs)].map((lang) =>
+          this.ensureTrainingData(
+            {
+              lang,
+              dataPath,
+              cachePath,
+              compression: options.traineddataCompression,
+              downloadBaseUrl: mirror
+                ? mirrorBaseUrl(mirror, "best")
+                : TESSDATA4_BEST(lang),
+            },
+            options.progressCallback,
+          ),
+        ),
+      );
+    }
+
+    return super.initCascade(options);
+  }
+
+  async *processFiles(
+    input: TesseractProcessFilesInput,
+    options: TesseractProcessFilesOptions = {},
+  ): AsyncGenerator<TesseractProcessedFile> {
+    const readahead = options.readahead ?? 4;
+    if (!Number.isInteger(readahead) || readahead < 0 || readahead > 64) {
+      throw new RangeError(
+        `readahead must be an integer between 0 and 64, got ${String(readahead)}`,
+      );
+    }
+    const order = options.order ?? "input";
+    const recognizeOptions: TesseractRecognizeFileOptions = {
+      outputs: options.outputs,
+      vars: options.vars,
+      readahead,
+    };
+    const paths = "manifest" in input ? readManifest(input.manifest) : input;
+
+    // the native side decodes up to `readahead` queued files while the
+    // current one is recognized, so keeping that many queued behind the
+    // running one keeps it busy
+    const inFlight = new Map<number, Promise<TesseractProcessedFile>>();
+    const take = async () => {
+      const processed =
+        order === "input"
+          ? await inFlight.values().next().value!
+          : await Promise.race(inFlight.values());
+      inFlight.delete(processed.index);
+      return processed;
+    };
+
+    let index = 0;
+    for await (const filePath of paths) {
+      const fileIndex = index++;
+      await this.waitForCapacity();
+      inFlight.set(
+        fileIndex,
+        this.recognizeFile(filePath, recognizeOptions).then(
+          (result) => ({ index: fileIndex, path: filePath, result }),
+          (error) => ({ index: fileIndex, path: filePath, error }),
+        ),
+      );
+      if (inFlight.size > readahead) {
+        yield await take();
+      }
+    }
+    while (inFlight.size > 0) {
+      yield await take();
+    }
+  }
+
   async ensureTrainingData(
-    { lang, dataPath, cachePath, downloadBaseUrl }: EnsureTrainedDataOptions,
+    {
+      lang,
+      dataPath,
+      cachePath,
+      downloadBaseUrl,
+      compression = "none",
+    }: EnsureTrainedDataOptions,
     progressCallback?: (info: TrainingDataDownloadProgress) => void,
   ) {
-    const traineddataPath = path.join(dataPath, `${lang}.traineddata`);
-    const cacheTraineddataPath = path.join(cachePath, `${lang}.traineddata`);
+    const suffix = COMPRESSION_SUFFIX[compression];
+    if (suffix === undefined) {
+      throw new TypeError(
+        `traineddataCompression must be "none", "gzip" or "zstd", got ${String(compression)}`,
+      );
+    }
+    // init could not read a model the addon cannot decompress
+    if (!traineddataCompressions.includes(compression)) {
+      throw new Error(
+        `Cannot store traineddata for ${lang} as ${compression}: the addon was built without ${compression} support`,
+      );
+    }
+    const fileName = `${lang}.traineddata${suffix}`;
+    const traineddataPath = path.join(dataPath, fileName);
+    const cacheTraineddataPath = path.join(cachePath, fileName);
+    const verify = (filePath: string) =>
+      verifyTraineddata(filePath, inspectTraineddata);
+    const provisionFrom = async (source: string) => {
+      if (await linkOrCopy(source, traineddataPath)) {
+        await recordTraineddata(traineddataPath);
+      }
+    };
 
-    if (await isValidTraineddata(cacheTraineddataPath)) {
+    if (await verify(cacheTraineddataPath)) {
       if (traineddataPath !== cacheTraineddataPath) {
         await mkdir(dataPath, { recursive: true });
-        await copyFile(cacheTraineddataPath, traineddataPath);
+        await provisionFrom(cacheTraineddataPath);
       }
       return traineddataPath;
     }
-    if (await isValidTraineddata(traineddataPath)) {
+    if (await verify(traineddataPath)) {
       return traineddataPath;
     }
 
@@ -385,41 +578,79 @@ class Tesseract extends NativeTesseract {
     });
 
     try {
-      if (await isValidTraineddata(traineddataPath)) {
+      if (await verify(traineddataPath)) {
         return traineddataPath;
       }
       if (
         traineddataPath !== cacheTraineddataPath &&
-        (await isValidTraineddata(cacheTraineddataPath))
+        (await verify(cacheTraineddataPath))
       ) {
-        await copyFile(cacheTraineddataPath, traineddataPath);
+        await provisionFrom(cacheTraineddataPath);
         return traineddataPath;
       }
 
-      const url = new URL(`${lang}.traineddata.gz`, downloadBaseUrl).toString();
-      const response = await fetch(url);
+      const source = new URL(`${lang}.traineddata.gz`, downloadBaseUrl);
+      const url = source.toString();
+
+      if (source.protocol === "file:") {
+        // local mirror: a model already stored the way it is kept here is
+        // linked in as it is
+        const mirrorPath = fileURLToPath(new URL(fileName, downloadBaseUrl));
+        if (
+          (compression !== "none" ||
+            !(await isValidTraineddata(fileURLToPath(source)))) &&
+          (await isValidTraineddata(mirrorPath))
+        ) {
+          const header = inspectTraineddata(mirrorPath);
+          if (!header.valid) {
+            throw new Error(
+              `Mirrored traineddata for ${lang} is corrupt: ${header.reason}`,
+            );
+          }
+          await provisionFrom(mirrorPath);
+          return traineddataPath;
+        }
+      }
 
-      if (!response.ok || !response.body) {
-        throw new Error(
-          `Failed to download traineddata for ${lang}: ${response.status} ${response.statusText}`,
+      // gzip keeps the downloaded bytes as they are
+      const stages =
+        compression === "none"
+          ? [createGunzip()]
+          : compression === "zstd"
+            ? [createGunzip(), createZstdCompress(lang)]
+            : [];
+      let body: Readable;
+      let totalBytes: number | undefined;
+
+      if (source.protocol === "file:") {
+        const gzPath = fileURLToPath(source);
+        totalBytes = await stat(gzPath).then(
+          (info) => info.size,
+          () => {
+            throw new Error(
+              `Failed to read traineddata for ${lang}: ${gzPath} not found`,
+            );
+          },
         );
+        body = createReadStream(gzPath);
+      } else {
+        const response = await fetch(url);
+
+        if (!response.ok || !response.body) {
+          throw new Error(
+            `Failed to download traineddata for ${lang}: ${response.status} ${response.statusText}`,
+          );
+        }
+
+        const totalBytesHeader = response.headers.get("content-length");
+        totalBytes = totalBytesHeader ? Number(totalBytesHeader) : undefined;
+        body = Readable.fromWeb(response.body);
       }
 
-      const tmpPath = path.join(
-        os.tmpdir(),
-        [
-          "node-tesseract-ocr",
-          lang,
-          "traineddata",
-          process.pid,
-          Date.now(),
-          Math.random().toString(36).slice(2),
-        ].join("-"),
-      );
-      const totalBytesHeader = response.headers.get("content-length");
-      const totalBytes = totalBytesHeader
-        ? Number(totalBytesHeader)
-        : undefined;
+      // next to the target, so the final rename never crosses devices; it
+      // keeps the target's suffix, which tells inspectTraineddata how to
+      // read it
+      const tmpPath = `${traineddataPath}.${process.pid}.${Math.random().toString(36).slice(2)}.tmp${suffix}`;
       let downloadedBytes = 0;
       const progressStream = new Transform({
         transform(chunk, _, callback) {
@@ -442,27 +673,26 @@ class Tesseract extends NativeTesseract {
       });
 
       try {
-        await pipeline(
-          Readable.fromWeb(response.body),
+        await pipeline([
+          body,
           progressStream,
-          createGunzip(),
+          ...stages,
           createWriteStream(tmpPath),
-        );
-        try {
-          await rename(tmpPath, traineddataPath);
-        } catch (error) {
-          if ((error as { code?: string }).code === "EXDEV") {
-            await copyFile(tmpPath, traineddataPath);
-            await rm(tmpPath, { force: true });
-          } else {
-            throw error;
-          }
+        ]);
+        // catch corrupt models here rather than in TessBaseAPI::Init
+        const header = inspectTraineddata(tmpPath);
+        if (!header.valid) {
+          throw new Error(
+            `Downloaded traineddata for ${lang} is corrupt: ${header.reason}`,
+          );
         }
+        await rename(tmpPath, traineddataPath);
       } catch (error) {
         await rm(tmpPath, { force: true });
         throw error;
       }
 
+      await recordTraineddata(traineddataPath);
       return traineddataPath;
     } finally {
       await release();
@@ -470,5 +700,57 @@ class Tesseract extends NativeTesseract {
   }
 }
 
-export { Tesseract, NativeTesseract };
+const COMPRESSION_SUFFIX: Record<TraineddataCompression, string> = {
+  none: "",
+  gzip: ".gz",
+  zstd: ".zst",
+};
+
+function createZstdCompress(lang: string) {
+  // node:zlib has zstd since 22.15 / 23.8
+  if (typeof zlib.createZstdCompress !== "function") {
+    throw new Error(
+      `Cannot store traineddata for ${lang} as zstd: Node.js ${process.version} has no zstd support`,
+    );
+  }
+  return zlib.createZstdCompress();
+}
+
+// A mirror holds `<lang>.traineddata.gz` (or plain `<lang>.traineddata`)
+// files side by side: a directory, a `file://` URL or an http(s) URL. Like
+// the CDN it keeps the fast models apart from the best ones, which live in
+// its `best/` subdirectory.
+function mirrorBaseUrl(mirror: string, models: "fast" | "best") {
+  let base = /^[a-z][a-z\d+.-]*:\/\//i.test(mirror)
+    ? mirror
+    : pathToFileURL(path.resolve(mirror)).toString();
+  base = base.endsWith("/") ? base : `${base}/`;
+  return models === "best" ? `${base}best/` : base;
+}
+
+async function* readManifest(manifestPath: string): AsyncGenerator<string> {
+  const baseDir = path.dirname(path.resolve(manifestPath));
+  const lines = createInterface({
+    input: createReadStream(manifestPath),
+    crlfDelay: Infinity,
+  });
+  for await (const line of lines) {
+    const entry = line.trim();
+    if (entry && !entry.startsWith("#")) {
+      yield path.resolve(baseDir, entry);
+    }
+  }
+}
+
+export {
+  Tesseract,
+  NativeTesseract,
+  TesseractClient,
+  configurePixPool,
+  getPixPoolStats,
+  inspectTraineddata,
+  traineddataCompressions,
+  enableTracing,
+  dumpTrace,
+};
 export default Tesseract;
@@ -756,6 +756,57 @@ export type SetStringConfigurationVariableNames = {
 /**
  * Tesseract init options
  */
+export interface TesseractImageLimits {
+  /**
+   * Maximum width in pixels, `0` for no limit
+   * @default 0
+   */
+  maxWidth?: number;
+
+  /**
+   * Maximum height in pixels, `0` for no limit
+   * @default 0
+   */
+  maxHeight?: number;
+
+  /**
+   * Maximum width * height, `0` for no limit
+   * @default 0
+   */
+  maxPixels?: number;
+
+  /**
+   * Maximum raster bytes of decoding and normalizing a page (derived from
+   * the dimensions and bit depth; colormapped images count as widened to
+   * 32 bpp), `0` for no limit
+   * @default 1073741824 (1 GiB)
+   */
+  maxBytes?: number;
+
+  /**
+   * Maximum page count of multi-page TIFFs, `0` for no limit
+   * @default 0
+   */
+  maxPages?: number;
+
+  /**
+   * Decode JPEGs that exceed a limit at 1/2, 1/4 or 1/8 scale instead of
+   * rejecting them, if one of those sizes fits
+   * @default false
+   */
+  downscale?: boolean;
+}
+
+export interface TesseractOptions {
+  /**
+   * Jobs the submission queue holds before it is full, rounded up to a
+   * power of two (at least 2). Calls made while it is full reject with
+   * `ERR_QUEUE_FULL`; await `waitForCapacity()` to wait for room instead.
+   * @default 1024
+   */
+  queueCapacity?: number;
+}
+
 export interface TesseractInitOptions {
   /**
    * Its generally safer to use as few languages as possible.
@@ -803,6 +854,26 @@ export interface TesseractInitOptions {
    */
   ensureTraineddata?: boolean;
 
+  /**
+   * Local mirror for air-gapped hosts, used instead of the CDN: a directory,
+   * `file://` URL or http(s) URL holding `<lang>.traineddata.gz` (or plain
+   * `<lang>.traineddata`) files side by side. The best models that
+   * `OEM_LSTM_ONLY` and `initCascade` use are read from its `best/`
+   * subdirectory.
+   * @default process.env.NODE_TESSERACT_MIRROR
+   */
+  mirror?: string;
+
+  /**
+   * How provisioned models are kept on disk. `"gzip"` stores the downloaded
+   * `.traineddata.gz` as it is, `"zstd"` recompresses it to
+   * `.traineddata.zst` (needs Node.js >= 22.15 and an addon built with
+   * libzstd). Compressed models are decompressed straight into memory by
+   * `init`; a plain `.traineddata` next to them still takes precedence.
+   * @default "none"
+   */
+  traineddataCompression?: TraineddataCompression;
+
   /**
    * Optional progress callback for traineddata downloads.
    */
@@ -823,6 +894,41 @@ export interface TesseractInitOptions {
    */
   setOnlyNonDebugParams?: boolean;
 
+  /**
+   * Size of the OpenMP thread team Tesseract may use inside this instance.
+   * Applied on the instance's worker thread only, so running many instances
+   * side by side does not multiply into `instances * cores` busy threads.
+   * Has no effect if the addon was built without OpenMP.
+   * @default process default (usually the number of cores)
+   * @throws {Error} Will throw an error when it is below 1
+   */
+  intraOpThreads?: number;
+
+  /**
+   * Pins the instance's worker thread to the given CPU indices.
+   * Only supported on Linux.
+   */
+  cpuAffinity?: number[];
+
+  /**
+   * Upper bound in bytes for native memory held by this instance
+   * (queued image buffers, the decoded page and loaded models).
+   * Jobs carrying image data that would exceed it are rejected with
+   * `ERR_MEMORY_BUDGET`. `0` disables the budget. Takes effect when the
+   * engine is initialized; a rejected `init(...)` keeps the previous one.
+   * @default 0
+   */
+  memoryBudget?: number;
+
+  /**
+   * Limits checked against the header of every encoded image (`setImage`,
+   * `setInputImage`, `addProcessPage`) before it is decoded.
+   * Images over a limit are rejected with `ERR_IMAGE_LIMIT`. Apply to jobs
+   * that run after the engine is initialized; a rejected `init(...)` keeps
+   * the previous limits.
+   */
+  imageLimits?: TesseractImageLimits;
+
   /**
    * Array of paths that point to their corresponding config files
    * usually located in the `dataPath` location alongside the training data
@@ -857,11 +963,477 @@ export interface TesseractSetRectangleOptions {
   height: number;
 }
 
+export interface TesseractRecognizeOptions {
+  /**
+   * Detect orientation on a downscaled copy of the image, rotate the page
+   * upright on the worker and recognize it in the same call.
+   * The rectangle set via `setRectangle(...)` is reset to the full page.
+   * @default false
+   */
+  autoRotate?: boolean;
+  /**
+   * Variables set for this call only. They stay set for later calls that
+   * render, e.g. `getUTF8Text()`, and are restored before the next
+   * recognizing call without them and before any variable read or write.
+   */
+  vars?: Partial<SetVariableConfigVariables>;
+}
+
+export type TesseractFileOutput = "text" | "hocr" | "tsv" | "alto";
+
+export interface TesseractRecognizeFileOptions {
+  /**
+   * Outputs rendered for the file, others stay empty
+   * @default ["text"]
+   */
+  outputs?: TesseractFileOutput[];
+  /**
+   * Variables set for this call only, restored before the next
+   * recognizing call that does not set them
+   */
+  vars?: Partial<SetVariableConfigVariables>;
+  /**
+   * Decoded pages the prefetch thread may hold ahead of the page being
+   * recognized before it decodes this file, 0 to 64
+   * @default 1
+   */
+  readahead?: number;
+}
+
+export interface TesseractRecognizedFile {
+  path: string;
+  width: number;
+  height: number;
+  meanConfidence: number;
+  text: string;
+  hocr: string;
+  tsv: string;
+  alto: string;
+}
+
+export interface TesseractProfileOptions {
+  /**
+   * Page segmentation mode of the profile's jobs; the instance's mode is
+   * restored after each job
+   */
+  psm?: PageSegmentationMode;
+  /**
+   * Recognize only this rectangle of each image
+   */
+  rect?: TesseractSetRectangleOptions;
+  /**
+   * Variables the jobs of the profile run with, like `vars` of
+   * `recognize(...)`: a run of jobs with the same profile sets them once,
+   * and the engine's own values are restored before any other recognizing
+   * job.
+   */
+  vars?: Partial<SetVariableConfigVariables>;
+  /**
+   * Outputs rendered for each image, others stay empty
+   * @default ["text"]
+   */
+  outputs?: TesseractFileOutput[];
+  /**
+   * Cancel recognition after this many milliseconds, 0 for no limit
+   * @default 0
+   */
+  timeout?: number;
+}
+
+/**
+ * Opaque handle of validated job options, see `createProfile(...)`.
+ */
+export interface TesseractProfile {
+  readonly __brand: "TesseractProfile";
+}
+
+export interface TesseractProcessFilesOptions
+  extends TesseractRecognizeFileOptions {
+  /**
+   * Files queued, read and decoded ahead of the one being recognized,
+   * 0 to 64
+   * @default 4
+   */
+  readahead?: number;
+
+  /**
+   * Yield results in input order or as soon as each file completes
+   * @default "input"
+   */
+  order?: "input" | "completion";
+}
+
+/**
+ * File paths, or a manifest file listing one path per line (relative paths
+ * are resolved against the manifest's directory, `#` starts a comment).
+ */
+export type TesseractProcessFilesInput =
+  | Iterable<string>
+  | AsyncIterable<string>
+  | { manifest: string };
+
+export interface TesseractProcessedFile {
+  /**
+   * Position of the file in the input
+   */
+  index: number;
+  path: string;
+
+  /**
+   * Set if the file was recognized
+   */
+  result?: TesseractRecognizedFile;
+
+  /**
+   * Set if reading, decoding or recognizing the file failed
+   */
+  error?: TesseractNativeError;
+}
+
+export interface TesseractRegion extends TesseractSetRectangleOptions {
+  /**
+   * Page segmentation mode for this region.
+   * Falls back to `options.psm` and then to the current page mode.
+   */
+  psm?: PageSegmentationMode;
+}
+
+export interface TesseractRecognizeRegionsOptions {
+  /**
+   * Default page segmentation mode for regions without their own `psm`.
+   */
+  psm?: PageSegmentationMode;
+}
+
+/**
+ * One raw frame of a video or screen capture stream.
+ */
+export interface TesseractFrame {
+  /**
+   * Raw pixels, row by row: gray, RGB or RGBA by `bytesPerPixel`
+   */
+  data: Buffer;
+  width: number;
+  height: number;
+  bytesPerPixel: 1 | 3 | 4;
+
+  /**
+   * Bytes from one row to the next. Defaults to `width * bytesPerPixel`.
+   */
+  bytesPerLine?: number;
+}
+
+export interface TesseractRecognizeFrameOptions {
+  /**
+   * Edge length of the tiles compared between frames, 8-1024 pixels.
+   * Changing it starts the stream over. Defaults to 32.
+   */
+  tileSize?: number;
+
+  /**
+   * Forget the previous frame and its text, e.g. at a scene cut.
+   */
+  reset?: boolean;
+}
+
+export interface TesseractFrameLine {
+  /**
+   * Stays the same for as long as the line is unchanged
+   */
+  id: number;
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+  text: string;
+
+  /**
+   * Confidence of the line (0-100)
+   */
+  confidence: number;
+}
+
+export interface TesseractFrameResult {
+  /**
+   * Index of the frame in the stream, counted since the first frame
+   */
+  frame: number;
+
+  /**
+   * Tiles that differ from the previous frame; all of them for the first
+   */
+  changedTiles: number;
+  totalTiles: number;
+
+  /**
+   * Lines recognized in this frame
+   */
+  added: TesseractFrameLine[];
+
+  /**
+   * Ids of lines that changed or disappeared. A line that was read again
+   * is in `added` under a new id. When the stream starts over (`reset`, a
+   * new size or format, or after a failed frame) every earlier line is
+   * listed.
+   */
+  removed: number[];
+
+  /**
+   * Text of every line currently on screen, top to bottom
+   */
+  text: string;
+}
+
+export interface TesseractRegionResult {
+  top: number;
+  left: number;
+  width: number;
+  height: number;
+
+  /**
+   * Page segmentation mode that was used for this region
+   */
+  psm: PageSegmentationMode;
+
+  /**
+   * Recognized UTF-8 text of the region
+   */
+  text: string;
+
+  /**
+   * Mean text confidence of the region (0-100)
+   */
+  confidence: number;
+}
+
+/**
+ * Options for the second, more accurate engine used by `recognizeCascade`.
+ * Traineddata defaults to a separate `best` cache directory, so the best
+ * models never overwrite the fast models of the primary engine.
+ */
+export type TesseractCascadeInitOptions = Pick<
+  TesseractInitOptions,
+  | "langs"
+  | "cachePath"
+  | "dataPath"
+  | "ensureTraineddata"
+  | "mirror"
+  | "traineddataCompression"
+  | "progressCallback"
+  | "oem"
+>;
+
+export interface TesseractRecognizeCascadeOptions {
+  /**
+   * Items below this confidence (0-100) are re-recognized by the cascade engine
+   * @default 80
+   */
+  minConfidence?: number;
+
+  /**
+   * Granularity of the items that are checked and re-recognized
+   * @default "word"
+   */
+  level?: "word" | "textline";
+}
+
+export interface TesseractCascadeItem {
+  text: string;
+
+  /**
+   * Confidence (0-100) of the text that was kept
+   */
+  confidence: number;
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+
+  /**
+   * True if the text comes from the cascade engine
+   */
+  refined: boolean;
+}
+
+export interface TesseractCascadeResult {
+  /**
+   * Merged text of all items
+   */
+  text: string;
+
+  /**
+   * Number of items replaced by the cascade engine
+   */
+  refinedCount: number;
+  items: TesseractCascadeItem[];
+}
+
+export type TesseractLayoutBlockType =
+  | "unknown"
+  | "flowingText"
+  | "headingText"
+  | "pulloutText"
+  | "equation"
+  | "inlineEquation"
+  | "table"
+  | "verticalText"
+  | "captionText"
+  | "flowingImage"
+  | "headingImage"
+  | "pulloutImage"
+  | "horizontalLine"
+  | "verticalLine"
+  | "noise";
+
+export interface TesseractLayoutBox {
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+}
+
+export type TesseractLayoutWord = TesseractLayoutBox;
+
+export interface TesseractLayoutBaseline {
+  x1: number;
+  y1: number;
+  x2: number;
+  y2: number;
+}
+
+export interface TesseractLayoutLine extends TesseractLayoutBox {
+  /**
+   * Baseline of the text line, from (x1, y1) to (x2, y2)
+   */
+  baseline: TesseractLayoutBaseline;
+  words: TesseractLayoutWord[];
+}
+
+export interface TesseractLayoutParagraph extends TesseractLayoutBox {
+  lines: TesseractLayoutLine[];
+}
+
+export interface TesseractLayoutBlock extends TesseractLayoutBox {
+  blockType: TesseractLayoutBlockType;
+
+  /**
+   * Direction the top of the text points to, relative to the page
+   */
+  orientation: "pageUp" | "pageRight" | "pageDown" | "pageLeft";
+  writingDirection: "leftToRight" | "rightToLeft" | "topToBottom";
+  textlineOrder: "leftToRight" | "rightToLeft" | "topToBottom";
+
+  /**
+   * Angle (radians) the block has to be rotated by to be level
+   */
+  deskewAngle: number;
+
+  /**
+   * Empty for image, separator and noise blocks
+   */
+  paragraphs: TesseractLayoutParagraph[];
+}
+
+export interface TesseractLayout {
+  blocks: TesseractLayoutBlock[];
+}
+
+export interface TesseractComponentImagesOptions {
+  /**
+   * Layout level of the components to crop
+   * @default "textline"
+   */
+  level?: "block" | "paragraph" | "textline" | "word";
+
+  /**
+   * Only return components that contain text
+   * @default true
+   */
+  textOnly?: boolean;
+
+  /**
+   * Crop from the input image instead of the binarized one
+   * @default false
+   */
+  raw?: boolean;
+
+  /**
+   * Pixels added around each raw crop
+   * @default 0
+   */
+  padding?: number;
+}
+
+export interface TesseractComponentImage {
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+
+  /**
+   * Index of the block the component belongs to
+   */
+  blockIndex: number;
+
+  /**
+   * Index of the paragraph the component belongs to
+   */
+  paragraphIndex: number;
+  image: {
+    width: number;
+    height: number;
+
+    /**
+     * Bits per pixel: 1 for binarized crops, 8 or 32 for raw ones
+     */
+    depth: number;
+
+    /**
+     * Row stride of `data`; rows are padded to 4 bytes
+     */
+    bytesPerLine: number;
+
+    /**
+     * Pixel rows in memory order, 1 bpp packed MSB-first, 32 bpp as RGBA.
+     * External memory owned by the addon.
+     */
+    data: Buffer<ArrayBuffer>;
+  };
+}
+
 export interface TesseractBeginProcessPagesOptions {
   outputBase: string;
   title: string;
   timeout: number;
   textonly: boolean;
+  /**
+   * How page images are stored in the PDF. Ignored for `textonly`.
+   * @default { mode: "keep" }
+   */
+  pageImage?: TesseractPdfPageImageOptions;
+}
+
+export interface TesseractPdfPageImageOptions {
+  /**
+   * `"keep"` embeds each page as decoded (JPEG files as they are),
+   * `"jpeg"` re-encodes it as JPEG on a helper thread while the page is
+   * recognized, `"bilevel"` embeds Tesseract's binarized page, CCITT G4
+   * compressed.
+   */
+  mode: "keep" | "jpeg" | "bilevel";
+
+  /**
+   * `"jpeg"` only: pages above this resolution are downsampled to it
+   * (1-2400). Text positions are not affected.
+   * @default the page's own resolution
+   */
+  dpi?: number;
+
+  /**
+   * `"jpeg"` only: JPEG quality (1-100).
+   * @default 85
+   */
+  jpegQuality?: number;
 }
 
 export interface TesseractAddProcessPageOptions {
@@ -870,6 +1442,15 @@ export interface TesseractAddProcessPageOptions {
   progressCallback?: (info: ProgressChangedInfo) => void;
 }
 
+export interface TesseractAddProcessPageFromFileOptions {
+  /**
+   * Input name passed to the renderer
+   * @default the file path
+   */
+  filename?: string;
+  progressCallback?: (info: ProgressChangedInfo) => void;
+}
+
 export interface TesseractProcessPagesStatus {
   active: boolean;
   healthy: boolean;
@@ -944,11 +1525,171 @@ export interface DetectOrientationScriptResult {
   scriptConfidence: number;
 }
 
+export interface TesseractThreadingConfig {
+  /**
+   * Whether the addon was built with OpenMP support
+   */
+  openmp: boolean;
+
+  /**
+   * Effective OpenMP team size on the worker thread
+   */
+  intraOpThreads: number;
+
+  /**
+   * Number of hardware threads reported by the system
+   */
+  hardwareConcurrency: number;
+
+  /**
+   * CPU indices the worker thread may run on (empty if unknown)
+   */
+  cpuAffinity: number[];
+}
+
+export interface TesseractWorkerStatus {
+  initialized: boolean;
+
+  /**
+   * Jobs waiting behind the running one
+   */
+  queueDepth: number;
+
+  /**
+   * `waitForCapacity()` calls still waiting for room in the queue
+   */
+  queueWaiting: number;
+
+  /**
+   * Capacity of the submission queue
+   */
+  queueCapacity: number;
+
+  /**
+   * Highest queue depth seen since the instance was created
+   */
+  queueHighWater: number;
+
+  /**
+   * Method name of the running job, empty while idle
+   */
+  currentCommand: string;
+
+  /**
+   * Percent complete (0-100) of the running job, if it reports progress
+   */
+  currentProgress: number;
+
+  /**
+   * Milliseconds the running job has been running
+   */
+  currentRunningMillis: number;
+  session: TesseractProcessPagesStatus;
+}
+
+export interface TesseractMemoryUsage {
+  /**
+   * Image buffers copied into queued jobs that did not complete yet, and
+   * pages decoded ahead for `recognizeFile(...)`
+   */
+  inFlightBytes: number;
+
+  /**
+   * Results of finished jobs that were not handed to JS yet
+   */
+  resultBytes: number;
+
+  /**
+   * Decoded input image held by the engine
+   */
+  imageBytes: number;
+
+  /**
+   * Traineddata of the loaded languages, as loaded (compressed models count
+   * their decompressed size)
+   */
+  modelBytes: number;
+
+  /**
+   * Sum of the values above
+   */
+  totalBytes: number;
+
+  /**
+   * Configured budget, `0` if unlimited
+   */
+  budgetBytes: number;
+}
+
+export interface PixPoolOptions {
+  /**
+   * Recycle page-sized Leptonica rasters instead of returning them to malloc
+   * @default true
+   */
+  enabled?: boolean;
+
+  /**
+   * Upper bound for bytes kept in the pool's free lists
+   * @default 268435456 (256 MiB)
+   */
+  maxRetainedBytes?: number;
+}
+
+export interface PixPoolStats {
+  /**
+   * False if the pool was disabled with `NODE_TESSERACT_PIX_POOL=0`
+   */
+  installed: boolean;
+  enabled: boolean;
+
+  /**
+   * Raster allocations made by Leptonica (pooled and pass-through)
+   */
+  allocations: number;
+
+  /**
+   * Page-sized allocations served from the pool
+   */
+  hits: number;
+
+  /**
+   * Page-sized allocations that had to go to malloc
+   */
+  misses: number;
+
+  /**
+   * Bytes currently kept in the free lists
+   */
+  retainedBytes: number;
+  maxRetainedBytes: number;
+}
+
+export interface TraineddataHeader {
+  /**
+   * Component table is consistent with the file (zip archives are accepted
+   * as they are)
+   */
+  valid: boolean;
+
+  /**
+   * Components present in the table
+   */
+  components: number;
+
+  /**
+   * Why the file is not valid, empty otherwise
+   */
+  reason: string;
+}
+
+export type TraineddataCompression = "none" | "gzip" | "zstd";
+
 export type EnsureTrainedDataOptions = {
   lang: Language;
   cachePath: string;
   dataPath: string;
   downloadBaseUrl: string;
+  compression?: TraineddataCompression;
   progressCallback?: (info: TrainingDataDownloadProgress) => void;
 };
 
@@ -960,7 +1701,12 @@ export type TesseractErrorCode =
   | "ERR_OUT_OF_RANGE"
   | "ERR_TESSERACT_RUNTIME"
   | "ERR_WORKER_CLOSED"
-  | "ERR_WORKER_STOPPED";
+  | "ERR_WORKER_STOPPED"
+  | "ERR_MEMORY_BUDGET"
+  | "ERR_IMAGE_LIMIT"
+  | "ERR_QUEUE_FULL"
+  | "ERR_DAEMON_UNAVAILABLE"
+  | "ERR_DAEMON_TIMEOUT";
 
 /**
  * Base shape for errors rejected by native OCR methods.
@@ -990,11 +1736,34 @@ export type TesseractRuntimeError = Error & TesseractNativeError;
  */
 export type TesseractWorkerError = Error & TesseractNativeError;
 
+/**
+ * Admission error (`ERR_MEMORY_BUDGET`), the job was not queued.
+ */
+export type TesseractMemoryBudgetError = Error & TesseractNativeError;
+
+/**
+ * Image refused before decoding (`ERR_IMAGE_LIMIT`).
+ */
+export type TesseractImageLimitError = Error & TesseractNativeError;
+
+/**
+ * Admission error (`ERR_QUEUE_FULL`), the job was not queued.
+ */
+export type TesseractQueueFullError = Error & TesseractNativeError;
+
+/**
+ * `TesseractClient` could not reach `tesseract-ocrd`, lost the connection
+ * or got a malformed reply (`ERR_DAEMON_UNAVAILABLE`), or had no reply
+ * within its `timeout` (`ERR_DAEMON_TIMEOUT`).
+ */
+export type TesseractDaemonError = Error & TesseractNativeError;
+
 export interface TesseractDocumentApi {
   /**
    * Starts a multipage processing session.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
    * @throws {TesseractArgumentError} If options are missing/invalid.
+   * @throws {TesseractRangeError} If `options.pageImage` values are out of range or do not apply to its mode.
    * @throws {TesseractRuntimeError} If session already exists or renderer setup fails.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
@@ -1009,10 +1778,28 @@ export interface TesseractDocumentApi {
    * @throws {TesseractArgumentError} If `options.filename` is provided but is not a string.
    * @throws {TesseractArgumentError} If `options.progressCallback` is provided but is not a function.
    * @throws {TesseractRuntimeError} If no session is active, decode fails, or page processing fails.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
   addPage(options: TesseractAddProcessPageOptions): Promise<void>;
 
+  /**
+   * Adds one page read from a file on the worker thread, without loading
+   * it into the JS heap.
+   * @param {string} path Path of the encoded image.
+   * @param {TesseractAddProcessPageFromFileOptions} options Page options.
+   * @throws {TesseractArgumentError} If `path` is not a non-empty string.
+   * @throws {TesseractArgumentError} If `options` is invalid.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If no session is active, the file cannot be read, decode fails, or page processing fails.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  addPageFromFile(
+    path: string,
+    options?: TesseractAddProcessPageFromFileOptions,
+  ): Promise<void>;
+
   /**
    * Finalizes the active multipage session and returns output PDF path.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
@@ -1048,6 +1835,7 @@ export interface TesseractInstance {
 
   /**
    * Returns whether `init(...)` was completed and not reset via `end()`.
+   * Answered immediately, without waiting for queued or running jobs.
    * @throws {TesseractArgumentError} If called with unexpected arguments.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
@@ -1075,6 +1863,7 @@ export interface TesseractInstance {
    * @throws {TesseractArgumentError} If `buffer` is not a non-empty Buffer.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
    * @throws {TesseractRuntimeError} If leptonica cannot decode `buffer`.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
   setInputImage(buffer: Buffer<ArrayBuffer>): Promise<void>;
@@ -1152,6 +1941,17 @@ export interface TesseractInstance {
    */
   init(options: TesseractInitOptions): Promise<void>;
 
+  /**
+   * Initialize the second engine used by `recognizeCascade(...)`.
+   * Typically loaded with the best models while `init(...)` loads fast ones.
+   * @param {TesseractCascadeInitOptions} options Cascade engine options.
+   * @throws {TesseractArgumentError} If `options` has invalid field types.
+   * @throws {TesseractRangeError} If `oem` is outside valid engine mode range.
+   * @throws {TesseractRuntimeError} If native initialization fails.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  initCascade(options: TesseractCascadeInitOptions): Promise<void>;
+
   /**
    * Initialize the engine for page analysis only.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
@@ -1160,19 +1960,32 @@ export interface TesseractInstance {
   initForAnalysePage(): Promise<void>;
 
   /**
-   * Run page layout analysis.
+   * Run page layout analysis without recognizing any text.
    * @param {boolean} mergeSimilarWords Whether to merge similar words during analysis.
    * @throws {TesseractArgumentError} If `mergeSimilarWords` is not a boolean.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
-   * @throws {TesseractRuntimeError} If analysis fails or returns null.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   * @returns Blocks, paragraphs, text lines and words; no blocks for an empty page.
+   */
+  analyseLayout(mergeSimilarWords?: boolean): Promise<TesseractLayout>;
+
+  /**
+   * Crop the components of one layout level out of the current image in a
+   * single call. Layout analysis runs first if the page was not recognized.
+   * @throws {TesseractArgumentError} If options are invalid.
+   * @throws {TesseractRuntimeError} If called before `init(...)` or without an image.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   * @returns One crop per component; empty for an empty page.
    */
-  analyseLayout(mergeSimilarWords: boolean): Promise<void>; // TODO: return pageiterator here
+  getComponentImages(
+    options?: TesseractComponentImagesOptions,
+  ): Promise<TesseractComponentImage[]>;
 
   /**
    * Starts a multipage processing session.
    * @deprecated use `document.begin()`
    * @throws {TesseractArgumentError} If options are missing/invalid.
+   * @throws {TesseractRangeError} If `options.pageImage` values are out of range or do not apply to its mode.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
    * @throws {TesseractRuntimeError} If session already exists or renderer setup fails.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
@@ -1189,10 +2002,29 @@ export interface TesseractInstance {
    * @throws {TesseractArgumentError} If `options.progressCallback` is provided but is not a function.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
    * @throws {TesseractRuntimeError} If no session is active, decode fails, or page processing fails.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractMemoryBudgetError} If the page exceeds the memory budget.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
   addProcessPage(options: TesseractAddProcessPageOptions): Promise<void>;
 
+  /**
+   * Adds one page read from a file on the worker thread.
+   * @deprecated use `document.addPageFromFile()`
+   * @param {string} path Path of the encoded image.
+   * @param {TesseractAddProcessPageFromFileOptions} options Page options.
+   * @throws {TesseractArgumentError} If `path` is not a non-empty string.
+   * @throws {TesseractArgumentError} If `options` is invalid.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If no session is active, the file cannot be read, decode fails, or page processing fails.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  addProcessPageFromFile(
+    path: string,
+    options?: TesseractAddProcessPageFromFileOptions,
+  ): Promise<void>;
+
   /**
    * Finalizes the current multipage session and returns the output PDF path.
    * @deprecated use `document.finish()`
@@ -1211,6 +2043,7 @@ export interface TesseractInstance {
 
   /**
    * Returns the current multipage processing status.
+   * Answered immediately, without waiting for queued or running jobs.
    * @deprecated use `document.status()`
    * @throws {TesseractArgumentError} If called with unexpected arguments.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
@@ -1293,10 +2126,24 @@ export interface TesseractInstance {
    * @throws {TesseractArgumentError} If `buffer` is not a non-empty Buffer.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
    * @throws {TesseractRuntimeError} If decoding fails or decoded data is invalid.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractMemoryBudgetError} If the image exceeds the memory budget.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
   setImage(buffer: Buffer<ArrayBuffer>): Promise<void>;
 
+  /**
+   * Set the image to be recognized from a file. The file is read and
+   * decoded on the worker thread, so it never enters the JS heap.
+   * @param {string} path Path of the encoded image.
+   * @throws {TesseractArgumentError} If `path` is not a non-empty string.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If the file cannot be read or decoded.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  setImageFromFile(path: string): Promise<void>;
+
   /**
    * Set the page segmentation mode (PSM).
    * @param {PageSegmentationMode} psm Page segmentation mode.
@@ -1327,16 +2174,145 @@ export interface TesseractInstance {
 
   /**
    * Runs OCR recognition.
+   * With `autoRotate`, orientation is detected on a downscaled copy first and
+   * the page is rotated upright on the worker before recognition.
    * @param {(info: ProgressChangedInfo) => void} progressCallback Optional progress callback.
+   * @param {TesseractRecognizeOptions} options Optional recognition options.
+   * @returns The detected orientation and script when `autoRotate` is set.
    * @throws {TesseractArgumentError} If `progressCallback` is provided but not a function.
+   * @throws {TesseractArgumentError} If `options` has invalid field types.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If `autoRotate` is set before `setImage(...)`.
+   * @throws {TesseractRuntimeError} If a variable in `vars` does not exist or can only be set by `init(...)`.
    * @throws {TesseractRuntimeError} If native recognition fails.
    * @throws {TesseractWorkerError} If the worker is closing/stopped.
    */
+  recognize(
+    progressCallback: ((info: ProgressChangedInfo) => void) | undefined,
+    options: TesseractRecognizeOptions & { autoRotate: true },
+  ): Promise<DetectOrientationScriptResult>;
   recognize(
     progressCallback?: (info: ProgressChangedInfo) => void,
+    options?: TesseractRecognizeOptions,
   ): Promise<void>;
 
+  /**
+   * Reads, decodes, recognizes and renders one file in a single job. The
+   * file is read and decoded on a prefetch thread while the worker is still
+   * busy with earlier jobs, at most `readahead` pages ahead of the one
+   * being recognized.
+   * Replaces the image set via `setImage(...)`.
+   * @param {string} path Path of the encoded image.
+   * @param {TesseractRecognizeFileOptions} options Outputs and variables.
+   * @throws {TesseractArgumentError} If `path` or `options` are invalid.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If a variable in `vars` does not exist or can only be set by `init(...)`.
+   * @throws {TesseractRuntimeError} If the file cannot be read, decoded or recognized.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  recognizeFile(
+    path: string,
+    options?: TesseractRecognizeFileOptions,
+  ): Promise<TesseractRecognizedFile>;
+
+  /**
+   * Validates job options once into a handle that `recognizeWithProfile(...)`
+   * jobs pass instead of the options. Profiles may be shared between
+   * instances. `vars` are checked on the engine like `setVariable(...)`.
+   * @param {TesseractProfileOptions} options Options of the profile's jobs.
+   * @throws {TesseractArgumentError} If `options` are invalid.
+   * @throws {TesseractRuntimeError} If `vars` are given before `init(...)`.
+   * @throws {TesseractRuntimeError} If a variable does not exist or can only be set by `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  createProfile(options: TesseractProfileOptions): Promise<TesseractProfile>;
+
+  /**
+   * Recognizes one encoded image with the options of `profile` in a single
+   * job. Consecutive jobs of the same profile set its variables only once.
+   * Replaces the image set via `setImage(...)`. `path` of the result is
+   * empty.
+   * @param {Buffer} image Encoded image.
+   * @param {TesseractProfile} profile Handle from `createProfile(...)`.
+   * @throws {TesseractArgumentError} If `image` or `profile` are invalid.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If a variable does not exist, or the image cannot be decoded or recognized.
+   * @throws {TesseractImageLimitError} If the image exceeds `imageLimits` from `init(...)`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  recognizeWithProfile(
+    image: Buffer,
+    profile: TesseractProfile,
+  ): Promise<TesseractRecognizedFile>;
+
+  /**
+   * Recognizes a list of files with `readahead` files read and decoded
+   * ahead of the worker. Per-file failures are yielded with `error` set
+   * instead of ending the iteration.
+   * @param {TesseractProcessFilesInput} input Paths or `{ manifest }`.
+   * @param {TesseractProcessFilesOptions} options Outputs, readahead and order.
+   * @throws {RangeError} If `readahead` is not an integer from 0 to 64.
+   */
+  processFiles(
+    input: TesseractProcessFilesInput,
+    options?: TesseractProcessFilesOptions,
+  ): AsyncGenerator<TesseractProcessedFile>;
+
+  /**
+   * Recognizes several rectangles of the current image in one worker call.
+   * The image set via `setImage(...)` is decoded once and reused for every
+   * region. Page mode and rectangle are restored afterwards.
+   * @param {TesseractRegion[]} regions Rectangles to recognize.
+   * @param {TesseractRecognizeRegionsOptions} options Optional defaults.
+   * @throws {TesseractArgumentError} If regions/options are invalid.
+   * @throws {TesseractRangeError} If a `psm` is outside valid mode range.
+   * @throws {TesseractRuntimeError} If called before `init(...)` or `setImage(...)`.
+   * @throws {TesseractRuntimeError} If recognition of a region fails.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  recognizeRegions(
+    regions: TesseractRegion[],
+    options?: TesseractRecognizeRegionsOptions,
+  ): Promise<TesseractRegionResult[]>;
+
+  /**
+   * Recognizes the next frame of a video or screen capture stream. The frame
+   * is compared with the previous one tile by tile, and only the areas around
+   * changed tiles are recognized; the text of unchanged lines is kept. The
+   * frame becomes the current image, like `setImage(...)`.
+   * @param {TesseractFrame} frame Raw pixels of the frame.
+   * @param {TesseractRecognizeFrameOptions} options Tile size and reset.
+   * @throws {TesseractArgumentError} If frame/options have the wrong types.
+   * @throws {TesseractRangeError} If the frame geometry does not fit `data`
+   * or `tileSize` is out of range.
+   * @throws {TesseractRuntimeError} If called before `init(...)`.
+   * @throws {TesseractRuntimeError} If recognition fails; the next frame is
+   * then recognized in full.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  recognizeFrame(
+    frame: TesseractFrame,
+    options?: TesseractRecognizeFrameOptions,
+  ): Promise<TesseractFrameResult>;
+
+  /**
+   * Recognizes the current image with the primary engine and re-recognizes
+   * only the words/lines below `minConfidence` with the cascade engine.
+   * The more confident of both readings is kept for every item.
+   * @param {TesseractRecognizeCascadeOptions} options Optional threshold/level.
+   * @param {(info: ProgressChangedInfo) => void} progressCallback Optional progress callback for the primary pass.
+   * @throws {TesseractArgumentError} If options/callback types are invalid.
+   * @throws {TesseractRangeError} If `minConfidence` is outside 0..100.
+   * @throws {TesseractRuntimeError} If called before `init(...)`, `initCascade(...)` or `setImage(...)`.
+   * @throws {TesseractRuntimeError} If native recognition fails.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  recognizeCascade(
+    options?: TesseractRecognizeCascadeOptions,
+    progressCallback?: (info: ProgressChangedInfo) => void,
+  ): Promise<TesseractCascadeResult>;
+
   /**
    * Detect orientation and script (OSD).
    * @throws {TesseractRuntimeError} If called before `init(...)`.
@@ -1488,6 +2464,36 @@ export interface TesseractInstance {
    */
   getAvailableLanguages(): Promise<Language[]>;
 
+  /**
+   * Returns the effective threading configuration of the worker thread.
+   * @throws {TesseractArgumentError} If called with unexpected arguments.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  getThreadingConfig(): Promise<TesseractThreadingConfig>;
+
+  /**
+   * Returns the native memory currently accounted to this instance.
+   * The same numbers are reported to V8 as external memory.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  getMemoryUsage(): Promise<TesseractMemoryUsage>;
+
+  /**
+   * Returns a snapshot of the worker: queue depth, the running job and its
+   * progress, the multipage session and the initialized flag.
+   * Answered immediately, without waiting for queued or running jobs.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  getStatus(): Promise<TesseractWorkerStatus>;
+
+  /**
+   * Resolves once the submission queue has room for another job. Waiters
+   * are resolved in call order, one per free slot, so awaiting this before
+   * each submission keeps a fast producer from getting `ERR_QUEUE_FULL`.
+   * @throws {TesseractWorkerError} If the worker is closing/stopped.
+   */
+  waitForCapacity(): Promise<void>;
+
   /**
    * Clear internal recognition results/state.
    * @throws {TesseractRuntimeError} If called before `init(...)`.
@@ -1502,5 +2508,132 @@ export interface TesseractInstance {
   end(): Promise<void>;
 }
 
+export interface TesseractClientOptions {
+  /**
+   * Unix domain socket `tesseract-ocrd` listens on (`--socket`)
+   */
+  socketPath: string;
+  /**
+   * Milliseconds a request may take from submission to reply, including
+   * the wait for a connection; `0` waits forever. Default `60000`.
+   */
+  timeout?: number;
+}
+
+export interface TesseractClientRecognizeOptions
+  extends TesseractRecognizeFileOptions {
+  /**
+   * Page segmentation mode for this request, defaults to the daemon's
+   * `--psm`
+   */
+  psm?: PageSegmentationMode;
+}
+
+export interface TesseractDaemonInfo {
+  /**
+   * libtesseract version of the daemon
+   */
+  version: string;
+  langs: string;
+  engines: number;
+}
+
+/**
+ * Client of a `tesseract-ocrd` daemon. It holds no engine of its own and
+ * needs no `init(...)`: the daemon's engines are initialized at startup.
+ */
+export interface TesseractClientInstance {
+  /**
+   * Returns the daemon's version, languages and engine count.
+   * @throws {TesseractDaemonError} If the daemon is not reachable or does
+   * not reply within `timeout`.
+   */
+  info(): Promise<TesseractDaemonInfo>;
+
+  /**
+   * Recognizes one encoded image on one of the daemon's warm engines. The
+   * image is handed over in shared memory. `path` of the result is empty.
+   * @throws {TesseractArgumentError} If `buffer` or options are invalid.
+   * @throws {TesseractRangeError} If `options.psm` is out of range.
+   * @throws {TesseractImageLimitError} If the daemon refuses the image.
+   * @throws {TesseractRuntimeError} If decoding or recognition fails.
+   * @throws {TesseractDaemonError} If the daemon is not reachable or does
+   * not reply within `timeout`.
+   */
+  recognize(
+    buffer: Buffer,
+    options?: TesseractClientRecognizeOptions,
+  ): Promise<TesseractRecognizedFile>;
+
+  /**
+   * Recognizes an image file the daemon reads itself. Relative paths are
+   * resolved against the working directory of the calling process.
+   * @throws {TesseractArgumentError} If `path` or options are invalid.
+   * @throws {TesseractRangeError} If `options.psm` is out of range.
+   * @throws {TesseractImageLimitError} If the daemon refuses the image.
+   * @throws {TesseractRuntimeError} If the file cannot be read or recognized.
+   * @throws {TesseractDaemonError} If the daemon is not reachable or does
+   * not reply within `timeout`.
+   */
+  recognizeFile(
+    path: string,
+    options?: TesseractClientRecognizeOptions,
+  ): Promise<TesseractRecognizedFile>;
+}
+
+/**
+ * @throws {TesseractArgumentError} If `options.socketPath` is missing.
+ * @throws {TesseractRangeError} If `options.timeout` is out of range.
+ */
+export type TesseractClientConstructor = new (
+  options: TesseractClientOptions,
+) => TesseractClientInstance;
+
 export type NativeTesseract = TesseractInstance;
-export type TesseractConstructor = new () => TesseractInstance;
+export type TesseractConstructor = new (
+  options?: TesseractOptions,
+) => TesseractInstance;
+
+export interface NativeAddon {
+  Tesseract: TesseractConstructor;
+  TesseractClient: TesseractClientConstructor;
+
+  /**
+   * Configures the process-wide Leptonica raster pool.
+   * @throws {TesseractArgumentError} If options are invalid.
+   */
+  configurePixPool(options: PixPoolOptions): void;
+
+  /**
+   * Returns counters of the process-wide Leptonica raster pool.
+   */
+  getPixPoolStats(): PixPoolStats;
+
+  /**
+   * Checks the component table of a `.traineddata` file (the header
+   * TessdataManager reads) without loading the model.
+   * @throws {TesseractArgumentError} If `path` is not a string.
+   */
+  inspectTraineddata(path: string): TraineddataHeader;
+
+  /**
+   * Compressions `init` can read traineddata in; `"zstd"` only if the addon
+   * was built with libzstd.
+   */
+  readonly traineddataCompressions: readonly TraineddataCompression[];
+
+  /**
+   * Starts recording the process-wide trace timeline. Setting
+   * `NODE_TESSERACT_TRACE=1` does the same when the addon is loaded.
+   */
+  enableTracing(): void;
+
+  /**
+   * Writes the events recorded since the previous dump as Chrome trace-event
+   * JSON, for chrome://tracing or ui.perfetto.dev, and resolves with how many
+   * there were.
+   * @throws {TesseractArgumentError} If `path` is not a string.
+   * @throws {TesseractRuntimeError} If `path` cannot be written.
+   */
+  dumpTrace(path: string): Promise<number>;
+}
@@ -14,7 +14,20 @@
  * permissions and limitations under the License.
  */
 
-import { stat } from "node:fs/promises";
+import { createHash } from "node:crypto";
+import { constants as fsConstants, createReadStream } from "node:fs";
+import {
+  copyFile,
+  link,
+  readFile,
+  rename,
+  rm,
+  stat,
+  writeFile,
+} from "node:fs/promises";
+import path from "node:path";
+import { pipeline } from "node:stream/promises";
+import type { TraineddataHeader } from "./types";
 
 export const isValidTraineddata = async (filePath: string) => {
   try {
@@ -24,3 +37,159 @@ export const isValidTraineddata = async (filePath: string) => {
     return false;
   }
 };
+
+/**
+ * Places `source` at `target` without copying its bytes where possible: a
+ * hardlink on the same device, otherwise a reflink (copy-on-write clone) or,
+ * where the filesystem has none, a plain copy. `target` is replaced
+ * atomically, so concurrent readers never see a partial file. Returns false
+ * if `target` already was `source`.
+ */
+export const linkOrCopy = async (source: string, target: string) => {
+  const [sourceInfo, targetInfo] = await Promise.all([
+    stat(source),
+    stat(target).catch(() => undefined),
+  ]);
+  if (
+    targetInfo &&
+    targetInfo.dev === sourceInfo.dev &&
+    targetInfo.ino === sourceInfo.ino
+  ) {
+    return false;
+  }
+
+  const tmpPath = `${target}.${process.pid}.${Math.random().toString(36).slice(2)}.tmp`;
+  try {
+    try {
+      await link(source, tmpPath);
+    } catch {
+      // EXDEV across devices, EPERM/ENOTSUP where hardlinks are unavailable
+      await copyFile(source, tmpPath, fsConstants.COPYFILE_FICLONE);
+    }
+    await rename(tmpPath, target);
+  } catch (error) {
+    await rm(tmpPath, { force: true });
+    throw error;
+  }
+  return true;
+};
+
+/**
+ * Sidecar manifest kept next to validated traineddata, one per directory.
+ */
+export const INTEGRITY_MANIFEST = ".node-tesseract-integrity.json";
+
+type IntegrityEntry = { size: number; mtimeMs: number; sha256: string };
+type IntegrityManifest = {
+  version: 1;
+  files: Record<string, IntegrityEntry>;
+};
+
+// manifest updates of one process are serialized per file; across
+// processes the atomic rename makes the last writer win, which at worst
+// costs a re-validation on the next start
+const manifestUpdates = new Map<string, Promise<unknown>>();
+
+const readIntegrityManifest = async (
+  manifestPath: string,
+): Promise<IntegrityManifest> => {
+  try {
+    const manifest = JSON.parse(await readFile(manifestPath, "utf8"));
+    if (manifest?.version === 1 && typeof manifest.files === "object") {
+      return manifest;
+    }
+  } catch {
+    // missing or unreadable: start over
+  }
+  return { version: 1, files: {} };
+};
+
+const updateIntegrityManifest = (
+  manifestPath: string,
+  name: string,
+  entry: IntegrityEntry,
+) => {
+  const update = (manifestUpdates.get(manifestPath) ?? Promise.resolve())
+    .catch(() => {})
+    .then(async () => {
+      const manifest = await readIntegrityManifest(manifestPath);
+      manifest.files[name] = entry;
+      const tmpPath = `${manifestPath}.${process.pid}.tmp`;
+      await writeFile(tmpPath, JSON.stringify(manifest, null, 2));
+      await rename(tmpPath, manifestPath);
+    });
+  manifestUpdates.set(manifestPath, update);
+  return update;
+};
+
+const sha256File = async (filePath: string) => {
+  const hash = createHash("sha256");
+  await pipeline(createReadStream(filePath), hash);
+  return hash.digest("hex");
+};
+
+/**
+ * Strong check for traineddata. A file recorded in the directory's integrity
+ * manifest with the same size and mtime is trusted after a single `stat`.
+ * Anything else has its component table checked by `inspect` and its
+ * SHA-256 recorded. A file whose size still matches the manifest but whose
+ * hash does not was modified in place and stays rejected until it is
+ * provisioned again (see `recordTraineddata`).
+ */
+export const verifyTraineddata = async (
+  filePath: string,
+  inspect: (filePath: string) => TraineddataHeader,
+) => {
+  if (!(await isValidTraineddata(filePath))) {
+    return false;
+  }
+  const info = await stat(filePath);
+  const manifestPath = path.join(path.dirname(filePath), INTEGRITY_MANIFEST);
+  const name = path.basename(filePath);
+  const recorded = (await readIntegrityManifest(manifestPath)).files[name];
+  if (
+    recorded &&
+    recorded.size === info.size &&
+    recorded.mtimeMs === info.mtimeMs
+  ) {
+    return true;
+  }
+
+  if (!inspect(filePath).valid) {
+    return false;
+  }
+  const sha256 = await sha256File(filePath);
+  if (recorded && recorded.size === info.size && recorded.sha256 !== sha256) {
+    return false;
+  }
+  await recordEntry(manifestPath, name, info, sha256);
+  return true;
+};
+
+/**
+ * Records a file that was just provisioned (downloaded, linked or copied)
+ * in its directory's integrity manifest, replacing any previous entry.
+ */
+export const recordTraineddata = async (filePath: string) => {
+  const info = await stat(filePath);
+  await recordEntry(
+    path.join(path.dirname(filePath), INTEGRITY_MANIFEST),
+    path.basename(filePath),
+    info,
+    await sha256File(filePath),
+  );
+};
+
+// Write failures (read-only data directories) are ignored; such files are
+// validated again on the next start.
+const recordEntry = (
+  manifestPath: string,
+  name: string,
+  info: { size: number; mtimeMs: number },
+  sha256: string,
+) =>
+  updateIntegrityManifest(manifestPath, name, {
+    size: info.size,
+    mtimeMs: info.mtimeMs,
+    sha256,
+  }).catch(() => {});
@@ -1,8 +1,193 @@
-
+#include "daemon_client.hpp"
+#include "pix_pool.hpp"
+#include "results.hpp"
 #include "tesseract_wrapper.hpp"
+#include "tracer.hpp"
+#include "traineddata.hpp"
+#include <cstdlib>
+#include <exception>
 #include <napi.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct ResultPixPoolStats : PixPoolStats {
+  static constexpr auto Fields() {
+    using S = PixPoolStats;
+    return std::tuple{
+        Field{"installed", &S::installed},
+        Field{"enabled", &S::enabled},
+        Field{"allocations", &S::allocations},
+        Field{"hits", &S::hits},
+        Field{"misses", &S::misses},
+        Field{"retainedBytes", &S::retained_bytes},
+        Field{"maxRetainedBytes", &S::max_retained_bytes},
+    };
+  }
+};
+
+struct ResultTraineddataHeader : TraineddataHeader {
+  static constexpr auto Fields() {
+    using S = TraineddataHeader;
+    return std::tuple{
+        Field{"valid", &S::valid},
+        Field{"components", &S::components},
+        Field{"reason", &S::reason},
+    };
+  }
+};
+
+void ThrowTypeError(Napi::Env env, const char *message,
+                    const char *method = "configurePixPool") {
+  Napi::Error error = Napi::TypeError::New(env, message);
+  error.Set("code", Napi::String::New(env, "ERR_INVALID_ARGUMENT"));
+  error.Set("method", Napi::String::New(env, method));
+  error.ThrowAsJavaScriptException();
+}
+
+Napi::Value JsConfigurePixPool(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsObject()) {
+    ThrowTypeError(env, "configurePixPool(options): options must be an object");
+    return env.Undefined();
+  }
+
+  auto options = info[0].As<Napi::Object>();
+  PixPoolStats current = GetPixPoolStats();
+  bool enabled = current.enabled;
+  uint64_t max_retained_bytes = current.max_retained_bytes;
+
+  const Napi::Value enabled_option = options.Get("enabled");
+  if (!enabled_option.IsUndefined()) {
+    if (!enabled_option.IsBoolean()) {
+      ThrowTypeError(
+          env, "configurePixPool(options): options.enabled must be a boolean");
+      return env.Undefined();
+    }
+    enabled = enabled_option.As<Napi::Boolean>().Value();
+  }
+
+  const Napi::Value max_option = options.Get("maxRetainedBytes");
+  if (!max_option.IsUndefined()) {
+    if (!max_option.IsNumber() ||
+        max_option.As<Napi::Number>().DoubleValue() < 0) {
+      ThrowTypeError(env, "configurePixPool(options): "
+                          "options.maxRetainedBytes must be a non-negative number");
+      return env.Undefined();
+    }
+    max_retained_bytes =
+        static_cast<uint64_t>(max_option.As<Napi::Number>().Int64Value());
+  }
+
+  ConfigurePixPool(enabled, max_retained_bytes);
+  return env.Undefined();
+}
+
+Napi::Value JsGetPixPoolStats(const Napi::CallbackInfo &info) {
+  return ToNapiValue(info.Env(), ResultPixPoolStats{GetPixPoolStats()});
+}
+
+// Synchronous: it reads only the component table, at most 8 KiB, and
+// inflates no more than that of a .gz or .zst model.
+Napi::Value JsInspectTraineddata(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsString()) {
+    ThrowTypeError(env, "inspectTraineddata(path): path must be a string",
+                   "inspectTraineddata");
+    return env.Undefined();
+  }
+
+  const std::string path = info[0].As<Napi::String>().Utf8Value();
+  return ToNapiValue(env, ResultTraineddataHeader{InspectTraineddata(path)});
+}
+
+Napi::Value TraineddataCompressions(Napi::Env env) {
+  const std::vector<std::string> supported =
+      SupportedTraineddataCompressions();
+  Napi::Array array = Napi::Array::New(env, supported.size());
+  for (size_t i = 0; i < supported.size(); ++i) {
+    array.Set(static_cast<uint32_t>(i), Napi::String::New(env, supported[i]));
+  }
+  return array;
+}
+
+Napi::Value JsEnableTracing(const Napi::CallbackInfo &info) {
+  EnableTracing();
+  return info.Env().Undefined();
+}
+
+// Serializing a full trace takes a while, so it runs on the libuv pool.
+class TraceDump : public Napi::AsyncWorker {
+public:
+  TraceDump(Napi::Env env, std::string path)
+      : Napi::AsyncWorker(env, "tesseract_dump_trace"),
+        _deferred(Napi::Promise::Deferred::New(env)), _path(std::move(path)) {}
+
+  Napi::Promise Promise() const { return _deferred.Promise(); }
+
+  void Execute() override {
+    try {
+      _events = DumpTrace(_path);
+    } catch (const std::exception &e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override {
+    _deferred.Resolve(
+        Napi::Number::New(Env(), static_cast<double>(_events)));
+  }
+
+  void OnError(const Napi::Error &error) override {
+    Napi::Env env = Env();
+    Napi::Error rejection = error;
+    rejection.Set("code", Napi::String::New(env, "ERR_TESSERACT_RUNTIME"));
+    rejection.Set("method", Napi::String::New(env, "dumpTrace"));
+    _deferred.Reject(rejection.Value());
+  }
+
+private:
+  Napi::Promise::Deferred _deferred;
+  std::string _path;
+  size_t _events{0};
+};
+
+Napi::Value JsDumpTrace(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() != 1 || !info[0].IsString()) {
+    ThrowTypeError(env, "dumpTrace(path): path must be a string",
+                   "dumpTrace");
+    return env.Undefined();
+  }
+
+  auto *dump = new TraceDump(env, info[0].As<Napi::String>().Utf8Value());
+  Napi::Promise promise = dump->Promise();
+  dump->Queue();
+  return promise;
+}
+
+} // namespace
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  // Leptonica's allocator is process-wide and must be swapped before the
+  // first Pix exists, i.e. when the addon is loaded.
+  InstallPixPool();
+
+  const char *trace = std::getenv("NODE_TESSERACT_TRACE");
+  if (trace != nullptr && std::string{trace} == "1") {
+    EnableTracing();
+  }
+
+  exports.Set("configurePixPool", Napi::Function::New(env, JsConfigurePixPool));
+  exports.Set("getPixPoolStats", Napi::Function::New(env, JsGetPixPoolStats));
+  exports.Set("inspectTraineddata",
+              Napi::Function::New(env, JsInspectTraineddata));
+  exports.Set("traineddataCompressions", TraineddataCompressions(env));
+  exports.Set("enableTracing", Napi::Function::New(env, JsEnableTracing));
+  exports.Set("dumpTrace", Napi::Function::New(env, JsDumpTrace));
+  DaemonClient::InitAddon(env, exports);
   return TesseractWrapper::InitAddon(env, exports);
 }
 
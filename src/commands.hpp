@@ -16,13 +16,27 @@
 
 #pragma once
 
+#include "frame_stream.hpp"
+#include "image_decode.hpp"
+#include "mapped_file.hpp"
+#include "memory.hpp"
 #include "monitor.hpp"
+#include "pdf_image.hpp"
+#include "profile.hpp"
+#include "results.hpp"
+#include "threading.hpp"
+#include "tracer.hpp"
+#include "traineddata.hpp"
 #include "utils.hpp"
+#include "variable_overlay.hpp"
+#include <algorithm>
 #include <allheaders.h>
 #include <atomic>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <napi.h>
@@ -33,133 +47,11 @@
 #include <tesseract/ocrclass.h>
 #include <tesseract/publictypes.h>
 #include <tesseract/renderer.h>
-#include <unordered_map>
+#include <tesseract/resultiterator.h>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
-struct ResultVoid {};
-
-struct ResultBool {
-  bool value;
-};
-
-struct ResultInt {
-  int value;
-};
-
-struct ResultDouble {
-  double value;
-};
-
-struct ResultFloat {
-  float value;
-};
-
-struct ResultString {
-  std::string value;
-};
-
-struct ResultBuffer {
-  std::vector<uint8_t> value;
-};
-
-using ObjectValue = std::variant<bool, int, double, float, std::string,
-                                 std::vector<std::string>, std::vector<uint8_t>,
-                                 std::vector<int>>;
-
-struct ResultObject {
-  std::unordered_map<std::string, ObjectValue> value;
-};
-
-using ArrayValue = std::variant<std::vector<int>, std::vector<std::string>>;
-
-struct ResultArray {
-  ArrayValue value;
-};
-
-using Result =
-    std::variant<ResultVoid, ResultBool, ResultInt, ResultDouble, ResultFloat,
-                 ResultString, ResultArray, ResultBuffer, ResultObject>;
-
-template <class... Ts> struct match : Ts... {
-  using Ts::operator()...;
-};
-
-template <class... Ts> match(Ts...) -> match<Ts...>;
-
-template <typename T>
-static Napi::Array VectorToNapiArray(Napi::Env env, const std::vector<T> &vec) {
-  Napi::Array arr = Napi::Array::New(env, vec.size());
-  for (size_t i = 0; i < vec.size(); ++i) {
-    arr.Set(static_cast<uint32_t>(i), vec[i]);
-  }
-  return arr;
-}
-
-static Napi::Value ToNapiValue(Napi::Env env, const ObjectValue &v) {
-  return std::visit(
-      match{
-          [&](bool b) -> Napi::Value { return Napi::Boolean::New(env, b); },
-          [&](int i) -> Napi::Value { return Napi::Number::New(env, i); },
-          [&](double d) -> Napi::Value { return Napi::Number::New(env, d); },
-          [&](float f) -> Napi::Value { return Napi::Number::New(env, f); },
-          [&](const std::string &s) -> Napi::Value { // String
-            return Napi::String::New(env, s);
-          },
-          [&](const std::vector<uint8_t> &vec) -> Napi::Value { // Buffer
-            return Napi::Buffer<uint8_t>::Copy(env, vec.data(), vec.size());
-          },
-          [&](const std::vector<int> &vec) -> Napi::Value {
-            return VectorToNapiArray(env, vec);
-          },
-          [&](const std::vector<std::string> &vec)
-              -> Napi::Value { // string array
-            return VectorToNapiArray(env, vec);
-          },
-      },
-      v);
-}
-
-inline Napi::Value MatchResult(Napi::Env env, const Result &r) {
-  return std::visit(
-      match{[&](const ResultVoid &) -> Napi::Value { return env.Undefined(); },
-            [&](const ResultBool &v) -> Napi::Value {
-              return Napi::Boolean::New(env, v.value);
-            },
-            [&](const ResultInt &v) -> Napi::Value {
-              return Napi::Number::New(env, v.value);
-            },
-            [&](const ResultDouble &v) -> Napi::Value {
-              return Napi::Number::New(env, v.value);
-            },
-            [&](const ResultFloat &v) -> Napi::Value {
-              return Napi::Number::New(env, v.value);
-            },
-            [&](const ResultString &v) -> Napi::Value {
-              return Napi::String::New(env, v.value);
-            },
-            [&](const ResultBuffer &v) -> Napi::Value {
-              return Napi::Buffer<uint8_t>::Copy(env, v.value.data(),
-                                                 v.value.size());
-            },
-            [&](const ResultArray &v) -> Napi::Value {
-              return std::visit(
-                  [&](const auto &vec) -> Napi::Value {
-                    return VectorToNapiArray(env, vec);
-                  },
-                  v.value);
-            },
-            [&](const ResultObject &v) -> Napi::Value {
-              Napi::Object obj = Napi::Object::New(env);
-
-              for (const auto &[k, val] : v.value) {
-                obj.Set(k, ToNapiValue(env, val));
-              }
-              return obj;
-            }},
-      r);
-}
-
 inline void RequireInitialized(const std::atomic<bool> &initialized,
                                const char *method) {
   if (!initialized.load(std::memory_order_acquire)) {
@@ -167,19 +59,19 @@ inline void RequireInitialized(const std::atomic<bool> &initialized,
   }
 }
 
+// TessBaseAPI::Recognize, recorded as a span when tracing is on.
+inline int TracedRecognize(tesseract::TessBaseAPI &api,
+                           tesseract::ETEXT_DESC *monitor) {
+  TraceSpan span{"tesseract", "recognize"};
+  return api.Recognize(monitor);
+}
+
 struct CommandVersion {
   Result invoke(tesseract::TessBaseAPI &api) const {
     return ResultString{api.Version()};
   }
 };
 
-struct CommandIsInitialized {
-  Result invoke(tesseract::TessBaseAPI &,
-                const std::atomic<bool> &initialized) const {
-    return ResultBool{initialized.load(std::memory_order_acquire)};
-  }
-};
-
 struct CommandSetInputName {
   std::string input_name;
   Result invoke(tesseract::TessBaseAPI &api) const {
@@ -196,6 +88,8 @@ struct CommandGetInputName {
 
 struct CommandSetInputImage {
   std::vector<uint8_t> bytes;
+  ImageLimits limits;
+  size_t payload_bytes() const { return bytes.size(); }
   Result invoke(tesseract::TessBaseAPI &api,
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "setInputImage");
@@ -203,7 +97,8 @@ struct CommandSetInputImage {
       throw_runtime("setInputImage: input buffer is empty");
     }
 
-    Pix *pix = pixReadMem(bytes.data(), bytes.size());
+    Pix *pix =
+        DecodeImage(bytes.data(), bytes.size(), limits, "setInputImage");
     if (pix == nullptr) {
       throw_runtime("setInputImage: failed to decode image buffer");
     }
@@ -341,9 +236,28 @@ struct CommandInit {
   std::vector<std::string> vars_vec;
   std::vector<std::string> vars_values;
   bool set_only_non_debug_params{false};
+  int intra_op_threads{0}; // 0 = keep the process default
+  std::vector<int> cpu_affinity;
+
+  // Applied by the worker once Init succeeds, so a rejected init leaves the
+  // instance's budget and limits alone and later jobs see them in order.
+  std::optional<int64_t> memory_budget;
+  std::optional<ImageLimits> image_limits;
 
   Result invoke(tesseract::TessBaseAPI &api,
                 std::atomic<bool> &initialized) const {
+    // Runs on the worker thread, so both settings stay local to this engine.
+    if (intra_op_threads > 0) {
+      SetIntraOpThreads(intra_op_threads);
+    }
+    if (!cpu_affinity.empty()) {
+      try {
+        PinCurrentThread(cpu_affinity);
+      } catch (const std::exception &error) {
+        throw_runtime("init: could not apply cpuAffinity: {}", error.what());
+      }
+    }
+
     const std::vector<std::string> *vv = vars_vec.empty() ? nullptr : &vars_vec;
     const std::vector<std::string> *vval =
         vars_values.empty() ? nullptr : &vars_values;
@@ -355,12 +269,15 @@ struct CommandInit {
           "the same length");
     }
 
-    if (api.Init(data_path.empty() ? nullptr : data_path.c_str(),
+    // data_size 0: the first argument is the datapath, and every model is
+    // loaded through ReadTraineddata, so compressed ones are decompressed
+    // straight into memory.
+    if (api.Init(data_path.empty() ? nullptr : data_path.c_str(), 0,
                  language.empty() ? nullptr : language.c_str(), oem,
                  configs.empty() ? nullptr
                                  : const_cast<char **>(configs.data()),
                  static_cast<int>(configs.size()), vv, vval,
-                 set_only_non_debug_params) != 0) {
+                 set_only_non_debug_params, ReadTraineddata) != 0) {
       throw_runtime("init: TessBaseAPI::Init returned non-zero status");
     }
 
@@ -369,6 +286,18 @@ struct CommandInit {
   }
 };
 
+struct CommandGetThreadingConfig {
+  Result invoke(tesseract::TessBaseAPI &) const {
+    return ResultThreadingConfig{
+        .openmp = HasOpenMP(),
+        .intra_op_threads = GetIntraOpThreads(),
+        .hardware_concurrency =
+            static_cast<int>(std::thread::hardware_concurrency()),
+        .cpu_affinity = GetCurrentThreadAffinity(),
+    };
+  }
+};
+
 struct CommandInitForAnalysePage {
   Result invoke(tesseract::TessBaseAPI &api,
                 const std::atomic<bool> &initialized) const {
@@ -378,22 +307,216 @@ struct CommandInitForAnalysePage {
   }
 };
 
+inline std::string BlockTypeName(tesseract::PolyBlockType type) {
+  switch (type) {
+  case tesseract::PT_FLOWING_TEXT:
+    return "flowingText";
+  case tesseract::PT_HEADING_TEXT:
+    return "headingText";
+  case tesseract::PT_PULLOUT_TEXT:
+    return "pulloutText";
+  case tesseract::PT_EQUATION:
+    return "equation";
+  case tesseract::PT_INLINE_EQUATION:
+    return "inlineEquation";
+  case tesseract::PT_TABLE:
+    return "table";
+  case tesseract::PT_VERTICAL_TEXT:
+    return "verticalText";
+  case tesseract::PT_CAPTION_TEXT:
+    return "captionText";
+  case tesseract::PT_FLOWING_IMAGE:
+    return "flowingImage";
+  case tesseract::PT_HEADING_IMAGE:
+    return "headingImage";
+  case tesseract::PT_PULLOUT_IMAGE:
+    return "pulloutImage";
+  case tesseract::PT_HORZ_LINE:
+    return "horizontalLine";
+  case tesseract::PT_VERT_LINE:
+    return "verticalLine";
+  case tesseract::PT_NOISE:
+    return "noise";
+  default:
+    return "unknown";
+  }
+}
+
+inline std::string OrientationName(tesseract::Orientation orientation) {
+  switch (orientation) {
+  case tesseract::ORIENTATION_PAGE_RIGHT:
+    return "pageRight";
+  case tesseract::ORIENTATION_PAGE_DOWN:
+    return "pageDown";
+  case tesseract::ORIENTATION_PAGE_LEFT:
+    return "pageLeft";
+  default:
+    return "pageUp";
+  }
+}
+
+inline std::string WritingDirectionName(tesseract::WritingDirection direction) {
+  switch (direction) {
+  case tesseract::WRITING_DIRECTION_RIGHT_TO_LEFT:
+    return "rightToLeft";
+  case tesseract::WRITING_DIRECTION_TOP_TO_BOTTOM:
+    return "topToBottom";
+  default:
+    return "leftToRight";
+  }
+}
+
+inline std::string TextlineOrderName(tesseract::TextlineOrder order) {
+  switch (order) {
+  case tesseract::TEXTLINE_ORDER_RIGHT_TO_LEFT:
+    return "rightToLeft";
+  case tesseract::TEXTLINE_ORDER_TOP_TO_BOTTOM:
+    return "topToBottom";
+  default:
+    return "leftToRight";
+  }
+}
+
+// Copies the bounding box of the element at `level` into a layout result.
+template <typename R>
+void SetLayoutBox(const tesseract::PageIterator &iter,
+                  tesseract::PageIteratorLevel level, R &out) {
+  int left = 0, top = 0, right = 0, bottom = 0;
+  if (iter.BoundingBox(level, &left, &top, &right, &bottom)) {
+    out.left = left;
+    out.top = top;
+    out.width = right - left;
+    out.height = bottom - top;
+  }
+}
+
+// Page segmentation only: blocks, paragraphs, text lines and words with
+// their geometry. The recognizer never runs, so this is cheap enough to
+// feed custom segmentation pipelines.
 struct CommandAnalyseLayout {
   bool merge_similar_words = false;
   Result invoke(tesseract::TessBaseAPI &api,
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "analyseLayout");
 
-    tesseract::PageIterator *p_iter = api.AnalyseLayout(merge_similar_words);
+    std::unique_ptr<tesseract::PageIterator> iter{
+        api.AnalyseLayout(merge_similar_words)};
+
+    ResultLayout layout{};
 
     // returns nullptr on error or empty page
-    if (p_iter == nullptr) {
-      throw_runtime("analyseLayout: TessBaseAPI::AnalyseLayout returned null");
+    if (iter == nullptr) {
+      return layout;
     }
 
-    // Convert PageIterator to a feasible object here
-    // For now return void for this complex return value
-    return ResultVoid{};
+    iter->Begin();
+    do {
+      if (iter->IsAtBeginningOf(tesseract::RIL_BLOCK)) {
+        ResultLayoutBlock &block = layout.blocks.emplace_back();
+        SetLayoutBox(*iter, tesseract::RIL_BLOCK, block);
+        block.block_type = BlockTypeName(iter->BlockType());
+
+        tesseract::Orientation orientation{};
+        tesseract::WritingDirection direction{};
+        tesseract::TextlineOrder order{};
+        iter->Orientation(&orientation, &direction, &order,
+                          &block.deskew_angle);
+        block.orientation = OrientationName(orientation);
+        block.writing_direction = WritingDirectionName(direction);
+        block.textline_order = TextlineOrderName(order);
+      }
+
+      // image and separator blocks have no text structure below them
+      if (iter->Empty(tesseract::RIL_WORD)) {
+        continue;
+      }
+
+      ResultLayoutBlock &block = layout.blocks.back();
+      if (iter->IsAtBeginningOf(tesseract::RIL_PARA) ||
+          block.paragraphs.empty()) {
+        SetLayoutBox(*iter, tesseract::RIL_PARA,
+                     block.paragraphs.emplace_back());
+      }
+
+      ResultLayoutParagraph &paragraph = block.paragraphs.back();
+      if (iter->IsAtBeginningOf(tesseract::RIL_TEXTLINE) ||
+          paragraph.lines.empty()) {
+        ResultLayoutLine &line = paragraph.lines.emplace_back();
+        SetLayoutBox(*iter, tesseract::RIL_TEXTLINE, line);
+
+        ResultLayoutBaseline &baseline = line.baseline;
+        iter->Baseline(tesseract::RIL_TEXTLINE, &baseline.x1, &baseline.y1,
+                       &baseline.x2, &baseline.y2);
+      }
+
+      SetLayoutBox(*iter, tesseract::RIL_WORD,
+                   paragraph.lines.back().words.emplace_back());
+    } while (iter->Next(tesseract::RIL_WORD));
+
+    return layout;
+  }
+};
+
+// Crops of all components at one level of the page layout, fetched in a
+// single call. Binarized crops come from the thresholded image, raw ones from
+// the input image; their pixel data is handed to JS without another copy.
+struct CommandGetComponentImages {
+  tesseract::PageIteratorLevel level = tesseract::RIL_TEXTLINE;
+  bool text_only = true;
+  bool raw_image = false;
+  int raw_padding = 0;
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "getComponentImages");
+
+    if (api.GetInputImage() == nullptr) {
+      throw_runtime("getComponentImages: call setImage(...) first");
+    }
+
+    Pixa *pixa = nullptr;
+    int *block_ids = nullptr;
+    int *paragraph_ids = nullptr;
+    Boxa *boxa = api.GetComponentImages(level, text_only, raw_image,
+                                        raw_padding, &pixa, &block_ids,
+                                        &paragraph_ids);
+
+    ResultList<ResultComponentImage> components{};
+
+    // null on error or empty page
+    if (boxa != nullptr) {
+      const int count = boxaGetCount(boxa);
+      components.value.reserve(count);
+      for (int i = 0; i < count; ++i) {
+        ResultComponentImage &component = components.value.emplace_back();
+        boxaGetBoxGeometry(boxa, i, &component.left, &component.top,
+                           &component.width, &component.height);
+        component.block_index = block_ids ? block_ids[i] : -1;
+        component.paragraph_index = paragraph_ids ? paragraph_ids[i] : -1;
+
+        Pix *pix = pixa ? pixaGetPix(pixa, i, L_CLONE) : nullptr;
+        if (pix == nullptr) {
+          continue;
+        }
+
+        // Leptonica keeps pixels in native-endian 32-bit words; JS consumers
+        // expect rows in memory order (MSB-first for 1 bpp).
+        pixEndianByteSwap(pix);
+
+        ResultComponentImageData &image = component.image;
+        image.width = pixGetWidth(pix);
+        image.height = pixGetHeight(pix);
+        image.depth = pixGetDepth(pix);
+        image.bytes_per_line = pixGetWpl(pix) * 4;
+        image.data.pix = SharePix(pix);
+      }
+    }
+
+    boxaDestroy(&boxa);
+    pixaDestroy(&pixa);
+    delete[] block_ids;
+    delete[] paragraph_ids;
+
+    return components;
   }
 };
 
@@ -407,6 +530,8 @@ struct ProcessPagesSession {
   int timeout_millisec{0};
   bool textonly{false};
   int next_page_index{0};
+  PdfImagePolicy image_policy;
+  std::unique_ptr<PdfImageEncoder> image_encoder; // Jpeg policy only
 };
 
 struct CommandBeginProcessPages {
@@ -414,6 +539,7 @@ struct CommandBeginProcessPages {
   std::string title;
   int timeout_millisec{0}; // 0 = unlimited timeout
   bool textonly{false};
+  PdfImagePolicy image_policy;
   Result invoke(tesseract::TessBaseAPI &api,
                 std::optional<ProcessPagesSession> &session,
                 const std::atomic<bool> &initialized) const {
@@ -451,121 +577,141 @@ struct CommandBeginProcessPages {
     session->timeout_millisec = timeout_millisec;
     session->textonly = textonly;
     session->next_page_index = 0;
+    session->image_policy = image_policy;
+    if (!textonly && image_policy.mode == PdfImagePolicy::Mode::Jpeg) {
+      session->image_encoder = std::make_unique<PdfImageEncoder>(image_policy);
+    }
     return ResultVoid{};
   }
 };
 
-struct CommandAddProcessPage {
-  EncodedImageBuffer page;
-  std::string filename;
-  std::shared_ptr<MonitorContext> monitor_context;
-  Result invoke(tesseract::TessBaseAPI &api,
-                std::optional<ProcessPagesSession> &session,
-                const std::atomic<bool> &initialized) const {
-    RequireInitialized(initialized, "addProcessPage");
-    if (!session.has_value()) {
-      throw_runtime("addProcessPage: called without an active session");
-    }
-    if (!session->renderer->happy()) {
-      throw_runtime("addProcessPage: renderer is not healthy");
-    }
-    if (page.bytes.empty()) {
-      throw_runtime("addProcessPage: buffer is empty");
-    }
+// Decodes one encoded page and adds it to the active session.
+inline void ProcessSessionPage(
+    tesseract::TessBaseAPI &api, std::optional<ProcessPagesSession> &session,
+    const uint8_t *data, size_t size, const ImageLimits &limits,
+    const std::string &filename,
+    const std::shared_ptr<MonitorContext> &monitor_context,
+    const char *method) {
+  Pix *pix = DecodeImage(data, size, limits, method);
+  if (pix == nullptr) {
+    throw_runtime("{}: failed to decode image buffer", method);
+  }
+  const std::shared_ptr<Pix> page = SharePix(NormalizePageImage(pix, method));
 
-    Pix *pix = pixReadMem(page.bytes.data(), page.bytes.size());
-    if (pix == nullptr) {
-      throw_runtime("addProcessPage: failed to decode image buffer");
-    }
+  const char *effective_filename =
+      filename.empty() ? nullptr : filename.c_str();
+  api.SetInputName(effective_filename);
+  api.SetImage(page.get());
 
-    if (pixGetColormap(pix) != nullptr) {
-      Pix *no_cmap = pixRemoveColormap(pix, REMOVE_CMAP_BASED_ON_SRC);
-      if (no_cmap == nullptr) {
-        pixDestroy(&pix);
-        throw_runtime("addProcessPage: failed to remove image colormap");
-      }
-      if (no_cmap != pix) {
-        pixDestroy(&pix);
-        pix = no_cmap;
-      }
-    }
+  // SetImage copied the page, so the encoder reads it while Tesseract works
+  std::unique_ptr<PendingPdfImage> image_layer;
+  if (session->image_encoder) {
+    image_layer = session->image_encoder->Encode(page, method);
+  }
 
-    if (pixGetSpp(pix) == 4) {
-      Pix *no_alpha = pixRemoveAlpha(pix);
-      if (no_alpha == nullptr) {
-        pixDestroy(&pix);
-        throw_runtime("addProcessPage: failed to remove alpha channel");
-      }
-      if (no_alpha != pix) {
-        pixDestroy(&pix);
-        pix = no_alpha;
-      }
-    }
+  bool failed = false;
+  MonitorHandle handle{monitor_context};
+  auto *monitor = handle.Monitor();
 
-    const int depth = pixGetDepth(pix);
-    if (depth > 0 && depth < 8) {
-      Pix *normalized = pixConvertTo8(pix, false);
-      if (normalized == nullptr) {
-        pixDestroy(&pix);
-        throw_runtime(
-            "addProcessPage: failed to normalize low-bit-depth image");
-      }
-      if (normalized != pix) {
-        pixDestroy(&pix);
-        pix = normalized;
-      }
+  if (session->timeout_millisec > 0) {
+    tesseract::ETEXT_DESC timeout_only_monitor{};
+    if (monitor != nullptr) {
+      monitor->set_deadline_msecs(session->timeout_millisec);
+    } else {
+      timeout_only_monitor.cancel = nullptr;
+      timeout_only_monitor.cancel_this = nullptr;
+      timeout_only_monitor.set_deadline_msecs(session->timeout_millisec);
+      monitor = &timeout_only_monitor;
     }
-
-    const int x_res = pixGetXRes(pix);
-    const int y_res = pixGetYRes(pix);
-    if (x_res <= 0 || y_res <= 0) {
-      pixSetResolution(pix, 300, 300);
+    failed = TracedRecognize(api, monitor) < 0;
+  } else if (api.GetPageSegMode() == tesseract::PSM_OSD_ONLY ||
+             api.GetPageSegMode() == tesseract::PSM_AUTO_ONLY) {
+    tesseract::PageIterator *it = api.AnalyseLayout();
+    if (it == nullptr) {
+      failed = true;
+    } else {
+      delete it;
     }
+  } else {
+    failed = TracedRecognize(api, monitor) < 0;
+  }
 
-    const char *effective_filename =
-        filename.empty() ? nullptr : filename.c_str();
-    api.SetInputName(effective_filename);
-    api.SetImage(pix);
-
-    bool failed = false;
-    MonitorHandle handle{monitor_context};
-    auto *monitor = monitor_context ? &handle.monitor : nullptr;
-
-    if (session->timeout_millisec > 0) {
-      tesseract::ETEXT_DESC timeout_only_monitor{};
-      if (monitor != nullptr) {
-        monitor->set_deadline_msecs(session->timeout_millisec);
-      } else {
-        timeout_only_monitor.cancel = nullptr;
-        timeout_only_monitor.cancel_this = nullptr;
-        timeout_only_monitor.set_deadline_msecs(session->timeout_millisec);
-        monitor = &timeout_only_monitor;
+  if (session->renderer && !failed) {
+    // TessPDFRenderer embeds a JPEG input file as it is, and sizes the
+    // page from the input image, so neither replacement moves the text
+    if (image_layer) {
+      api.SetInputName(image_layer->Wait().c_str());
+    } else if (session->image_policy.mode == PdfImagePolicy::Mode::Bilevel &&
+               !session->textonly) {
+      Pix *binary = api.GetThresholdedImage();
+      if (binary == nullptr) {
+        throw_runtime("{}: no thresholded image for page {}", method,
+                      session->next_page_index);
       }
-      failed = api.Recognize(monitor) < 0;
-    } else if (api.GetPageSegMode() == tesseract::PSM_OSD_ONLY ||
-               api.GetPageSegMode() == tesseract::PSM_AUTO_ONLY) {
-      tesseract::PageIterator *it = api.AnalyseLayout();
-      if (it == nullptr) {
-        failed = true;
-      } else {
-        delete it;
-      }
-    } else {
-      failed = api.Recognize(monitor) < 0;
+      api.SetInputName(nullptr);
+      api.SetInputImage(binary); // takes ownership; 1 bpp is G4 encoded
     }
-
-    if (session->renderer && !failed) {
+    {
+      TraceSpan span{"pdf", "render"};
       failed = !session->renderer->AddImage(&api);
     }
-    pixDestroy(&pix);
+    api.SetInputName(effective_filename);
+  }
 
-    if (!failed) {
-      session->next_page_index++;
-      return ResultVoid{};
+  if (failed) {
+    throw_runtime("{}: ProcessPage failed at page {}", method,
+                  session->next_page_index);
+  }
+  session->next_page_index++;
+}
+
+inline void RequireHealthySession(
+    const std::optional<ProcessPagesSession> &session, const char *method) {
+  if (!session.has_value()) {
+    throw_runtime("{}: called without an active session", method);
+  }
+  if (!session->renderer->happy()) {
+    throw_runtime("{}: renderer is not healthy", method);
+  }
+}
+
+struct CommandAddProcessPage {
+  EncodedImageBuffer page;
+  std::string filename;
+  ImageLimits limits;
+  std::shared_ptr<MonitorContext> monitor_context;
+  size_t payload_bytes() const { return page.bytes.size(); }
+  Result invoke(tesseract::TessBaseAPI &api,
+                std::optional<ProcessPagesSession> &session,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "addProcessPage");
+    RequireHealthySession(session, "addProcessPage");
+    if (page.bytes.empty()) {
+      throw_runtime("addProcessPage: buffer is empty");
     }
 
-    throw_runtime("addProcessPage: ProcessPage failed at page {}",
-                  session->next_page_index);
+    ProcessSessionPage(api, session, page.bytes.data(), page.bytes.size(),
+                       limits, filename, monitor_context, "addProcessPage");
+    return ResultVoid{};
+  }
+};
+
+// Like CommandAddProcessPage, but the page is read on the worker thread.
+struct CommandAddProcessPageFromFile {
+  std::string path;
+  std::string filename; // defaults to `path`
+  ImageLimits limits;
+  std::shared_ptr<MonitorContext> monitor_context;
+  Result invoke(tesseract::TessBaseAPI &api,
+                std::optional<ProcessPagesSession> &session,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "addProcessPageFromFile");
+    RequireHealthySession(session, "addProcessPageFromFile");
+
+    const MappedFile file = MappedFile::Open(path, "addProcessPageFromFile");
+    ProcessSessionPage(api, session, file.data(), file.size(), limits,
+                       filename.empty() ? path : filename, monitor_context,
+                       "addProcessPageFromFile");
     return ResultVoid{};
   }
 };
@@ -600,32 +746,22 @@ struct CommandAbortProcessPages {
   }
 };
 
-struct CommandGetProcessPagesStatus {
-  Result invoke(tesseract::TessBaseAPI &,
-                std::optional<ProcessPagesSession> &session) const {
-    if (!session.has_value()) {
-      return ResultObject{{
-          {"active", false},
-          {"healthy", false},
-          {"processedPages", 0},
-          {"nextPageIndex", 0},
-          {"outputBase", std::string{}},
-          {"timeoutMillisec", 0},
-          {"textonly", false},
-      }};
-    }
-
-    return ResultObject{{
-        {"active", true},
-        {"healthy", session->renderer->happy()},
-        {"processedPages", session->next_page_index},
-        {"nextPageIndex", session->next_page_index},
-        {"outputBase", session->output_base},
-        {"timeoutMillisec", session->timeout_millisec},
-        {"textonly", session->textonly},
-    }};
+inline ResultProcessPagesStatus
+SessionStatus(const std::optional<ProcessPagesSession> &session) {
+  if (!session.has_value()) {
+    return ResultProcessPagesStatus{};
   }
-};
+
+  return ResultProcessPagesStatus{
+      .active = true,
+      .healthy = session->renderer->happy(),
+      .processed_pages = session->next_page_index,
+      .next_page_index = session->next_page_index,
+      .output_base = session->output_base,
+      .timeout_millisec = session->timeout_millisec,
+      .textonly = session->textonly,
+  };
+}
 
 struct CommandSetDebugVariable {
   std::string name, value;
@@ -718,6 +854,7 @@ struct CommandSetImage {
   int height = 0;
   int bytes_per_pixel = 0; // bpp/8
   int bytes_per_line = 0;
+  size_t payload_bytes() const { return bytes.size(); }
   Result invoke(tesseract::TessBaseAPI &api,
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "setImage");
@@ -726,6 +863,186 @@ struct CommandSetImage {
   }
 };
 
+// Reads, decodes and normalizes the image on the worker thread, so neither
+// the encoded file nor the raster passes through the JS heap.
+struct CommandSetImageFromFile {
+  std::string path;
+  ImageLimits limits;
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "setImageFromFile");
+    Pix *pix = nullptr;
+    {
+      const MappedFile file = MappedFile::Open(path, "setImageFromFile");
+      pix = DecodeImage(file.data(), file.size(), limits, "setImageFromFile");
+    }
+    if (pix == nullptr) {
+      throw_runtime("setImageFromFile: failed to decode \"{}\"", path);
+    }
+
+    pix = NormalizePageImage(pix, "setImageFromFile");
+    api.SetImage(pix);
+    pixDestroy(&pix);
+    return ResultVoid{};
+  }
+};
+
+// Decoded page that the ImagePrefetcher delivers to a queued job. The ticket
+// keeps the page in the prefetch window until Release, or until the job is
+// dropped without running.
+struct PrefetchedImage {
+  std::shared_future<std::shared_ptr<Pix>> page;
+  std::shared_ptr<void> ticket;
+
+  // rethrows read, decode and image limit errors from the prefetch thread
+  const std::shared_ptr<Pix> &get() const { return page.get(); }
+  void Release() {
+    page = {};
+    ticket.reset();
+  }
+};
+
+// Takes the ownership of a char array returned by TessBaseAPI.
+inline std::string TakeText(char *text, const char *method,
+                            const char *getter) {
+  if (text == nullptr) {
+    throw_runtime("{}: TessBaseAPI::{} returned null", method, getter);
+  }
+  std::string result{text};
+  delete[] text;
+  return result;
+}
+
+// Fills the confidence and the requested outputs of `result` from the last
+// recognition.
+inline void RenderFileOutputs(tesseract::TessBaseAPI &api,
+                              ResultRecognizedFile &result, bool text,
+                              bool hocr, bool tsv, bool alto,
+                              const char *method) {
+  result.mean_confidence = api.MeanTextConf();
+  if (text) {
+    result.text = TakeText(api.GetUTF8Text(), method, "GetUTF8Text");
+  }
+  if (hocr) {
+    result.hocr = TakeText(api.GetHOCRText(0), method, "GetHOCRText");
+  }
+  if (tsv) {
+    result.tsv = TakeText(api.GetTSVText(0), method, "GetTSVText");
+  }
+  if (alto) {
+    result.alto = TakeText(api.GetAltoText(0), method, "GetAltoText");
+  }
+}
+
+// Recognizes one prefetched file and renders the requested outputs in the
+// same job, so a batch costs one round trip per file.
+struct CommandRecognizeFile {
+  std::string path;
+  PrefetchedImage image;
+  bool text{true};
+  bool hocr{false};
+  bool tsv{false};
+  bool alto{false};
+  VariableOverlay vars; // for this job only, see OverlayState
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "recognizeFile");
+    const std::shared_ptr<Pix> &pix = image.get();
+
+    api.SetImage(pix.get());
+    if (TracedRecognize(api, nullptr) < 0) {
+      throw_runtime("recognizeFile: recognition failed for \"{}\"", path);
+    }
+
+    ResultRecognizedFile result{};
+    result.path = path;
+    result.width = pixGetWidth(pix.get());
+    result.height = pixGetHeight(pix.get());
+    RenderFileOutputs(api, result, text, hocr, tsv, alto, "recognizeFile");
+    return result;
+  }
+};
+
+// Checks the variables of a new profile on the engine, so createProfile
+// rejects names setVariable would not accept instead of the profile's jobs.
+struct CommandCheckProfileVariables {
+  std::vector<std::string> names;
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "createProfile");
+    for (const std::string &name : names) {
+      CheckSettableVariable(api, name, "createProfile");
+    }
+    return ResultVoid{};
+  }
+};
+
+// Recognizes one encoded image with the options of a profile. The profile's
+// variables are the job's overlay (see CommandOverlay), so a run of jobs
+// with the same profile sets them once and other jobs get the engine's own
+// values back; page mode and rectangle are cheap and apply to the job only.
+struct CommandRecognizeWithProfile {
+  std::vector<uint8_t> bytes;
+  ImageLimits limits;
+  std::shared_ptr<const JobProfile> profile;
+  size_t payload_bytes() const { return bytes.size(); }
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
+    RequireInitialized(initialized, "recognizeWithProfile");
+    Pix *pix =
+        DecodeImage(bytes.data(), bytes.size(), limits, "recognizeWithProfile");
+    if (pix == nullptr) {
+      throw_runtime("recognizeWithProfile: failed to decode image buffer");
+    }
+    const std::shared_ptr<Pix> page =
+        SharePix(NormalizePageImage(pix, "recognizeWithProfile"));
+
+    const tesseract::PageSegMode previous_psm = api.GetPageSegMode();
+    if (profile->psm) {
+      api.SetPageSegMode(*profile->psm);
+    }
+    ResultRecognizedFile result{};
+    try {
+      result = Recognize(api, page.get());
+    } catch (...) {
+      api.SetPageSegMode(previous_psm);
+      throw;
+    }
+    api.SetPageSegMode(previous_psm);
+    return result;
+  }
+
+private:
+  ResultRecognizedFile Recognize(tesseract::TessBaseAPI &api,
+                                 Pix *page) const {
+    api.SetImage(page);
+    if (profile->rect) {
+      api.SetRectangle(profile->rect->left, profile->rect->top,
+                       profile->rect->width, profile->rect->height);
+    }
+
+    MonitorHandle handle{nullptr};
+    auto *monitor = handle.Monitor();
+    tesseract::ETEXT_DESC timeout_only_monitor{};
+    if (profile->timeout_millisec > 0) {
+      if (monitor == nullptr) {
+        monitor = &timeout_only_monitor;
+      }
+      monitor->set_deadline_msecs(profile->timeout_millisec);
+    }
+    if (TracedRecognize(api, monitor) < 0) {
+      throw_runtime("recognizeWithProfile: recognition failed or timed out");
+    }
+
+    ResultRecognizedFile result{};
+    result.width = pixGetWidth(page);
+    result.height = pixGetHeight(page);
+    RenderFileOutputs(api, result, profile->text, profile->hocr, profile->tsv,
+                      profile->alto, "recognizeWithProfile");
+    return result;
+  }
+};
+
 struct CommandSetPageMode {
   tesseract::PageSegMode psm;
   Result invoke(tesseract::TessBaseAPI &api,
@@ -742,12 +1059,42 @@ struct CommandSetPageMode {
   }
 };
 
+// The rectangle last set by setRectangle and the image it was set on.
+// TessBaseAPI has no getter for it, so commands that move the rectangle
+// restore it from here. The reference keeps the image's address from being
+// reused by a later image while the rectangle is kept.
+struct RectangleState {
+  std::shared_ptr<Pix> image;
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+
+  // Sets the kept rectangle if `api` still holds its image, else the full
+  // image.
+  void Restore(tesseract::TessBaseAPI &api) const {
+    Pix *current = api.GetInputImage();
+    if (current == nullptr) {
+      return;
+    }
+    if (image != nullptr && image.get() == current) {
+      api.SetRectangle(left, top, width, height);
+    } else {
+      api.SetRectangle(0, 0, pixGetWidth(current), pixGetHeight(current));
+    }
+  }
+};
+
 struct CommandSetRectangle {
   int left, top, width, height;
   Result invoke(tesseract::TessBaseAPI &api,
-                const std::atomic<bool> &initialized) const {
+                const std::atomic<bool> &initialized,
+                RectangleState &rectangle) const {
     RequireInitialized(initialized, "setRectangle");
     api.SetRectangle(left, top, width, height);
+    Pix *image = api.GetInputImage();
+    rectangle = {image != nullptr ? SharePix(pixClone(image)) : nullptr, left,
+                 top, width, height};
     return ResultVoid{};
   }
 };
@@ -762,21 +1109,409 @@ struct CommandSetSourceResolution {
   }
 };
 
+// OSD only needs a handful of text lines at moderate resolution, so it runs
+// on a copy whose longer side is at most this many pixels.
+inline constexpr int kOsdMaxDimension = 1600;
+
+// Detects the orientation on a downscaled copy of the current input image,
+// then sets the upright full-resolution image on the engine. If OSD finds no
+// usable text the original image is kept and a zero result is returned.
+inline ResultOrientationScript AutoRotateInputImage(tesseract::TessBaseAPI &api,
+                                                    const char *method) {
+  Pix *source = api.GetInputImage();
+  if (source == nullptr) {
+    throw_runtime("{}: call setImage(...) first", method);
+  }
+
+  // SetImage below replaces (and frees) the engine's input image and resets
+  // the resolution, so keep our own reference and the effective resolution.
+  Pix *original = pixClone(source);
+  const int width = pixGetWidth(original);
+  const int height = pixGetHeight(original);
+  const int y_res = api.GetSourceYResolution();
+  const int longest = std::max(width, height);
+
+  Pix *osd_image = nullptr;
+  float scale = 1.0f;
+  if (longest > kOsdMaxDimension) {
+    scale = static_cast<float>(kOsdMaxDimension) / static_cast<float>(longest);
+    osd_image = pixScale(original, scale, scale);
+  }
+  if (osd_image == nullptr) {
+    scale = 1.0f;
+    osd_image = pixClone(original);
+  }
+
+  api.SetImage(osd_image);
+  if (y_res > 0) {
+    api.SetSourceResolution(static_cast<int>(y_res * scale));
+  }
+
+  ResultOrientationScript result;
+  int orient_deg = 0;
+  float orient_conf = 0.0f;
+  const char *script_name = nullptr;
+  float script_conf = 0.0f;
+  if (api.DetectOrientationScript(&orient_deg, &orient_conf, &script_name,
+                                  &script_conf)) {
+    result.orientation_degrees = orient_deg;
+    result.orientation_confidence = orient_conf;
+    result.script_name = script_name ? script_name : "";
+    result.script_confidence = script_conf;
+  }
+  pixDestroy(&osd_image);
+
+  // orient_deg is the clockwise rotation of the page; pixRotateOrth rotates
+  // clockwise in quarter turns, so undo it with the complementary turn.
+  const int quads = (4 - (result.orientation_degrees / 90) % 4) % 4;
+  Pix *upright = quads != 0 ? pixRotateOrth(original, quads) : nullptr;
+  if (upright == nullptr) {
+    upright = pixClone(original);
+  }
+
+  api.SetImage(upright);
+  if (y_res > 0) {
+    api.SetSourceResolution(y_res);
+  }
+  pixDestroy(&upright);
+  pixDestroy(&original);
+
+  return result;
+}
+
 struct CommandRecognize {
   std::shared_ptr<MonitorContext> monitor_context;
+  bool auto_rotate{false};
+  VariableOverlay vars; // for this job only, see OverlayState
   Result invoke(tesseract::TessBaseAPI &api,
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "recognize");
+
+    std::optional<ResultOrientationScript> orientation;
+    if (auto_rotate) {
+      orientation = AutoRotateInputImage(api, "recognize");
+    }
+
     MonitorHandle handle{monitor_context};
-    auto *monitor = monitor_context ? &handle.monitor : nullptr;
-    if (api.Recognize(monitor) != 0) {
+    auto *monitor = handle.Monitor();
+    if (TracedRecognize(api, monitor) != 0) {
       throw_runtime(
           "recognize: TessBaseAPI::Recognize returned non-zero status");
     }
+
+    if (orientation.has_value()) {
+      return *orientation;
+    }
     return ResultVoid{};
   }
 };
 
+struct Region {
+  int left, top, width, height;
+  std::optional<tesseract::PageSegMode> psm;
+};
+
+struct CommandRecognizeRegions {
+  std::vector<Region> regions;
+  std::optional<tesseract::PageSegMode> psm;
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized,
+                const RectangleState &rectangle) const {
+    RequireInitialized(initialized, "recognizeRegions");
+
+    if (api.GetInputImage() == nullptr) {
+      throw_runtime("recognizeRegions: call setImage(...) first");
+    }
+
+    // The decoded page stays in the engine for the whole batch; each
+    // SetRectangle only re-thresholds the pixels inside that rectangle.
+    const tesseract::PageSegMode previous_psm = api.GetPageSegMode();
+    auto restore = [&] {
+      api.SetPageSegMode(previous_psm);
+      rectangle.Restore(api);
+    };
+
+    std::vector<ResultRegion> results;
+    results.reserve(regions.size());
+
+    for (size_t i = 0; i < regions.size(); ++i) {
+      const Region &region = regions[i];
+      const tesseract::PageSegMode region_psm =
+          region.psm.value_or(psm.value_or(previous_psm));
+
+      api.SetPageSegMode(region_psm);
+      api.SetRectangle(region.left, region.top, region.width, region.height);
+
+      if (TracedRecognize(api, nullptr) != 0) {
+        restore();
+        throw_runtime("recognizeRegions: TessBaseAPI::Recognize failed for "
+                      "region {}",
+                      i);
+      }
+
+      char *text = api.GetUTF8Text();
+      ResultRegion &result = results.emplace_back();
+      result.left = region.left;
+      result.top = region.top;
+      result.width = region.width;
+      result.height = region.height;
+      result.psm = static_cast<int>(region_psm);
+      result.text = text ? std::string{text} : std::string{};
+      result.confidence = api.MeanTextConf();
+      delete[] text;
+    }
+
+    restore();
+    return ResultList<ResultRegion>{std::move(results)};
+  }
+};
+
+// One raw frame of a stream. Only the areas that changed since the previous
+// frame are recognized; the result lists the text lines that appeared and
+// the ids of those that are gone.
+struct CommandRecognizeFrame {
+  std::vector<uint8_t> bytes;
+  int width = 0;
+  int height = 0;
+  int bytes_per_pixel = 0;
+  int bytes_per_line = 0;
+  int tile_size = 32;
+  bool reset = false;
+  size_t payload_bytes() const { return bytes.size(); }
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized,
+                FrameStream &stream) const {
+    RequireInitialized(initialized, "recognizeFrame");
+    ResultFrame result;
+    result.removed = std::exchange(stream.unreported, {});
+    if (reset ||
+        !stream.Matches(width, height, bytes_per_pixel, tile_size)) {
+      std::vector<int> dropped =
+          stream.Restart(width, height, bytes_per_pixel, tile_size);
+      result.removed.insert(result.removed.end(), dropped.begin(),
+                            dropped.end());
+    }
+
+    result.frame = stream.frames++;
+    const int first_new_id = stream.next_line_id;
+    try {
+      Update(api, stream, result);
+    } catch (...) {
+      // The lines no longer match the kept frame: read the next one anew.
+      // The next result reports every line the caller has seen as removed;
+      // lines added by this frame never reached it.
+      stream.unreported = std::move(result.removed);
+      for (const int id :
+           stream.Restart(width, height, bytes_per_pixel, tile_size)) {
+        if (id < first_new_id) {
+          stream.unreported.push_back(id);
+        }
+      }
+      throw;
+    }
+    std::sort(result.removed.begin(), result.removed.end());
+
+    for (const FrameLine &line : stream.lines) {
+      if (!result.text.empty()) {
+        result.text += '\n';
+      }
+      result.text += line.text;
+    }
+    return result;
+  }
+
+private:
+  void Update(tesseract::TessBaseAPI &api, FrameStream &stream,
+              ResultFrame &result) const {
+    std::vector<uint8_t> changed;
+    {
+      TraceSpan span{"image", "diffFrame"};
+      changed = DiffFrameTiles(stream, bytes.data(),
+                               static_cast<size_t>(bytes_per_line));
+    }
+    result.total_tiles = static_cast<int>(changed.size());
+    result.changed_tiles =
+        static_cast<int>(std::count(changed.begin(), changed.end(), 1));
+    if (result.changed_tiles == 0) {
+      return;
+    }
+
+    std::vector<FrameRect> rects = ChangedFrameRects(stream, changed);
+    std::vector<int> invalidated = InvalidateFrameLines(rects, stream);
+    result.removed.insert(result.removed.end(), invalidated.begin(),
+                          invalidated.end());
+
+    api.SetImage(bytes.data(), width, height, bytes_per_pixel,
+                 bytes_per_line);
+    for (const FrameRect &rect : rects) {
+      api.SetRectangle(rect.left, rect.top, rect.right - rect.left,
+                       rect.bottom - rect.top);
+      if (TracedRecognize(api, nullptr) != 0) {
+        throw_runtime("recognizeFrame: TessBaseAPI::Recognize failed");
+      }
+
+      constexpr auto kLine = tesseract::RIL_TEXTLINE;
+      std::unique_ptr<tesseract::ResultIterator> iter{api.GetIterator()};
+      if (iter == nullptr) {
+        continue;
+      }
+      do {
+        if (iter->Empty(kLine)) {
+          continue;
+        }
+        std::unique_ptr<char[]> text{iter->GetUTF8Text(kLine)};
+        std::string line_text = text ? std::string{text.get()} : std::string{};
+        while (!line_text.empty() &&
+               std::isspace(static_cast<unsigned char>(line_text.back()))) {
+          line_text.pop_back();
+        }
+        if (line_text.empty()) {
+          continue;
+        }
+
+        FrameLine &line = stream.lines.emplace_back();
+        line.id = stream.next_line_id++;
+        iter->BoundingBox(kLine, &line.box.left, &line.box.top,
+                          &line.box.right, &line.box.bottom);
+        line.text = std::move(line_text);
+        line.confidence = iter->Confidence(kLine);
+        result.added.push_back({line.id, line.box.left, line.box.top,
+                                line.box.right - line.box.left,
+                                line.box.bottom - line.box.top, line.text,
+                                line.confidence});
+      } while (iter->Next(kLine));
+    }
+    api.SetRectangle(0, 0, width, height);
+
+    std::stable_sort(stream.lines.begin(), stream.lines.end(),
+                     [](const FrameLine &a, const FrameLine &b) {
+                       return a.box.top != b.box.top ? a.box.top < b.box.top
+                                                     : a.box.left < b.box.left;
+                     });
+  }
+};
+
+// Second engine owned by the worker, usually loaded with a slower but more
+// accurate model. It only ever sees the parts of a page the primary engine
+// was not confident about.
+struct CascadeEngine {
+  tesseract::TessBaseAPI api;
+  std::atomic<bool> initialized{false};
+};
+
+struct CommandInitCascade {
+  std::string data_path, language;
+  tesseract::OcrEngineMode oem{tesseract::OEM_DEFAULT};
+  Result invoke(tesseract::TessBaseAPI &, std::atomic<bool> &,
+                CascadeEngine &cascade) const {
+    cascade.initialized.store(false, std::memory_order_release);
+    if (cascade.api.Init(data_path.empty() ? nullptr : data_path.c_str(), 0,
+                         language.empty() ? nullptr : language.c_str(), oem,
+                         nullptr, 0, nullptr, nullptr, false,
+                         ReadTraineddata) != 0) {
+      throw_runtime(
+          "initCascade: TessBaseAPI::Init returned non-zero status");
+    }
+    cascade.initialized.store(true, std::memory_order_release);
+    return ResultVoid{};
+  }
+};
+
+struct CommandRecognizeCascade {
+  int min_confidence{80};
+  tesseract::PageIteratorLevel level{tesseract::RIL_WORD};
+  std::shared_ptr<MonitorContext> monitor_context;
+  Result invoke(tesseract::TessBaseAPI &api, std::atomic<bool> &initialized,
+                CascadeEngine &cascade) const {
+    RequireInitialized(initialized, "recognizeCascade");
+    if (!cascade.initialized.load(std::memory_order_acquire)) {
+      throw_runtime("recognizeCascade: call initCascade(...) first");
+    }
+
+    Pix *source = api.GetInputImage();
+    if (source == nullptr) {
+      throw_runtime("recognizeCascade: call setImage(...) first");
+    }
+
+    MonitorHandle handle{monitor_context};
+    auto *monitor = handle.Monitor();
+    if (TracedRecognize(api, monitor) != 0) {
+      throw_runtime(
+          "recognizeCascade: TessBaseAPI::Recognize returned non-zero status");
+    }
+
+    std::unique_ptr<tesseract::ResultIterator> iter{api.GetIterator()};
+    ResultCascade result;
+    if (iter == nullptr) {
+      return result;
+    }
+
+    const tesseract::PageSegMode refine_psm = level == tesseract::RIL_WORD
+                                                  ? tesseract::PSM_SINGLE_WORD
+                                                  : tesseract::PSM_SINGLE_LINE;
+    bool cascade_has_image = false;
+
+    auto trim = [](std::string text) {
+      while (!text.empty() && std::isspace(static_cast<unsigned char>(
+                                  text.back()))) {
+        text.pop_back();
+      }
+      return text;
+    };
+
+    do {
+      if (iter->Empty(level)) {
+        continue;
+      }
+
+      int left = 0, top = 0, right = 0, bottom = 0;
+      iter->BoundingBox(level, &left, &top, &right, &bottom);
+
+      std::unique_ptr<char[]> text{iter->GetUTF8Text(level)};
+      ResultCascadeItem &item = result.items.emplace_back();
+      item.text = trim(text ? std::string{text.get()} : std::string{});
+      item.confidence = iter->Confidence(level);
+      item.left = left;
+      item.top = top;
+      item.width = right - left;
+      item.height = bottom - top;
+
+      if (item.confidence < static_cast<float>(min_confidence) &&
+          item.width > 0 && item.height > 0) {
+        if (!cascade_has_image) {
+          cascade.api.SetImage(source);
+          cascade.api.SetPageSegMode(refine_psm);
+          cascade_has_image = true;
+        }
+        cascade.api.SetRectangle(left, top, item.width, item.height);
+        if (TracedRecognize(cascade.api, nullptr) == 0) {
+          std::unique_ptr<char[]> refined{cascade.api.GetUTF8Text()};
+          const int refined_confidence = cascade.api.MeanTextConf();
+          if (refined && refined_confidence > item.confidence) {
+            item.text = trim(refined.get());
+            item.confidence = static_cast<float>(refined_confidence);
+            item.refined = true;
+            ++result.refined_count;
+          }
+        }
+      }
+
+      if (!result.text.empty()) {
+        result.text += level == tesseract::RIL_WORD &&
+                               !iter->IsAtBeginningOf(tesseract::RIL_TEXTLINE)
+                           ? " "
+                           : "\n";
+      }
+      result.text += item.text;
+    } while (iter->Next(level));
+
+    if (cascade_has_image) {
+      cascade.api.Clear();
+    }
+    return result;
+  }
+};
+
 // struct CommandGetIterator {
 //   Result invoke(tesseract::TessBaseAPI &api) const {
 //     api.GetIterator();
@@ -799,12 +1534,12 @@ struct CommandDetectOrientationScript {
           "returned false");
     }
 
-    return ResultObject{{
-        {"orientationDegrees", orient_deg},
-        {"orientationConfidence", orient_conf},
-        {"scriptName", script_name},
-        {"scriptConfidence", script_conf},
-    }};
+    return ResultOrientationScript{
+        .orientation_degrees = orient_deg,
+        .orientation_confidence = orient_conf,
+        .script_name = script_name,
+        .script_confidence = script_conf,
+    };
   }
 };
 
@@ -823,7 +1558,7 @@ struct CommandGetPAGEText {
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "getPAGEText");
     MonitorHandle handle{monitor_context};
-    auto *monitor = monitor_context ? &handle.monitor : nullptr;
+    auto *monitor = handle.Monitor();
     char *page_text = api.GetPAGEText(monitor, page_number);
     if (!page_text) {
       throw_runtime("getPAGEText: TessBaseAPI::GetPAGEText returned null");
@@ -941,7 +1676,7 @@ struct CommandGetHOCRText {
     RequireInitialized(initialized, "getHOCRText");
 
     MonitorHandle handle{monitor_context};
-    auto *monitor = monitor_context ? &handle.monitor : nullptr;
+    auto *monitor = handle.Monitor();
     char *hocr_text = api.GetHOCRText(monitor, page_number);
     if (!hocr_text) {
       throw_runtime("getHOCRText: TessBaseAPI::GetHOCRText returned null");
@@ -991,7 +1726,7 @@ struct CommandGetALTOText {
                 const std::atomic<bool> &initialized) const {
     RequireInitialized(initialized, "getALTOText");
     MonitorHandle handle{monitor_context};
-    auto *monitor = monitor_context ? &handle.monitor : nullptr;
+    auto *monitor = handle.Monitor();
     char *alto_text = api.GetAltoText(monitor, page_number);
     if (!alto_text) {
       throw_runtime("getALTOText: TessBaseAPI::GetAltoText returned null");
@@ -1032,9 +1767,15 @@ struct CommandGetLoadedLanguages {
 };
 
 struct CommandGetAvailableLanguages {
-  Result invoke(tesseract::TessBaseAPI &api) const {
+  Result invoke(tesseract::TessBaseAPI &api,
+                const std::atomic<bool> &initialized) const {
     std::vector<std::string> langs;
     api.GetAvailableLanguagesAsVector(&langs);
+    // Tesseract only lists plain .traineddata files; add compressed ones
+    if (initialized.load(std::memory_order_acquire) &&
+        api.GetDatapath() != nullptr) {
+      AddCompressedLanguages(api.GetDatapath(), langs);
+    }
     return ResultArray{langs};
   }
 };
@@ -1049,32 +1790,39 @@ struct CommandClear {
 };
 
 struct CommandEnd {
-  Result invoke(tesseract::TessBaseAPI &api,
-                std::atomic<bool> &initialized) const {
+  Result invoke(tesseract::TessBaseAPI &api, std::atomic<bool> &initialized,
+                CascadeEngine &cascade) const {
     api.End();
     initialized.store(false, std::memory_order_release);
+    cascade.api.End();
+    cascade.initialized.store(false, std::memory_order_release);
     return ResultVoid{};
   }
 };
 
 using Command = std::variant<
-    CommandVersion, CommandIsInitialized, CommandInit,
-    CommandInitForAnalysePage, CommandSetVariable, CommandSetDebugVariable,
-    CommandGetIntVariable, CommandGetBoolVariable, CommandGetDoubleVariable,
-    CommandGetStringVariable, CommandSetInputName, CommandGetInputName,
-    CommandSetOutputName, CommandGetDataPath, CommandSetInputImage,
-    CommandGetInputImage, CommandSetPageMode, CommandSetRectangle,
-    CommandSetSourceResolution, CommandGetSourceYResolution, CommandSetImage,
+    CommandVersion, CommandInit, CommandInitForAnalysePage, CommandSetVariable,
+    CommandSetDebugVariable, CommandGetIntVariable, CommandGetBoolVariable,
+    CommandGetDoubleVariable, CommandGetStringVariable, CommandSetInputName,
+    CommandGetInputName, CommandSetOutputName, CommandGetDataPath,
+    CommandSetInputImage, CommandGetInputImage, CommandSetPageMode,
+    CommandSetRectangle, CommandSetSourceResolution,
+    CommandGetSourceYResolution, CommandSetImage, CommandSetImageFromFile,
     CommandGetThresholdedImage, CommandGetThresholdedImageScaleFactor,
-    CommandRecognize, CommandAnalyseLayout, CommandDetectOrientationScript,
+    CommandRecognize, CommandRecognizeFile, CommandCheckProfileVariables,
+    CommandRecognizeWithProfile,
+    CommandRecognizeRegions, CommandRecognizeFrame, CommandInitCascade,
+    CommandRecognizeCascade, CommandAnalyseLayout, CommandGetComponentImages,
+    CommandDetectOrientationScript,
     CommandMeanTextConf, CommandAllWordConfidences, CommandGetUTF8Text,
     CommandGetHOCRText, CommandGetTSVText, CommandGetUNLVText,
     CommandGetALTOText, CommandGetPAGEText, CommandGetLSTMBoxText,
     CommandGetBoxText, CommandGetWordStrBoxText, CommandGetOSDText,
-    CommandBeginProcessPages, CommandAddProcessPage, CommandFinishProcessPages,
-    CommandAbortProcessPages, CommandGetProcessPagesStatus,
-    CommandGetInitLanguages, CommandGetLoadedLanguages,
-    CommandGetAvailableLanguages, CommandClearPersistentCache,
+    CommandBeginProcessPages, CommandAddProcessPage,
+    CommandAddProcessPageFromFile, CommandFinishProcessPages,
+    CommandAbortProcessPages, CommandGetInitLanguages,
+    CommandGetLoadedLanguages, CommandGetAvailableLanguages,
+    CommandGetThreadingConfig, CommandClearPersistentCache,
     CommandClearAdaptiveClassifier, CommandClear, CommandEnd>;
 
 struct Job {
@@ -1085,4 +1833,84 @@ struct Job {
   std::optional<std::string> error;
   std::optional<std::string> error_code;
   std::optional<std::string> error_method;
+
+  // payload bytes admitted against the instance's memory budget
+  int64_t reserved_bytes{0};
+
+  // native bytes of `result`, counted until the job is settled
+  int64_t result_bytes{0};
+
+  // trace clock at submission, -1 while tracing is off
+  int64_t enqueued_us{-1};
+
+  // links a finished job into the CompletionQueue
+  Job *next_completed{nullptr};
+  std::shared_ptr<Job> self;
 };
+
+// Bytes a queued command holds outside of the V8 heap until it has run.
+inline int64_t PayloadBytes(const Command &command) {
+  return std::visit(
+      [](const auto &c) -> int64_t {
+        if constexpr (requires { c.payload_bytes(); }) {
+          return static_cast<int64_t>(c.payload_bytes());
+        }
+        return 0;
+      },
+      command);
+}
+
+// What the worker does with the active overlay before a command runs.
+enum class OverlayUse {
+  Keep,    // renders or inspects the last recognition: runs with it
+  Apply,   // recognizes: runs with its own overlay, or the engine's values
+  Restore, // reads, sets or reloads variables: runs with the engine's values
+};
+
+inline OverlayUse CommandOverlayUse(const Command &command) {
+  return std::visit(
+      [](const auto &c) {
+        using T = std::decay_t<decltype(c)>;
+        if constexpr (std::is_same_v<T, CommandRecognize> ||
+                      std::is_same_v<T, CommandRecognizeFile> ||
+                      std::is_same_v<T, CommandRecognizeWithProfile> ||
+                      std::is_same_v<T, CommandRecognizeRegions> ||
+                      std::is_same_v<T, CommandRecognizeFrame> ||
+                      std::is_same_v<T, CommandRecognizeCascade> ||
+                      std::is_same_v<T, CommandAnalyseLayout> ||
+                      std::is_same_v<T, CommandDetectOrientationScript> ||
+                      std::is_same_v<T, CommandBeginProcessPages> ||
+                      std::is_same_v<T, CommandAddProcessPage> ||
+                      std::is_same_v<T, CommandAddProcessPageFromFile> ||
+                      std::is_same_v<T, CommandFinishProcessPages>) {
+          return OverlayUse::Apply;
+        } else if constexpr (std::is_same_v<T, CommandInit> ||
+                             std::is_same_v<T, CommandInitForAnalysePage> ||
+                             std::is_same_v<T, CommandSetVariable> ||
+                             std::is_same_v<T, CommandSetDebugVariable> ||
+                             std::is_same_v<T, CommandGetIntVariable> ||
+                             std::is_same_v<T, CommandGetBoolVariable> ||
+                             std::is_same_v<T, CommandGetDoubleVariable> ||
+                             std::is_same_v<T, CommandGetStringVariable> ||
+                             std::is_same_v<T, CommandCheckProfileVariables>) {
+          return OverlayUse::Restore;
+        }
+        return OverlayUse::Keep;
+      },
+      command);
+}
+
+// Variables the worker sets for the command, see OverlayUse::Apply.
+inline const VariableOverlay &CommandOverlay(const Command &command) {
+  static const VariableOverlay none;
+  return std::visit(
+      [](const auto &c) -> const VariableOverlay & {
+        if constexpr (requires { c.vars; }) {
+          return c.vars;
+        } else if constexpr (requires { c.profile->variables; }) {
+          return c.profile->variables;
+        }
+        return none;
+      },
+      command);
+}
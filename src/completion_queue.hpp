@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "commands.hpp"
+#include <atomic>
+#include <memory>
+#include <utility>
+
+// Lock-free multi-producer, single-consumer list of finished jobs. Jobs are
+// linked through Job::next_completed and keep themselves alive through
+// Job::self while listed, so pushing never allocates.
+//
+// Only a push onto an empty list needs to wake the JS thread: until the next
+// drain, later pushes are picked up by the drain that is already scheduled.
+class CompletionQueue {
+public:
+  ~CompletionQueue() {
+    Drain([](std::shared_ptr<Job>) {});
+  }
+
+  // Returns true if the list was empty and the caller must schedule a drain.
+  bool Push(std::shared_ptr<Job> job) {
+    Job *node = job.get();
+    node->self = std::move(job);
+
+    Job *head = _head.load(std::memory_order_relaxed);
+    do {
+      node->next_completed = head;
+    } while (!_head.compare_exchange_weak(head, node, std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return head == nullptr;
+  }
+
+  // Takes every listed job and passes it to `fn` in completion order.
+  template <typename F> void Drain(F &&fn) {
+    Job *node = _head.exchange(nullptr, std::memory_order_acquire);
+
+    // the list is LIFO; reverse it so promises settle in completion order
+    Job *ordered = nullptr;
+    while (node != nullptr) {
+      Job *next = node->next_completed;
+      node->next_completed = ordered;
+      ordered = node;
+      node = next;
+    }
+
+    while (ordered != nullptr) {
+      Job *next = ordered->next_completed;
+      ordered->next_completed = nullptr;
+      fn(std::move(ordered->self));
+      ordered = next;
+    }
+  }
+
+private:
+  std::atomic<Job *> _head{nullptr};
+};
@@ -0,0 +1,417 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+// tesseract-ocrd: keeps a pool of initialized engines warm and serves
+// recognition requests from any number of Node processes over a Unix domain
+// socket (see daemon_protocol.hpp and TesseractClient).
+//
+//   tesseract-ocrd --socket PATH [--langs eng] [--datapath DIR]
+//                  [--engines N] [--psm N] [--max-connections N]
+
+#include "daemon_protocol.hpp"
+#include "image_decode.hpp"
+#include "mapped_file.hpp"
+#include "traineddata.hpp"
+#include "variable_overlay.hpp"
+#include <algorithm>
+#include <allheaders.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <tesseract/baseapi.h>
+#include <tesseract/publictypes.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void HandleSignal(int) { g_stop.store(true); }
+
+struct Options {
+  std::string socket_path;
+  std::string langs{"eng"};
+  std::string datapath;
+  unsigned engines{0};
+  int psm{tesseract::PSM_AUTO};
+  unsigned max_connections{64};
+};
+
+[[noreturn]] void Usage(const char *message) {
+  std::fprintf(stderr,
+               "tesseract-ocrd: %s\n"
+               "usage: tesseract-ocrd --socket PATH [--langs LANGS] "
+               "[--datapath DIR] [--engines N] [--psm N] "
+               "[--max-connections N]\n",
+               message);
+  std::exit(2);
+}
+
+Options ParseOptions(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (i + 1 >= argc) {
+      Usage("missing value for the last option");
+    }
+    const char *value = argv[++i];
+    if (arg == "--socket") {
+      options.socket_path = value;
+    } else if (arg == "--langs") {
+      options.langs = value;
+    } else if (arg == "--datapath") {
+      options.datapath = value;
+    } else if (arg == "--engines") {
+      const int engines = std::atoi(value);
+      if (engines < 1) {
+        Usage("--engines must be a positive integer");
+      }
+      options.engines = static_cast<unsigned>(engines);
+    } else if (arg == "--psm") {
+      options.psm = std::atoi(value);
+      if (options.psm < 0 || options.psm >= tesseract::PSM_COUNT) {
+        Usage("--psm is out of range");
+      }
+    } else if (arg == "--max-connections") {
+      const int connections = std::atoi(value);
+      if (connections < 1) {
+        Usage("--max-connections must be a positive integer");
+      }
+      options.max_connections = static_cast<unsigned>(connections);
+    } else {
+      Usage("unknown option");
+    }
+  }
+  if (options.socket_path.empty()) {
+    Usage("--socket is required");
+  }
+  if (options.engines == 0) {
+    options.engines = std::max(1u, std::thread::hardware_concurrency() / 2);
+  }
+  return options;
+}
+
+struct Engine {
+  tesseract::TessBaseAPI api;
+  OverlayState overlay; // vars of the last request it served
+};
+
+// Engines are initialized once at startup and handed to one request at a
+// time; a request that finds them all busy waits for the next one.
+class EnginePool {
+public:
+  void Add(std::unique_ptr<Engine> engine) {
+    _engines.push_back(engine.get());
+    _owned.push_back(std::move(engine));
+  }
+
+  size_t Size() const { return _owned.size(); }
+
+  Engine &Acquire() {
+    std::unique_lock lock(_mutex);
+    _cv.wait(lock, [&] { return !_engines.empty(); });
+    Engine *engine = _engines.back();
+    _engines.pop_back();
+    return *engine;
+  }
+
+  void Release(Engine &engine) {
+    {
+      std::scoped_lock lock(_mutex);
+      _engines.push_back(&engine);
+    }
+    _cv.notify_one();
+  }
+
+private:
+  std::vector<std::unique_ptr<Engine>> _owned;
+  std::vector<Engine *> _engines;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+};
+
+class EngineLease {
+public:
+  explicit EngineLease(EnginePool &pool)
+      : _pool(pool), _engine(pool.Acquire()) {}
+  EngineLease(const EngineLease &) = delete;
+  EngineLease &operator=(const EngineLease &) = delete;
+  ~EngineLease() {
+    _engine.api.Clear();
+    _pool.Release(_engine);
+  }
+
+  tesseract::TessBaseAPI &operator*() const { return _engine.api; }
+  tesseract::TessBaseAPI *operator->() const { return &_engine.api; }
+  OverlayState &Overlay() const { return _engine.overlay; }
+
+private:
+  EnginePool &_pool;
+  Engine &_engine;
+};
+
+std::string TakeText(char *text, const char *getter) {
+  if (text == nullptr) {
+    throw_runtime("recognize: TessBaseAPI::{} returned null", getter);
+  }
+  std::string result{text};
+  delete[] text;
+  return result;
+}
+
+class Server {
+public:
+  Server(const Options &options, EnginePool &engines)
+      : _options(options), _engines(engines) {}
+
+  ocrd::InfoResponse Info() const {
+    return {tesseract::TessBaseAPI::Version(), _options.langs,
+            static_cast<uint32_t>(_engines.Size())};
+  }
+
+  // Decoding runs before an engine is leased, so busy engines only ever
+  // wait on recognition.
+  ocrd::RecognizeResponse
+  Recognize(const ocrd::RecognizeRequest &request) const {
+    Pix *pix = nullptr;
+    if (!request.shm_name.empty()) {
+      const auto shm = ocrd::SharedMemory::Open(
+          request.shm_name, static_cast<size_t>(request.shm_size));
+      pix = DecodeImage(shm.Data(), shm.Size(), _limits, "recognize");
+    } else {
+      const MappedFile file = MappedFile::Open(request.path, "recognizeFile");
+      pix = DecodeImage(file.data(), file.size(), _limits, "recognizeFile");
+    }
+    if (pix == nullptr) {
+      throw_runtime("recognize: failed to decode image");
+    }
+    pix = NormalizePageImage(pix, "recognize");
+    VariableOverlay vars = request.vars;
+    SortOverlay(vars);
+
+    ocrd::RecognizeResponse response;
+    response.width = pixGetWidth(pix);
+    response.height = pixGetHeight(pix);
+    try {
+      EngineLease api(_engines);
+      // engines keep the vars until a request with other ones, or none,
+      // comes along, so repeated configurations cost nothing to set
+      api.Overlay().Apply(*api, vars, "recognize");
+      api->SetPageSegMode(static_cast<tesseract::PageSegMode>(
+          request.psm >= 0 && request.psm < tesseract::PSM_COUNT
+              ? request.psm
+              : _options.psm));
+      api->SetImage(pix);
+      if (api->Recognize(nullptr) < 0) {
+        throw_runtime("recognize: recognition failed");
+      }
+      response.mean_confidence = api->MeanTextConf();
+      if (request.outputs & ocrd::kOutputText) {
+        response.text = TakeText(api->GetUTF8Text(), "GetUTF8Text");
+      }
+      if (request.outputs & ocrd::kOutputHocr) {
+        response.hocr = TakeText(api->GetHOCRText(0), "GetHOCRText");
+      }
+      if (request.outputs & ocrd::kOutputTsv) {
+        response.tsv = TakeText(api->GetTSVText(0), "GetTSVText");
+      }
+      if (request.outputs & ocrd::kOutputAlto) {
+        response.alto = TakeText(api->GetAltoText(0), "GetAltoText");
+      }
+    } catch (...) {
+      pixDestroy(&pix);
+      throw;
+    }
+    pixDestroy(&pix);
+    return response;
+  }
+
+  // One thread per connection, at most --max-connections of them; a
+  // connection carries one request at a time.
+  void Serve(int fd) const {
+    try {
+      ocrd::MessageType type{};
+      std::string payload;
+      while (ocrd::ReadFrame(fd, type, payload)) {
+        switch (type) {
+        case ocrd::MessageType::Info:
+          ocrd::SendFrame(fd, ocrd::MessageType::InfoResult, Info().Encode());
+          break;
+        case ocrd::MessageType::Recognize:
+          Reply(fd, payload);
+          break;
+        default:
+          throw ocrd::ProtocolError("unexpected message type");
+        }
+      }
+    } catch (const std::exception &e) {
+      std::fprintf(stderr, "tesseract-ocrd: connection dropped: %s\n",
+                   e.what());
+    }
+  }
+
+private:
+  void Reply(int fd, const std::string &payload) const {
+    const auto request = ocrd::RecognizeRequest::Decode(payload);
+    ocrd::ErrorResponse error;
+    try {
+      ocrd::SendFrame(fd, ocrd::MessageType::RecognizeResult,
+                      Recognize(request).Encode());
+      return;
+    } catch (const ocrd::ProtocolError &) {
+      throw;
+    } catch (const ImageLimitError &e) {
+      error = {"ERR_IMAGE_LIMIT", e.what()};
+    } catch (const std::exception &e) {
+      error = {"ERR_TESSERACT_RUNTIME", e.what()};
+    }
+    ocrd::SendFrame(fd, ocrd::MessageType::Error, error.Encode());
+  }
+
+  const Options &_options;
+  EnginePool &_engines;
+  ImageLimits _limits{};
+};
+
+int Listen(const std::string &path) {
+  const sockaddr_un address = ocrd::SocketAddress(path);
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw_runtime("socket failed: {}", std::strerror(errno));
+  }
+  ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  ::unlink(path.c_str()); // stale socket of a previous run
+
+  // same-user only, like the shared memory objects
+  const mode_t mask = ::umask(0177);
+  const int bound = ::bind(fd, reinterpret_cast<const sockaddr *>(&address),
+                           sizeof(address));
+  ::umask(mask);
+  if (bound != 0 || ::listen(fd, SOMAXCONN) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw_runtime("cannot listen on \"{}\": {}", path, std::strerror(error));
+  }
+  return fd;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const Options options = ParseOptions(argc, argv);
+
+  struct sigaction action{};
+  action.sa_handler = HandleSignal;
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+  ::signal(SIGPIPE, SIG_IGN);
+
+  EnginePool engines;
+  for (unsigned i = 0; i < options.engines; ++i) {
+    auto engine = std::make_unique<Engine>();
+    if (engine->api.Init(options.datapath.empty() ? nullptr
+                                                  : options.datapath.c_str(),
+                         0, options.langs.c_str(), tesseract::OEM_DEFAULT,
+                         nullptr, 0, nullptr, nullptr, false,
+                         ReadTraineddata) != 0) {
+      std::fprintf(stderr, "tesseract-ocrd: failed to initialize \"%s\"\n",
+                   options.langs.c_str());
+      return 1;
+    }
+    engines.Add(std::move(engine));
+  }
+
+  int listener = -1;
+  try {
+    listener = Listen(options.socket_path);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "tesseract-ocrd: %s\n", e.what());
+    return 1;
+  }
+  std::fprintf(stderr, "tesseract-ocrd: %u engine(s) for \"%s\" on %s\n",
+               options.engines, options.langs.c_str(),
+               options.socket_path.c_str());
+
+  const Server server{options, engines};
+  std::mutex connections_mutex;
+  std::condition_variable connections_done;
+  std::vector<int> connections;
+
+  while (!g_stop.load()) {
+    // Past the limit, leave new connections in the listen backlog until a
+    // thread is free; clients wait there within their own timeout.
+    {
+      std::unique_lock lock(connections_mutex);
+      if (!connections_done.wait_for(lock, std::chrono::milliseconds(250),
+                                     [&] {
+                                       return connections.size() <
+                                              options.max_connections;
+                                     })) {
+        continue; // look at g_stop again
+      }
+    }
+    pollfd pending{listener, POLLIN, 0};
+    if (::poll(&pending, 1, 250) <= 0) {
+      continue; // timeout or EINTR: look at g_stop again
+    }
+    const int fd = ::accept(listener, nullptr, nullptr);
+    if (fd < 0) {
+      continue;
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    {
+      std::scoped_lock lock(connections_mutex);
+      connections.push_back(fd);
+    }
+    std::thread([&, fd] {
+      server.Serve(fd);
+      // Close under the lock, so shutdown below never hits a reused fd, and
+      // notify under it too: once main sees the list empty it returns and
+      // destroys the condition variable.
+      std::scoped_lock lock(connections_mutex);
+      std::erase(connections, fd);
+      ::close(fd);
+      connections_done.notify_all();
+    }).detach();
+  }
+
+  // wake connections blocked in recv; requests in flight still finish
+  {
+    std::unique_lock lock(connections_mutex);
+    for (const int fd : connections) {
+      ::shutdown(fd, SHUT_RD);
+    }
+    connections_done.wait(lock, [&] { return connections.empty(); });
+  }
+
+  ::close(listener);
+  ::unlink(options.socket_path.c_str());
+  return 0;
+}
@@ -0,0 +1,741 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "daemon_client.hpp"
+#include "napi_utils.hpp"
+#include "results.hpp"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <tesseract/publictypes.h>
+#include <tuple>
+#include <utility>
+
+#ifndef _WIN32
+#include "daemon_protocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+// Connect plus reply, unless TesseractClient({ timeout }) says otherwise.
+constexpr int64_t kDefaultTimeoutMs = 60000;
+
+struct ResultDaemonInfo {
+  std::string version;
+  std::string langs;
+  int engines{0};
+
+  static constexpr auto Fields() {
+    using S = ResultDaemonInfo;
+    return std::tuple{
+        Field{"version", &S::version},
+        Field{"langs", &S::langs},
+        Field{"engines", &S::engines},
+    };
+  }
+};
+
+#ifndef _WIN32
+
+// Reads `{ outputs, psm, vars }` into `request`. Returns a rejected promise
+// if the options are invalid.
+std::optional<Napi::Value>
+ParseRecognizeOptions(const Napi::CallbackInfo &info, size_t index,
+                      const char *signature, const char *method,
+                      ocrd::RecognizeRequest &request) {
+  Napi::Env env = info.Env();
+  if (!HasArg(info, index)) {
+    return std::nullopt;
+  }
+  if (!info[index].IsObject()) {
+    return RejectTypeError(
+        env, std::format("{}: options must be an object", signature), method);
+  }
+  auto options = info[index].As<Napi::Object>();
+
+  const Napi::Value list = options.Get("outputs");
+  if (!list.IsUndefined()) {
+    if (!list.IsArray()) {
+      return RejectTypeError(
+          env, std::format("{}: options.outputs must be an array", signature),
+          method);
+    }
+    request.outputs = 0;
+    auto array = list.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); ++i) {
+      const Napi::Value item = array.Get(i);
+      const std::string output =
+          item.IsString() ? item.As<Napi::String>().Utf8Value() : "";
+      if (output == "text") {
+        request.outputs |= ocrd::kOutputText;
+      } else if (output == "hocr") {
+        request.outputs |= ocrd::kOutputHocr;
+      } else if (output == "tsv") {
+        request.outputs |= ocrd::kOutputTsv;
+      } else if (output == "alto") {
+        request.outputs |= ocrd::kOutputAlto;
+      } else {
+        return RejectTypeError(env,
+                               std::format("{}: options.outputs entries must "
+                                           "be \"text\", \"hocr\", \"tsv\" or "
+                                           "\"alto\"",
+                                           signature),
+                               method);
+      }
+    }
+  }
+
+  const Napi::Value mode = options.Get("psm");
+  if (!mode.IsUndefined()) {
+    if (!mode.IsNumber()) {
+      return RejectTypeError(
+          env, std::format("{}: options.psm must be a number", signature),
+          method);
+    }
+    request.psm = mode.As<Napi::Number>().Int32Value();
+    if (request.psm < 0 || request.psm >= tesseract::PSM_COUNT) {
+      return RejectRangeError(
+          env, std::format("{}: options.psm is out of range", signature),
+          method);
+    }
+  }
+
+  const Napi::Value vars = options.Get("vars");
+  if (!vars.IsUndefined()) {
+    if (!vars.IsObject()) {
+      return RejectTypeError(
+          env, std::format("{}: options.vars must be an object", signature),
+          method);
+    }
+    auto object = vars.As<Napi::Object>();
+    Napi::Array names = object.GetPropertyNames();
+    for (uint32_t i = 0; i < names.Length(); ++i) {
+      const Napi::Value name = names.Get(i);
+      const Napi::Value value = object.Get(name);
+      if (!name.IsString() || !value.IsString()) {
+        return RejectTypeError(
+            env,
+            std::format("{}: options.vars must contain only strings",
+                        signature),
+            method);
+      }
+      request.vars.emplace_back(name.As<Napi::String>().Utf8Value(),
+                                value.As<Napi::String>().Utf8Value());
+    }
+  }
+  return std::nullopt;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// One request/reply exchange with the daemon. Created on the JS thread,
+// driven by the client's I/O thread over a non-blocking socket, and handed
+// back to the JS thread to settle its promise.
+struct Exchange {
+  enum class Stage { Connect, Connecting, Send, Receive, Done };
+
+  Exchange(Napi::Env env, const char *method, ocrd::MessageType type,
+           ocrd::RecognizeRequest request,
+           std::optional<ocrd::SharedMemory> image)
+      : deferred(Napi::Promise::Deferred::New(env)), method(method),
+        type(type), request(std::move(request)), image(std::move(image)) {}
+  Exchange(const Exchange &) = delete;
+  Exchange &operator=(const Exchange &) = delete;
+  ~Exchange() { CloseSocket(); }
+
+  void CloseSocket() {
+    if (fd >= 0) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+
+  void Fail(const char *error_code, std::string_view message) {
+    code = error_code;
+    error = std::format("{}: {}", method, message);
+    stage = Stage::Done;
+  }
+
+  Napi::Promise::Deferred deferred;
+  const char *method;
+  ocrd::MessageType type;
+  ocrd::RecognizeRequest request;
+  std::optional<ocrd::SharedMemory> image;
+  std::optional<Clock::time_point> deadline;
+
+  Stage stage{Stage::Connect};
+  int fd{-1};
+  std::string out; // frame still to send, from `sent` on
+  size_t sent{0};
+  ocrd::FrameHeader header{};
+  size_t header_read{0};
+  std::string payload;
+  size_t payload_read{0};
+
+  std::string code; // empty on success
+  std::string error;
+  ResultDaemonInfo info{};
+  ResultRecognizedFile result{};
+};
+
+// Starts the connection. A listen backlog that is full leaves the exchange
+// in Stage::Connect, to be retried on the next turn of the loop.
+void Connect(Exchange &exchange, const std::string &socket_path) {
+  const sockaddr_un address = ocrd::SocketAddress(socket_path);
+  exchange.fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (exchange.fd < 0) {
+    throw ocrd::ProtocolError(
+        std::format("socket failed: {}", std::strerror(errno)));
+  }
+  ::fcntl(exchange.fd, F_SETFD, FD_CLOEXEC);
+  ::fcntl(exchange.fd, F_SETFL, ::fcntl(exchange.fd, F_GETFL) | O_NONBLOCK);
+
+  if (::connect(exchange.fd, reinterpret_cast<const sockaddr *>(&address),
+                sizeof(address)) == 0) {
+    exchange.stage = Exchange::Stage::Send;
+  } else if (errno == EINPROGRESS) {
+    exchange.stage = Exchange::Stage::Connecting;
+  } else if (errno == EAGAIN) {
+    exchange.CloseSocket();
+  } else {
+    throw ocrd::ProtocolError(std::format("cannot connect to \"{}\": {}",
+                                          socket_path, std::strerror(errno)));
+  }
+}
+
+// Reads what the socket has; returns false until `size` bytes are in.
+bool Receive(Exchange &exchange, char *data, size_t size, size_t &done) {
+  while (done < size) {
+    const ssize_t got = ::recv(exchange.fd, data + done, size - done, 0);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return false;
+    }
+    if (got == 0) {
+      throw ocrd::ProtocolError("the daemon closed the connection");
+    }
+    if (got < 0) {
+      throw ocrd::ProtocolError(
+          std::format("read failed: {}", std::strerror(errno)));
+    }
+    done += static_cast<size_t>(got);
+  }
+  return true;
+}
+
+void DecodeReply(Exchange &exchange) {
+  switch (static_cast<ocrd::MessageType>(exchange.header.type)) {
+  case ocrd::MessageType::InfoResult: {
+    const auto info = ocrd::InfoResponse::Decode(exchange.payload);
+    exchange.info = {info.version, info.langs, static_cast<int>(info.engines)};
+    break;
+  }
+  case ocrd::MessageType::RecognizeResult: {
+    auto page = ocrd::RecognizeResponse::Decode(exchange.payload);
+    exchange.result = {exchange.request.path, page.width,
+                       page.height,           page.mean_confidence,
+                       std::move(page.text),  std::move(page.hocr),
+                       std::move(page.tsv),   std::move(page.alto)};
+    break;
+  }
+  case ocrd::MessageType::Error: {
+    const auto error = ocrd::ErrorResponse::Decode(exchange.payload);
+    exchange.code = error.code;
+    exchange.error = error.message;
+    break;
+  }
+  default:
+    throw ocrd::ProtocolError("unexpected reply from the daemon");
+  }
+  exchange.stage = Exchange::Stage::Done;
+}
+
+// Moves the exchange on as far as the socket allows without blocking.
+void Advance(Exchange &exchange, const std::string &socket_path) {
+  try {
+    if (exchange.stage == Exchange::Stage::Connect) {
+      Connect(exchange, socket_path);
+      return; // wait for the socket to become writable
+    }
+    if (exchange.stage == Exchange::Stage::Connecting) {
+      int error = 0;
+      socklen_t length = sizeof(error);
+      ::getsockopt(exchange.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+      if (error != 0) {
+        throw ocrd::ProtocolError(std::format("cannot connect to \"{}\": {}",
+                                              socket_path,
+                                              std::strerror(error)));
+      }
+      exchange.stage = Exchange::Stage::Send;
+    }
+    if (exchange.stage == Exchange::Stage::Send) {
+      while (exchange.sent < exchange.out.size()) {
+        const ssize_t written =
+            ::send(exchange.fd, exchange.out.data() + exchange.sent,
+                   exchange.out.size() - exchange.sent, ocrd::kSendFlags);
+        if (written < 0 && errno == EINTR) {
+          continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          return;
+        }
+        if (written <= 0) {
+          throw ocrd::ProtocolError(
+              std::format("write failed: {}", std::strerror(errno)));
+        }
+        exchange.sent += static_cast<size_t>(written);
+      }
+      exchange.out = {};
+      exchange.stage = Exchange::Stage::Receive;
+    }
+    if (exchange.stage == Exchange::Stage::Receive) {
+      if (exchange.header_read < sizeof(exchange.header)) {
+        if (!Receive(exchange, reinterpret_cast<char *>(&exchange.header),
+                     sizeof(exchange.header), exchange.header_read)) {
+          return;
+        }
+        ocrd::CheckFrameHeader(exchange.header);
+        exchange.payload.resize(exchange.header.size);
+      }
+      if (!Receive(exchange, exchange.payload.data(), exchange.payload.size(),
+                   exchange.payload_read)) {
+        return;
+      }
+      DecodeReply(exchange);
+    }
+  } catch (const ocrd::ProtocolError &e) {
+    exchange.Fail("ERR_DAEMON_UNAVAILABLE", e.what());
+  } catch (const std::exception &e) {
+    exchange.Fail("ERR_TESSERACT_RUNTIME", e.what());
+  }
+}
+
+#else
+
+Napi::Value RejectUnsupported(Napi::Env env, const char *method) {
+  const std::string message =
+      std::format("{}: tesseract-ocrd is only available on Unix", method);
+  return RejectWithError(env, Napi::Error::New(env, message),
+                         "ERR_DAEMON_UNAVAILABLE", message, method);
+}
+
+#endif
+
+} // namespace
+
+#ifndef _WIN32
+
+// I/O thread of one TesseractClient. Its exchanges are multiplexed with
+// poll(), so requests that wait on the daemon hold no libuv pool thread,
+// and each one is failed with ERR_DAEMON_TIMEOUT once its deadline passes.
+// Finished exchanges are settled on the JS thread. The thread starts with
+// the first request and ends once the client is collected and nothing is in
+// flight; it keeps the event loop alive only while requests are pending.
+class DaemonLoop : public std::enable_shared_from_this<DaemonLoop> {
+public:
+  DaemonLoop(Napi::Env env, std::string socket_path, int64_t timeout_ms)
+      : _socket_path(std::move(socket_path)), _timeout_ms(timeout_ms) {
+    _settle = Napi::ThreadSafeFunction::New(
+        env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}),
+        "tesseract_daemon_client", 0, 1);
+    _settle.Unref(env);
+    if (::pipe(_wake) != 0) {
+      _wake[0] = _wake[1] = -1;
+      return;
+    }
+    for (const int fd : _wake) {
+      ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+      ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+  }
+
+  ~DaemonLoop() {
+    for (const int fd : _wake) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  // JS thread
+  Napi::Promise Submit(Napi::Env env, std::unique_ptr<Exchange> exchange) {
+    Napi::Promise promise = exchange->deferred.Promise();
+    if (_wake[0] < 0) {
+      exchange->Fail("ERR_TESSERACT_RUNTIME", "cannot create a wakeup pipe");
+      Settle(env, *exchange);
+      return promise;
+    }
+    exchange->out = EncodeRequest(*exchange);
+    if (_timeout_ms > 0) {
+      exchange->deadline =
+          Clock::now() + std::chrono::milliseconds(_timeout_ms);
+    }
+    if (_pending++ == 0) {
+      _settle.Ref(env);
+    }
+    {
+      std::scoped_lock lock(_mutex);
+      _incoming.push_back(std::move(exchange));
+      if (!_started) {
+        _started = true;
+        std::thread([self = shared_from_this()] { self->Run(); }).detach();
+      }
+    }
+    Wake();
+    return promise;
+  }
+
+  // JS thread, from the client's finalizer
+  void Close() {
+    bool started = false;
+    {
+      std::scoped_lock lock(_mutex);
+      _closing = true;
+      started = _started;
+    }
+    if (started) {
+      Wake();
+    } else {
+      _settle.Release();
+    }
+  }
+
+private:
+  static std::string EncodeRequest(const Exchange &exchange) {
+    const std::string payload = exchange.type == ocrd::MessageType::Recognize
+                                    ? exchange.request.Encode()
+                                    : std::string{};
+    const ocrd::FrameHeader header =
+        ocrd::MakeFrameHeader(exchange.type, payload.size());
+    std::string frame(reinterpret_cast<const char *>(&header), sizeof(header));
+    frame += payload;
+    return frame;
+  }
+
+  void Wake() {
+    const char byte = 0;
+    while (::write(_wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+  }
+
+  void Run() {
+    std::vector<std::unique_ptr<Exchange>> active;
+    std::vector<pollfd> fds;
+    while (true) {
+      {
+        std::scoped_lock lock(_mutex);
+        for (auto &exchange : _incoming) {
+          active.push_back(std::move(exchange));
+        }
+        _incoming.clear();
+        if (_closing && active.empty()) {
+          break;
+        }
+      }
+
+      fds.assign(1, pollfd{_wake[0], POLLIN, 0});
+      int timeout = -1;
+      const auto now = Clock::now();
+      for (auto &exchange : active) {
+        if (exchange->stage == Exchange::Stage::Connect) {
+          Advance(*exchange, _socket_path);
+        }
+        short events = 0;
+        switch (exchange->stage) {
+        case Exchange::Stage::Connect:
+          timeout = 10; // the backlog was full: try again shortly
+          break;
+        case Exchange::Stage::Connecting:
+        case Exchange::Stage::Send:
+          events = POLLOUT;
+          break;
+        case Exchange::Stage::Receive:
+          events = POLLIN;
+          break;
+        case Exchange::Stage::Done:
+          timeout = 0;
+          break;
+        }
+        fds.push_back(pollfd{events != 0 ? exchange->fd : -1, events, 0});
+        if (exchange->deadline) {
+          using std::chrono::milliseconds;
+          const int64_t left =
+              std::chrono::ceil<milliseconds>(*exchange->deadline - now)
+                  .count();
+          const int wait = static_cast<int>(std::clamp<int64_t>(
+              left, 0, std::numeric_limits<int>::max()));
+          timeout = timeout < 0 ? wait : std::min(timeout, wait);
+        }
+      }
+
+      if (::poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+        fds.assign(fds.size(), pollfd{-1, 0, 0});
+      }
+      if (fds[0].revents != 0) {
+        char drain[64];
+        while (::read(_wake[0], drain, sizeof(drain)) > 0) {
+        }
+      }
+
+      const auto after = Clock::now();
+      for (size_t i = 0; i < active.size(); ++i) {
+        Exchange &exchange = *active[i];
+        if (fds[i + 1].revents != 0) {
+          Advance(exchange, _socket_path);
+        }
+        if (exchange.stage != Exchange::Stage::Done && exchange.deadline &&
+            after >= *exchange.deadline) {
+          exchange.Fail("ERR_DAEMON_TIMEOUT",
+                        std::format("no reply from the daemon within {} ms",
+                                    _timeout_ms));
+        }
+      }
+
+      std::erase_if(active, [&](std::unique_ptr<Exchange> &exchange) {
+        if (exchange->stage != Exchange::Stage::Done) {
+          return false;
+        }
+        Deliver(std::move(exchange));
+        return true;
+      });
+    }
+    _settle.Release();
+  }
+
+  void Deliver(std::unique_ptr<Exchange> exchange) {
+    exchange->CloseSocket();
+    exchange->image.reset(); // the daemon is done with it: unmap and unlink
+    std::shared_ptr<Exchange> done{std::move(exchange)};
+    // fails only while the environment shuts down; the exchange is dropped
+    _settle.NonBlockingCall(
+        [self = shared_from_this(), done](Napi::Env env, Napi::Function) {
+          self->Settle(env, *done);
+          if (--self->_pending == 0) {
+            self->_settle.Unref(env);
+          }
+        });
+  }
+
+  // JS thread
+  void Settle(Napi::Env env, Exchange &exchange) {
+    if (!exchange.code.empty()) {
+      Napi::Error error = Napi::Error::New(env, exchange.error);
+      error.Set("code", Napi::String::New(env, exchange.code));
+      error.Set("method", Napi::String::New(env, exchange.method));
+      exchange.deferred.Reject(error.Value());
+    } else if (exchange.type == ocrd::MessageType::Info) {
+      exchange.deferred.Resolve(ToNapiValue(env, exchange.info));
+    } else {
+      exchange.deferred.Resolve(ToNapiValue(env, exchange.result));
+    }
+  }
+
+  const std::string _socket_path;
+  const int64_t _timeout_ms; // 0 = no deadline
+  Napi::ThreadSafeFunction _settle;
+  int _wake[2]{-1, -1};
+  size_t _pending{0}; // JS thread only
+
+  std::mutex _mutex;
+  std::vector<std::unique_ptr<Exchange>> _incoming;
+  bool _started{false};
+  bool _closing{false};
+};
+
+#endif
+
+Napi::Object DaemonClient::InitAddon(Napi::Env env, Napi::Object exports) {
+  Napi::Function func = DefineClass(
+      env, "TesseractClient",
+      {
+          InstanceMethod("info", &DaemonClient::Info),
+          InstanceMethod("recognize", &DaemonClient::Recognize),
+          InstanceMethod("recognizeFile", &DaemonClient::RecognizeFile),
+      });
+
+  exports.Set("TesseractClient", func);
+  return exports;
+}
+
+DaemonClient::DaemonClient(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<DaemonClient>(info) {
+  Napi::Env env = info.Env();
+  const bool has_options = info.Length() == 1 && info[0].IsObject();
+  const Napi::Value socket_path =
+      has_options ? info[0].As<Napi::Object>().Get("socketPath")
+                  : env.Undefined();
+  if (!socket_path.IsString() ||
+      socket_path.As<Napi::String>().Utf8Value().empty()) {
+    Napi::Error error = Napi::TypeError::New(
+        env, "TesseractClient(options): options.socketPath must be a "
+             "non-empty string");
+    error.Set("code", Napi::String::New(env, "ERR_INVALID_ARGUMENT"));
+    error.Set("method", Napi::String::New(env, "constructor"));
+    error.ThrowAsJavaScriptException();
+    return;
+  }
+  _socket_path = socket_path.As<Napi::String>().Utf8Value();
+
+  int64_t timeout_ms = kDefaultTimeoutMs;
+  const Napi::Value timeout = info[0].As<Napi::Object>().Get("timeout");
+  if (!timeout.IsUndefined()) {
+    const double value =
+        timeout.IsNumber() ? timeout.As<Napi::Number>().DoubleValue() : -1;
+    if (!(value >= 0 && value <= 2147483647) ||
+        value != static_cast<double>(static_cast<int64_t>(value))) {
+      Napi::Error error = Napi::RangeError::New(
+          env, "TesseractClient(options): options.timeout must be an "
+               "integer number of milliseconds between 0 and 2147483647");
+      error.Set("code", Napi::String::New(env, "ERR_OUT_OF_RANGE"));
+      error.Set("method", Napi::String::New(env, "constructor"));
+      error.ThrowAsJavaScriptException();
+      return;
+    }
+    timeout_ms = static_cast<int64_t>(value);
+  }
+
+#ifndef _WIN32
+  _loop = std::make_shared<DaemonLoop>(env, _socket_path, timeout_ms);
+#else
+  static_cast<void>(timeout_ms);
+#endif
+}
+
+DaemonClient::~DaemonClient() {
+#ifndef _WIN32
+  if (_loop != nullptr) {
+    _loop->Close();
+  }
+#endif
+}
+
+Napi::Value DaemonClient::Info(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+#ifdef _WIN32
+  return RejectUnsupported(env, "info");
+#else
+  if (info.Length() > 0) {
+    return RejectTypeError(env, "info(): expected no arguments", "info");
+  }
+
+  return _loop->Submit(
+      env, std::make_unique<Exchange>(env, "info", ocrd::MessageType::Info,
+                                      ocrd::RecognizeRequest{}, std::nullopt));
+#endif
+}
+
+Napi::Value DaemonClient::Recognize(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+#ifdef _WIN32
+  return RejectUnsupported(env, "recognize");
+#else
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsBuffer()) {
+    return RejectTypeError(
+        env, "recognize(buffer, options?): buffer must be a Buffer",
+        "recognize");
+  }
+  Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+  if (buffer.Length() == 0) {
+    return RejectTypeError(env, "recognize(buffer, options?): buffer is empty",
+                           "recognize");
+  }
+
+  ocrd::RecognizeRequest request{};
+  if (auto rejected = ParseRecognizeOptions(
+          info, 1, "recognize(buffer, options?)", "recognize", request)) {
+    return *rejected;
+  }
+
+  // The only copy of the image: from the JS heap straight into the segment
+  // the daemon maps.
+  std::optional<ocrd::SharedMemory> image;
+  try {
+    image.emplace(ocrd::SharedMemory::Create(buffer.Length()));
+  } catch (const std::exception &e) {
+    return RejectError(env, std::format("recognize: {}", e.what()),
+                       "recognize");
+  }
+  std::memcpy(image->Data(), buffer.Data(), buffer.Length());
+
+  request.shm_name = image->Name();
+  request.shm_size = image->Size();
+  return _loop->Submit(env, std::make_unique<Exchange>(
+                                env, "recognize", ocrd::MessageType::Recognize,
+                                std::move(request), std::move(image)));
+#endif
+}
+
+Napi::Value DaemonClient::RecognizeFile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+#ifdef _WIN32
+  return RejectUnsupported(env, "recognizeFile");
+#else
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsString()) {
+    return RejectTypeError(
+        env, "recognizeFile(path, options?): path must be a string",
+        "recognizeFile");
+  }
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  if (path.empty()) {
+    return RejectTypeError(env, "recognizeFile(path, options?): path is empty",
+                           "recognizeFile");
+  }
+
+  ocrd::RecognizeRequest request{};
+  if (auto rejected =
+          ParseRecognizeOptions(info, 1, "recognizeFile(path, options?)",
+                                "recognizeFile", request)) {
+    return *rejected;
+  }
+
+  // The daemon reads the file itself; nothing crosses the socket but the
+  // path. It runs in a directory of its own, so resolve relative paths here.
+  std::error_code ec;
+  std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+  if (ec) {
+    return RejectError(env,
+                       std::format("recognizeFile: cannot resolve \"{}\": {}",
+                                   path, ec.message()),
+                       "recognizeFile");
+  }
+  request.path = absolute.string();
+  return _loop->Submit(
+      env, std::make_unique<Exchange>(env, "recognizeFile",
+                                      ocrd::MessageType::Recognize,
+                                      std::move(request), std::nullopt));
+#endif
+}
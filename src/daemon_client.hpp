@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <napi.h>
+#include <string>
+
+class DaemonLoop;
+
+// Thin client for tesseract-ocrd. It owns no engine: requests are sent to
+// the daemon's socket from an I/O thread of the client's own, images are
+// handed over in shared memory, and each request resolves with the daemon's
+// reply or rejects once the client's timeout passes. Unix only; elsewhere
+// every request rejects with ERR_DAEMON_UNAVAILABLE.
+class DaemonClient : public Napi::ObjectWrap<DaemonClient> {
+public:
+  static Napi::Object InitAddon(Napi::Env env, Napi::Object exports);
+
+  explicit DaemonClient(const Napi::CallbackInfo &info);
+  ~DaemonClient();
+
+private:
+  Napi::Value Info(const Napi::CallbackInfo &info);
+  Napi::Value Recognize(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeFile(const Napi::CallbackInfo &info);
+
+  std::string _socket_path;
+  std::shared_ptr<DaemonLoop> _loop; // null on Windows
+};
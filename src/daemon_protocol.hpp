@@ -0,0 +1,430 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+// Wire protocol between tesseract-ocrd (src/daemon) and the addon's
+// TesseractClient. Shared by both sides, so it must not depend on N-API.
+//
+// Every message is a FrameHeader followed by `size` payload bytes, sent over
+// a Unix domain stream socket. Images are not sent over the socket: the
+// client writes them into a POSIX shared memory object and sends its name.
+// Both sides run on the same host, so integers are in native byte order.
+
+#include "utils.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace ocrd {
+
+inline constexpr uint32_t kMagic = 0x4452434f; // "OCRD"
+inline constexpr uint16_t kVersion = 2;
+inline constexpr uint32_t kMaxFrameSize = 256u << 20;
+
+enum class MessageType : uint16_t {
+  Info = 1,      // client -> daemon, empty payload
+  Recognize = 2, // client -> daemon, RecognizeRequest
+  InfoResult = 3,
+  RecognizeResult = 4,
+  Error = 5,
+};
+
+// Outputs rendered for a Recognize request.
+enum Output : uint32_t {
+  kOutputText = 1u << 0,
+  kOutputHocr = 1u << 1,
+  kOutputTsv = 1u << 2,
+  kOutputAlto = 1u << 3,
+};
+
+struct FrameHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t type;
+  uint32_t size;
+};
+
+// Broken connections and malformed frames; the connection is dropped.
+class ProtocolError : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+class PayloadWriter {
+public:
+  void U32(uint32_t value) { Raw(&value, sizeof(value)); }
+  void I32(int32_t value) { Raw(&value, sizeof(value)); }
+  void U64(uint64_t value) { Raw(&value, sizeof(value)); }
+  void String(std::string_view value) {
+    U32(static_cast<uint32_t>(value.size()));
+    Raw(value.data(), value.size());
+  }
+
+  const std::string &Data() const { return _data; }
+
+private:
+  void Raw(const void *data, size_t size) {
+    _data.append(static_cast<const char *>(data), size);
+  }
+
+  std::string _data;
+};
+
+class PayloadReader {
+public:
+  explicit PayloadReader(std::string_view data) : _data(data) {}
+
+  uint32_t U32() { return Raw<uint32_t>(); }
+  int32_t I32() { return Raw<int32_t>(); }
+  uint64_t U64() { return Raw<uint64_t>(); }
+  std::string String() {
+    const uint32_t size = U32();
+    if (size > _data.size()) {
+      throw ProtocolError("truncated string in payload");
+    }
+    std::string value{_data.substr(0, size)};
+    _data.remove_prefix(size);
+    return value;
+  }
+
+private:
+  template <typename T> T Raw() {
+    if (sizeof(T) > _data.size()) {
+      throw ProtocolError("truncated payload");
+    }
+    T value;
+    std::memcpy(&value, _data.data(), sizeof(T));
+    _data.remove_prefix(sizeof(T));
+    return value;
+  }
+
+  std::string_view _data;
+};
+
+struct RecognizeRequest {
+  // image source: a shared memory object, or a path the daemon reads
+  std::string shm_name;
+  uint64_t shm_size{0};
+  std::string path;
+  uint32_t outputs{kOutputText};
+  int32_t psm{-1}; // -1 keeps the daemon's page segmentation mode
+  // set for this request only, on whichever engine serves it
+  std::vector<std::pair<std::string, std::string>> vars;
+
+  std::string Encode() const {
+    PayloadWriter writer;
+    writer.String(shm_name);
+    writer.U64(shm_size);
+    writer.String(path);
+    writer.U32(outputs);
+    writer.I32(psm);
+    writer.U32(static_cast<uint32_t>(vars.size()));
+    for (const auto &[name, value] : vars) {
+      writer.String(name);
+      writer.String(value);
+    }
+    return writer.Data();
+  }
+  static RecognizeRequest Decode(std::string_view payload) {
+    PayloadReader reader{payload};
+    RecognizeRequest request;
+    request.shm_name = reader.String();
+    request.shm_size = reader.U64();
+    request.path = reader.String();
+    request.outputs = reader.U32();
+    request.psm = reader.I32();
+    const uint32_t count = reader.U32();
+    for (uint32_t i = 0; i < count; ++i) {
+      std::string name = reader.String();
+      request.vars.emplace_back(std::move(name), reader.String());
+    }
+    return request;
+  }
+};
+
+struct RecognizeResponse {
+  int32_t width{0};
+  int32_t height{0};
+  int32_t mean_confidence{0};
+  std::string text;
+  std::string hocr;
+  std::string tsv;
+  std::string alto;
+
+  std::string Encode() const {
+    PayloadWriter writer;
+    writer.I32(width);
+    writer.I32(height);
+    writer.I32(mean_confidence);
+    writer.String(text);
+    writer.String(hocr);
+    writer.String(tsv);
+    writer.String(alto);
+    return writer.Data();
+  }
+  static RecognizeResponse Decode(std::string_view payload) {
+    PayloadReader reader{payload};
+    RecognizeResponse response;
+    response.width = reader.I32();
+    response.height = reader.I32();
+    response.mean_confidence = reader.I32();
+    response.text = reader.String();
+    response.hocr = reader.String();
+    response.tsv = reader.String();
+    response.alto = reader.String();
+    return response;
+  }
+};
+
+struct InfoResponse {
+  std::string version; // libtesseract
+  std::string langs;
+  uint32_t engines{0};
+
+  std::string Encode() const {
+    PayloadWriter writer;
+    writer.String(version);
+    writer.String(langs);
+    writer.U32(engines);
+    return writer.Data();
+  }
+  static InfoResponse Decode(std::string_view payload) {
+    PayloadReader reader{payload};
+    InfoResponse response;
+    response.version = reader.String();
+    response.langs = reader.String();
+    response.engines = reader.U32();
+    return response;
+  }
+};
+
+// Error codes are the addon's (ERR_TESSERACT_RUNTIME, ERR_IMAGE_LIMIT, ...).
+struct ErrorResponse {
+  std::string code;
+  std::string message;
+
+  std::string Encode() const {
+    PayloadWriter writer;
+    writer.String(code);
+    writer.String(message);
+    return writer.Data();
+  }
+  static ErrorResponse Decode(std::string_view payload) {
+    PayloadReader reader{payload};
+    ErrorResponse response;
+    response.code = reader.String();
+    response.message = reader.String();
+    return response;
+  }
+};
+
+#ifdef MSG_NOSIGNAL
+inline constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+inline constexpr int kSendFlags = 0; // macOS: SIGPIPE is ignored instead
+#endif
+
+inline void WriteAll(int fd, const void *data, size_t size) {
+  const auto *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    const ssize_t written = ::send(fd, bytes, size, kSendFlags);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      throw ProtocolError(
+          std::format("write failed: {}", std::strerror(errno)));
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+// Returns false on a clean end of stream before the first byte.
+inline bool ReadAll(int fd, void *data, size_t size) {
+  auto *bytes = static_cast<char *>(data);
+  size_t done = 0;
+  while (done < size) {
+    const ssize_t got = ::recv(fd, bytes + done, size - done, 0);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got == 0 && done == 0) {
+      return false;
+    }
+    if (got <= 0) {
+      throw ProtocolError("connection closed mid-frame");
+    }
+    done += static_cast<size_t>(got);
+  }
+  return true;
+}
+
+inline FrameHeader MakeFrameHeader(MessageType type, size_t size) {
+  return {kMagic, kVersion, static_cast<uint16_t>(type),
+          static_cast<uint32_t>(size)};
+}
+
+// Throws if `header` does not start a frame of this protocol.
+inline void CheckFrameHeader(const FrameHeader &header) {
+  if (header.magic != kMagic || header.version != kVersion) {
+    throw ProtocolError("peer speaks a different protocol version");
+  }
+  if (header.size > kMaxFrameSize) {
+    throw ProtocolError(std::format("frame of {} bytes is too large",
+                                    header.size));
+  }
+}
+
+inline void SendFrame(int fd, MessageType type, const std::string &payload) {
+  const FrameHeader header = MakeFrameHeader(type, payload.size());
+  WriteAll(fd, &header, sizeof(header));
+  WriteAll(fd, payload.data(), payload.size());
+}
+
+// Returns false if the peer closed the connection between frames.
+inline bool ReadFrame(int fd, MessageType &type, std::string &payload) {
+  FrameHeader header{};
+  if (!ReadAll(fd, &header, sizeof(header))) {
+    return false;
+  }
+  CheckFrameHeader(header);
+  type = static_cast<MessageType>(header.type);
+  payload.resize(header.size);
+  if (header.size > 0 && !ReadAll(fd, payload.data(), header.size)) {
+    throw ProtocolError("connection closed mid-frame");
+  }
+  return true;
+}
+
+// Sets up a sockaddr_un for `path`; throws if the path does not fit.
+inline sockaddr_un SocketAddress(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    throw_runtime("socket path \"{}\" is empty or too long", path);
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return address;
+}
+
+// POSIX shared memory object holding one encoded image. The client creates
+// and unlinks it; the daemon only maps it read-only for the duration of a
+// request. Objects are created with mode 0600, so client and daemon must
+// run as the same user.
+class SharedMemory {
+public:
+  static SharedMemory Create(size_t size) {
+    static std::atomic<uint32_t> counter{0};
+    SharedMemory shm;
+    shm._name = std::format("/node-tesseract-{}-{}", ::getpid(),
+                            counter.fetch_add(1, std::memory_order_relaxed));
+    shm._owner = true;
+    shm._size = size;
+
+    const int fd =
+        ::shm_open(shm._name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      throw_runtime("shm_open failed: {}", std::strerror(errno));
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      const int error = errno;
+      ::close(fd);
+      ::shm_unlink(shm._name.c_str());
+      throw_runtime("ftruncate failed: {}", std::strerror(error));
+    }
+    shm.Map(fd, PROT_READ | PROT_WRITE);
+    return shm;
+  }
+
+  // Throws if the object is missing or smaller than `size`.
+  static SharedMemory Open(const std::string &name, size_t size) {
+    SharedMemory shm;
+    shm._name = name;
+    shm._size = size;
+
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      throw_runtime("cannot open shared memory \"{}\": {}", name,
+                    std::strerror(errno));
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size) {
+      ::close(fd);
+      throw_runtime("shared memory \"{}\" is smaller than {} bytes", name,
+                    size);
+    }
+    shm.Map(fd, PROT_READ);
+    return shm;
+  }
+
+  SharedMemory(SharedMemory &&other) noexcept
+      : _name(std::move(other._name)),
+        _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0)),
+        _owner(std::exchange(other._owner, false)) {}
+  SharedMemory &operator=(SharedMemory &&) = delete;
+  ~SharedMemory() {
+    if (_data != nullptr) {
+      ::munmap(_data, _size);
+    }
+    if (_owner) {
+      ::shm_unlink(_name.c_str());
+    }
+  }
+
+  const std::string &Name() const { return _name; }
+  uint8_t *Data() const { return static_cast<uint8_t *>(_data); }
+  size_t Size() const { return _size; }
+
+private:
+  SharedMemory() = default;
+
+  void Map(int fd, int protection) {
+    void *data = ::mmap(nullptr, _size, protection, MAP_SHARED, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      if (_owner) {
+        ::shm_unlink(_name.c_str());
+        _owner = false;
+      }
+      throw_runtime("mmap of shared memory failed: {}", std::strerror(error));
+    }
+    _data = data;
+  }
+
+  std::string _name;
+  void *_data{nullptr};
+  size_t _size{0};
+  bool _owner{false};
+};
+
+} // namespace ocrd
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Change tracking for recognizeFrame. Consecutive frames of a screen
+// recording are mostly identical, so every frame is compared with the
+// previous one tile by tile, and only the areas around changed tiles are
+// recognized again. Text lines found earlier are kept until a change
+// touches them.
+
+struct FrameRect {
+  int left{0};
+  int top{0};
+  int right{0}; // exclusive
+  int bottom{0};
+
+  bool Intersects(const FrameRect &other) const {
+    return left < other.right && other.left < right && top < other.bottom &&
+           other.top < bottom;
+  }
+  void Unite(const FrameRect &other) {
+    left = std::min(left, other.left);
+    top = std::min(top, other.top);
+    right = std::max(right, other.right);
+    bottom = std::max(bottom, other.bottom);
+  }
+};
+
+// A text line recognized in an earlier frame and unchanged since.
+struct FrameLine {
+  int id{0};
+  FrameRect box;
+  std::string text;
+  float confidence{0.0f};
+};
+
+// Per-worker state of the stream; recognizeFrame's `reset` and any change
+// of frame geometry start it over.
+struct FrameStream {
+  int width{0};
+  int height{0};
+  int bytes_per_pixel{0};
+  int tile_size{0};
+  std::vector<uint8_t> previous; // packed rows, empty before the 1st frame
+  std::vector<FrameLine> lines;  // in reading order
+  int next_line_id{1};
+  int64_t frames{0};
+  std::vector<int> unreported; // removed ids a failed frame could not report
+
+  bool Matches(int frame_width, int frame_height, int frame_bytes_per_pixel,
+               int frame_tile_size) const {
+    return width == frame_width && height == frame_height &&
+           bytes_per_pixel == frame_bytes_per_pixel &&
+           tile_size == frame_tile_size;
+  }
+
+  // Returns the ids of the dropped lines. Line ids keep counting up, so ids
+  // of an earlier run are never reused.
+  std::vector<int> Restart(int frame_width, int frame_height,
+                           int frame_bytes_per_pixel, int frame_tile_size) {
+    width = frame_width;
+    height = frame_height;
+    bytes_per_pixel = frame_bytes_per_pixel;
+    tile_size = frame_tile_size;
+    previous.clear();
+    std::vector<int> dropped;
+    dropped.reserve(lines.size());
+    for (const FrameLine &line : lines) {
+      dropped.push_back(line.id);
+    }
+    lines.clear();
+    return dropped;
+  }
+};
+
+// Compares `frame` with the stream's previous frame and stores it as the
+// new previous one, in a single pass over the rows. Returns one flag per
+// tile, row-major; every tile is changed if there is no previous frame.
+// A tile's remaining rows are skipped once it is known to have changed,
+// and memcmp does the vectorized compare of each row segment.
+inline std::vector<uint8_t> DiffFrameTiles(FrameStream &stream,
+                                           const uint8_t *frame,
+                                           size_t bytes_per_line) {
+  const int tile = stream.tile_size;
+  const int columns = (stream.width + tile - 1) / tile;
+  const int rows = (stream.height + tile - 1) / tile;
+  const size_t row_bytes =
+      static_cast<size_t>(stream.width) * stream.bytes_per_pixel;
+  const size_t tile_bytes = static_cast<size_t>(tile) * stream.bytes_per_pixel;
+
+  const bool first = stream.previous.empty();
+  if (first) {
+    stream.previous.resize(row_bytes * stream.height);
+  }
+  std::vector<uint8_t> changed(static_cast<size_t>(columns) * rows, first);
+
+  for (int y = 0; y < stream.height; ++y) {
+    const uint8_t *source = frame + bytes_per_line * y;
+    uint8_t *kept = stream.previous.data() + row_bytes * y;
+    if (!first) {
+      uint8_t *flags = changed.data() + static_cast<size_t>(y / tile) * columns;
+      for (int column = 0; column < columns; ++column) {
+        if (flags[column]) {
+          continue;
+        }
+        const size_t offset = tile_bytes * column;
+        const size_t size = std::min(tile_bytes, row_bytes - offset);
+        flags[column] = std::memcmp(source + offset, kept + offset, size) != 0;
+      }
+    }
+    std::memcpy(kept, source, row_bytes);
+  }
+  return changed;
+}
+
+// Groups changed tiles that touch, including diagonally, into rectangles
+// grown by one tile on every side, so text next to a change is read in
+// context rather than cut at a tile edge.
+inline std::vector<FrameRect>
+ChangedFrameRects(const FrameStream &stream,
+                  const std::vector<uint8_t> &changed) {
+  const int tile = stream.tile_size;
+  const int columns = (stream.width + tile - 1) / tile;
+  const int rows = (stream.height + tile - 1) / tile;
+
+  std::vector<uint8_t> seen(changed.size(), 0);
+  std::vector<int> pending;
+  std::vector<FrameRect> rects;
+  for (int start = 0; start < columns * rows; ++start) {
+    if (!changed[start] || seen[start]) {
+      continue;
+    }
+    // bounds in tiles, inclusive
+    FrameRect tiles{start % columns, start / columns, start % columns,
+                    start / columns};
+    seen[start] = 1;
+    pending.push_back(start);
+    while (!pending.empty()) {
+      const int index = pending.back();
+      pending.pop_back();
+      const int column = index % columns;
+      const int row = index / columns;
+      tiles.Unite({column, row, column, row});
+      for (int y = std::max(row - 1, 0); y <= std::min(row + 1, rows - 1);
+           ++y) {
+        for (int x = std::max(column - 1, 0);
+             x <= std::min(column + 1, columns - 1); ++x) {
+          const int next = y * columns + x;
+          if (changed[next] && !seen[next]) {
+            seen[next] = 1;
+            pending.push_back(next);
+          }
+        }
+      }
+    }
+    rects.push_back({std::max(tiles.left - 1, 0) * tile,
+                     std::max(tiles.top - 1, 0) * tile,
+                     std::min((tiles.right + 2) * tile, stream.width),
+                     std::min((tiles.bottom + 2) * tile, stream.height)});
+  }
+  return rects;
+}
+
+// Merges overlapping rectangles and grows them over every cached line they
+// touch, until neither changes anything, then drops those lines from the
+// stream. The rectangles are recognized afresh, so each returned id's line
+// is either read again or gone. Returns the ids of the dropped lines.
+inline std::vector<int> InvalidateFrameLines(std::vector<FrameRect> &rects,
+                                             FrameStream &stream) {
+  std::vector<int> dropped;
+  bool grown = true;
+  while (grown) {
+    grown = false;
+    for (size_t i = 0; i < rects.size(); ++i) {
+      for (size_t j = i + 1; j < rects.size();) {
+        if (rects[i].Intersects(rects[j])) {
+          rects[i].Unite(rects[j]);
+          rects.erase(rects.begin() + static_cast<std::ptrdiff_t>(j));
+          grown = true;
+        } else {
+          ++j;
+        }
+      }
+    }
+    std::erase_if(stream.lines, [&](const FrameLine &line) {
+      for (FrameRect &rect : rects) {
+        if (rect.Intersects(line.box)) {
+          rect.Unite(line.box);
+          dropped.push_back(line.id);
+          grown = true;
+          return true;
+        }
+      }
+      return false;
+    });
+  }
+  std::sort(dropped.begin(), dropped.end());
+  return dropped;
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "tracer.hpp"
+#include "utils.hpp"
+#include <allheaders.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <initializer_list>
+#include <stdexcept>
+
+// Decoded raster size above which an encoded image is refused by default.
+// Large enough for any sane scan (an A0 page at 300 dpi is ~450 MiB at
+// 32 bpp), small enough that one crafted file cannot exhaust the process.
+inline constexpr int64_t kDefaultMaxImageBytes = int64_t{1} << 30;
+
+// Limits checked against the image header before anything is decoded.
+// 0 disables a limit.
+struct ImageLimits {
+  int64_t max_width{0};
+  int64_t max_height{0};
+  int64_t max_pixels{0};
+  int64_t max_bytes{kDefaultMaxImageBytes};
+  int64_t max_pages{0};
+
+  // Decode oversized JPEGs at 1/2, 1/4 or 1/8 scale (DCT scaling) instead
+  // of refusing them, if one of those sizes fits.
+  bool downscale{false};
+};
+
+// Raised when an image is refused by its limits; surfaces as
+// ERR_IMAGE_LIMIT.
+class ImageLimitError : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+inline bool IsTiffFormat(l_int32 format) {
+  return (format >= IFF_TIFF && format <= IFF_TIFF_ZIP) ||
+         format == IFF_TIFF_JPEG;
+}
+
+// Peak raster bytes of decoding and normalizing one page (see
+// NormalizePageImage): Leptonica decodes 24 bpp to 32 bpp and strips 16 bit
+// samples to 8; normalization then widens depths below 8 bit to 8 and
+// colormapped images to 8 or, for color maps, 32 bpp, while the decoded
+// raster is still alive. Colormaps are assumed to be in color.
+inline int64_t DecodedImageBytes(l_int32 width, l_int32 height, l_int32 bps,
+                                 l_int32 spp, bool colormapped) {
+  auto raster_bytes = [&](int depth) {
+    return (static_cast<int64_t>(width) * depth + 31) / 32 * 4 * height;
+  };
+  int depth = (bps > 8 ? 8 : bps) * spp;
+  if (depth > 8) {
+    depth = 32;
+  }
+  const int normalized_depth = colormapped ? 32 : depth < 8 ? 8 : depth;
+  return raster_bytes(depth) +
+         (normalized_depth != depth ? raster_bytes(normalized_depth) : 0);
+}
+
+inline bool FitsImageLimits(const ImageLimits &limits, l_int32 width,
+                            l_int32 height, l_int32 bps, l_int32 spp,
+                            bool colormapped) {
+  return (limits.max_width <= 0 || width <= limits.max_width) &&
+         (limits.max_height <= 0 || height <= limits.max_height) &&
+         (limits.max_pixels <= 0 ||
+          static_cast<int64_t>(width) * height <= limits.max_pixels) &&
+         (limits.max_bytes <= 0 ||
+          DecodedImageBytes(width, height, bps, spp, colormapped) <=
+              limits.max_bytes);
+}
+
+// What giflib allocates for a GIF: DGifSlurp, which Leptonica uses, decodes
+// every frame to one byte per pixel before the first one becomes the page.
+struct GifHeader {
+  l_int32 width{0};  // of the first frame, the page Leptonica returns
+  l_int32 height{0};
+  int64_t frame_bytes{0}; // all frames
+};
+
+// Walks the blocks of a GIF without decoding any: pixReadHeaderMem decodes
+// the whole file to read a GIF's header. Returns false if `data` is not a
+// well-formed GIF up to its trailer, or has no frame.
+inline bool ReadGifHeader(const uint8_t *data, size_t size,
+                          GifHeader &header) {
+  size_t pos = 13; // signature and logical screen descriptor
+  if (size < pos || std::memcmp(data, "GIF8", 4) != 0) {
+    return false;
+  }
+  auto u16 = [&](size_t at) { return data[at] | (data[at + 1] << 8); };
+  auto skip_color_table = [&](uint8_t flags) {
+    if (flags & 0x80) {
+      pos += size_t{3} << ((flags & 0x07) + 1);
+    }
+  };
+  auto skip_sub_blocks = [&] {
+    while (pos < size && data[pos] != 0) {
+      pos += size_t{data[pos]} + 1;
+    }
+    ++pos; // terminator
+  };
+
+  skip_color_table(data[10]);
+  while (pos < size) {
+    const uint8_t block = data[pos++];
+    if (block == 0x3B) { // trailer
+      return header.frame_bytes > 0;
+    }
+    if (block == 0x21) { // extension: label, then sub-blocks
+      ++pos;
+      skip_sub_blocks();
+    } else if (block == 0x2C) { // image descriptor
+      if (pos + 9 > size) {
+        return false;
+      }
+      const l_int32 width = u16(pos + 4);
+      const l_int32 height = u16(pos + 6);
+      if (header.frame_bytes == 0) {
+        header.width = width;
+        header.height = height;
+      }
+      header.frame_bytes += static_cast<int64_t>(width) * height;
+      skip_color_table(data[pos + 8]);
+      pos += 9 + 1; // descriptor, LZW minimum code size
+      if (header.frame_bytes == 0) {
+        return false;
+      }
+      skip_sub_blocks();
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+// pixReadMem behind a header-only probe. Returns nullptr if the data cannot
+// be decoded and throws ImageLimitError if it exceeds `limits`.
+inline Pix *DecodeImage(const uint8_t *data, size_t size,
+                        const ImageLimits &limits, const char *method) {
+  TraceSpan span{"image", "decode"};
+  l_int32 format = IFF_UNKNOWN;
+  l_int32 width = 0, height = 0, bps = 0, spp = 0, iscmap = 0;
+  GifHeader gif;
+  if (ReadGifHeader(data, size, gif)) {
+    format = IFF_GIF;
+    width = gif.width;
+    height = gif.height;
+    bps = 8;
+    spp = 1;
+    iscmap = 1;
+    if (limits.max_bytes > 0 && gif.frame_bytes > limits.max_bytes) {
+      throw ImageLimitError(
+          std::format("{}: GIF frames of {} bytes exceed the image limits",
+                      method, gif.frame_bytes));
+    }
+  } else if (size >= 4 && std::memcmp(data, "GIF8", 4) == 0) {
+    return nullptr; // truncated or malformed, never handed to giflib
+  } else if (pixReadHeaderMem(data, size, &format, &width, &height, &bps,
+                              &spp, &iscmap) != 0) {
+    return nullptr;
+  }
+  if (width <= 0 || height <= 0) {
+    return nullptr;
+  }
+
+  if (limits.max_pages > 0 && IsTiffFormat(format)) {
+    l_int32 pages = 0;
+    if (tiffGetCountMem(data, size, &pages) == 0 &&
+        pages > limits.max_pages) {
+      throw ImageLimitError(
+          std::format("{}: image has {} pages, the limit is {}", method, pages,
+                      limits.max_pages));
+    }
+  }
+
+  if (FitsImageLimits(limits, width, height, bps, spp, iscmap != 0)) {
+    return pixReadMem(data, size);
+  }
+
+  if (limits.downscale && format == IFF_JFIF_JPEG) {
+    for (l_int32 reduction : {2, 4, 8}) {
+      const l_int32 reduced_width = (width + reduction - 1) / reduction;
+      const l_int32 reduced_height = (height + reduction - 1) / reduction;
+      if (!FitsImageLimits(limits, reduced_width, reduced_height, bps, spp,
+                           iscmap != 0)) {
+        continue;
+      }
+
+      Pix *pix = pixReadMemJpeg(data, size, 0, reduction, nullptr, 0);
+      if (pix != nullptr && pixGetXRes(pix) > 0 && pixGetYRes(pix) > 0) {
+        // keep the physical size, so Tesseract's resolution estimate holds
+        pixSetResolution(pix, pixGetXRes(pix) / reduction,
+                         pixGetYRes(pix) / reduction);
+      }
+      return pix;
+    }
+  }
+
+  throw ImageLimitError(
+      std::format("{}: {}x{} image ({} bits per pixel) exceeds the image "
+                  "limits",
+                  method, width, height, bps * spp));
+}
+
+// Prepares a decoded page for recognition: drops colormaps and alpha,
+// widens depths below 8 bit and assumes 300 dpi if the file has none. Takes
+// ownership of `pix` and returns the (possibly new) page.
+inline Pix *NormalizePageImage(Pix *pix, const char *method) {
+  if (pixGetColormap(pix) != nullptr) {
+    Pix *no_cmap = pixRemoveColormap(pix, REMOVE_CMAP_BASED_ON_SRC);
+    if (no_cmap == nullptr) {
+      pixDestroy(&pix);
+      throw_runtime("{}: failed to remove image colormap", method);
+    }
+    if (no_cmap != pix) {
+      pixDestroy(&pix);
+      pix = no_cmap;
+    }
+  }
+
+  if (pixGetSpp(pix) == 4) {
+    Pix *no_alpha = pixRemoveAlpha(pix);
+    if (no_alpha == nullptr) {
+      pixDestroy(&pix);
+      throw_runtime("{}: failed to remove alpha channel", method);
+    }
+    if (no_alpha != pix) {
+      pixDestroy(&pix);
+      pix = no_alpha;
+    }
+  }
+
+  const int depth = pixGetDepth(pix);
+  if (depth > 0 && depth < 8) {
+    Pix *normalized = pixConvertTo8(pix, false);
+    if (normalized == nullptr) {
+      pixDestroy(&pix);
+      throw_runtime("{}: failed to normalize low-bit-depth image", method);
+    }
+    if (normalized != pix) {
+      pixDestroy(&pix);
+      pix = normalized;
+    }
+  }
+
+  const int x_res = pixGetXRes(pix);
+  const int y_res = pixGetYRes(pix);
+  if (x_res <= 0 || y_res <= 0) {
+    pixSetResolution(pix, 300, 300);
+  }
+  return pix;
+}
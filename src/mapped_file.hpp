@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "utils.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file, opened on the worker thread so page data
+// never passes through the JS heap. On POSIX the file is mapped and the
+// kernel pages it in as the decoder reads; elsewhere it is read into memory.
+class MappedFile {
+public:
+  // Throws (ERR_TESSERACT_RUNTIME) if the file cannot be opened or is empty.
+  static MappedFile Open(const std::string &path, const char *method) {
+    MappedFile file;
+#ifdef _WIN32
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+      throw_runtime("{}: cannot open \"{}\"", method, path);
+    }
+    file._buffer.assign(std::istreambuf_iterator<char>(stream),
+                        std::istreambuf_iterator<char>());
+    file._data = reinterpret_cast<const uint8_t *>(file._buffer.data());
+    file._size = file._buffer.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw_runtime("{}: cannot open \"{}\": {}", method, path,
+                    std::strerror(errno));
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+      ::close(fd);
+      throw_runtime("{}: \"{}\" is not a regular file", method, path);
+    }
+
+    file._size = static_cast<size_t>(info.st_size);
+    if (file._size > 0) {
+      void *mapping =
+          ::mmap(nullptr, file._size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd);
+        throw_runtime("{}: cannot map \"{}\": {}", method, path,
+                      std::strerror(error));
+      }
+      // decoders read front to back; let the kernel read ahead
+      ::madvise(mapping, file._size, MADV_SEQUENTIAL);
+      file._data = static_cast<const uint8_t *>(mapping);
+    }
+    ::close(fd);
+#endif
+
+    if (file._size == 0) {
+      throw_runtime("{}: \"{}\" is empty", method, path);
+    }
+    return file;
+  }
+
+  MappedFile(MappedFile &&other) noexcept
+      : _data(std::exchange(other._data, nullptr)),
+        _size(std::exchange(other._size, 0))
+#ifdef _WIN32
+        ,
+        _buffer(std::move(other._buffer))
+#endif
+  {
+  }
+  MappedFile &operator=(MappedFile &&) = delete;
+  ~MappedFile() {
+#ifndef _WIN32
+    if (_data != nullptr) {
+      ::munmap(const_cast<uint8_t *>(_data), _size);
+    }
+#endif
+  }
+
+  const uint8_t *data() const { return _data; }
+  size_t size() const { return _size; }
+
+private:
+  MappedFile() = default;
+
+  const uint8_t *_data{nullptr};
+  size_t _size{0};
+#ifdef _WIN32
+  std::vector<char> _buffer;
+#endif
+};
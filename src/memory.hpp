@@ -0,0 +1,174 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "traineddata.hpp"
+#include <allheaders.h>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <tesseract/baseapi.h>
+#include <vector>
+
+// Native memory held by one instance that V8 cannot see on its own:
+//  - in_flight: encoded/raw image buffers copied into queued commands, and
+//               pages the prefetcher decoded ahead of their job
+//  - results:   results of finished jobs (text outputs, images, PDF data)
+//               until they are marshalled on the JS thread
+//  - image:     the decoded input image currently held by the engine(s)
+//  - model:     traineddata of the loaded languages (size as loaded)
+//
+// Counters are written from both threads; `reported` is only touched on the
+// JS thread and tracks what was already announced through
+// napi_adjust_external_memory.
+class MemoryAccount {
+public:
+  void SetBudget(int64_t bytes) {
+    _budget.store(bytes, std::memory_order_relaxed);
+  }
+  int64_t Budget() const { return _budget.load(std::memory_order_relaxed); }
+
+  int64_t InFlight() const {
+    return _in_flight.load(std::memory_order_relaxed);
+  }
+  int64_t Results() const {
+    return _results.load(std::memory_order_relaxed);
+  }
+  int64_t Image() const { return _image.load(std::memory_order_relaxed); }
+  int64_t Model() const { return _model.load(std::memory_order_relaxed); }
+  int64_t Total() const {
+    return InFlight() + Results() + Image() + Model();
+  }
+
+  // Admission control for a command carrying `bytes` of payload. Commands
+  // without payload are always admitted so that clear()/end() can free
+  // memory even when the instance is over budget.
+  bool TryReserve(int64_t bytes) {
+    if (bytes <= 0) {
+      return true;
+    }
+    int64_t current = _in_flight.load(std::memory_order_relaxed);
+    do {
+      const int64_t budget = Budget();
+      if (budget > 0 &&
+          current + Results() + Image() + Model() + bytes > budget) {
+        return false;
+      }
+    } while (!_in_flight.compare_exchange_weak(current, current + bytes,
+                                               std::memory_order_relaxed));
+    return true;
+  }
+
+  void Release(int64_t bytes) {
+    if (bytes > 0) {
+      _in_flight.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+  }
+
+  // Prefetched pages are not admitted, only counted: their job was, and the
+  // prefetch window bounds how many are held.
+  void AddPrefetched(int64_t bytes) {
+    _in_flight.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  // Results are not admitted, only counted: the job already ran.
+  void AddResults(int64_t bytes) {
+    _results.fetch_add(bytes, std::memory_order_relaxed);
+  }
+  void ReleaseResults(int64_t bytes) {
+    _results.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  void SetImage(int64_t bytes) {
+    _image.store(bytes, std::memory_order_relaxed);
+  }
+  void SetModel(int64_t bytes) {
+    _model.store(bytes, std::memory_order_relaxed);
+  }
+
+  // JS thread only: difference between the current total and what V8 was
+  // told so far. Pass the result to napi_adjust_external_memory.
+  int64_t TakeExternalDelta() {
+    const int64_t total = Total();
+    const int64_t delta = total - _reported;
+    _reported = total;
+    return delta;
+  }
+
+  // JS thread only: undo everything that was reported.
+  int64_t TakeExternalRemainder() {
+    const int64_t remainder = -_reported;
+    _reported = 0;
+    return remainder;
+  }
+
+private:
+  std::atomic<int64_t> _budget{0}; // 0 = unlimited
+  std::atomic<int64_t> _in_flight{0};
+  std::atomic<int64_t> _results{0};
+  std::atomic<int64_t> _image{0};
+  std::atomic<int64_t> _model{0};
+  int64_t _reported{0};
+};
+
+inline int64_t PixBytes(Pix *pix) {
+  if (pix == nullptr) {
+    return 0;
+  }
+  return static_cast<int64_t>(pixGetWpl(pix)) * 4 * pixGetHeight(pix);
+}
+
+// Bytes of the decoded input image held by the engine. Must only be called
+// on an initialized engine.
+inline int64_t EngineImageBytes(tesseract::TessBaseAPI &api) {
+  return PixBytes(api.GetInputImage());
+}
+
+// Tesseract does not expose the size of its loaded models; the size of the
+// traineddata as loaded (decompressed, for .gz/.zst models) is a close upper
+// bound for LSTM models. Models loaded without ReadTraineddata fall back to
+// the file size.
+inline int64_t EngineModelBytes(tesseract::TessBaseAPI &api) {
+  std::vector<std::string> langs;
+  api.GetLoadedLanguagesAsVector(&langs);
+  if (langs.empty()) {
+    return 0; // not initialized
+  }
+  const char *datapath = api.GetDatapath();
+  if (datapath == nullptr) {
+    return 0;
+  }
+
+  int64_t total = 0;
+  for (const auto &lang : langs) {
+    const std::filesystem::path model =
+        std::filesystem::path(datapath) / (lang + ".traineddata");
+    const int64_t loaded = LoadedTraineddataBytes(model.string());
+    if (loaded >= 0) {
+      total += loaded;
+      continue;
+    }
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(model, ec);
+    if (!ec) {
+      total += static_cast<int64_t>(size);
+    }
+  }
+  return total;
+}
@@ -1,7 +1,10 @@
 
 #pragma once
 
+#include "tracer.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <napi.h>
 #include <tesseract/ocrclass.h>
@@ -22,17 +25,54 @@ struct MonitorContext {
   Napi::ThreadSafeFunction js_progress_callback;
 };
 
+// Set on the worker thread while a job runs. MonitorHandles created there
+// publish the job's percent complete to it, so status reads can see progress
+// without a JS progress callback.
+inline thread_local std::atomic<int> *t_progress_sink = nullptr;
+
+// Heap-allocated so ETEXT_DESC::cancel_this survives moving the handle.
+struct MonitorTarget {
+  MonitorContext *context{nullptr};
+  std::atomic<int> *progress{nullptr};
+  int64_t created{-1};    // trace clock, -1 while tracing is off
+  int traced_percent{-1}; // last sample of the progress counter
+};
+
 struct MonitorHandle {
   tesseract::ETEXT_DESC monitor{};
   std::shared_ptr<MonitorContext> monitor_context;
+  std::unique_ptr<MonitorTarget> target;
 
   MonitorHandle(std::shared_ptr<MonitorContext> ctx)
       : monitor_context(std::move(ctx)) {
-    if (monitor_context) {
-      monitor.cancel_this = monitor_context.get();
+    if (monitor_context || t_progress_sink) {
+      target = std::make_unique<MonitorTarget>(
+          MonitorTarget{monitor_context.get(), t_progress_sink,
+                        TraceEnabled() ? TraceNow() : -1});
+      monitor.cancel_this = target.get();
       monitor.progress_callback2 = [](tesseract::ETEXT_DESC *monitor, int left,
                                       int right, int top, int bottom) -> bool {
-        auto *ctx = static_cast<MonitorContext *>(monitor->cancel_this);
+        auto *target = static_cast<MonitorTarget *>(monitor->cancel_this);
+        if (!target) {
+          return true;
+        }
+
+        if (target->progress) {
+          target->progress->store(monitor->progress,
+                                  std::memory_order_relaxed);
+        }
+
+        // Tesseract reports progress once layout analysis is done
+        if (target->created >= 0 &&
+            target->traced_percent != monitor->progress) {
+          if (target->traced_percent < 0) {
+            TraceComplete("tesseract", "layout", target->created);
+          }
+          target->traced_percent = monitor->progress;
+          TraceCounter("progress", monitor->progress);
+        }
+
+        MonitorContext *ctx = target->context;
         if (!ctx) {
           return true;
         }
@@ -47,6 +87,7 @@ struct MonitorHandle {
 
         napi_status status = ctx->js_progress_callback.NonBlockingCall(
             update, [](Napi::Env env, Napi::Function js_cb, ProgressUpdate *v) {
+              TraceSpan span{"js", "progressCallback"};
               Napi::Object info = Napi::Object::New(env);
               info.Set("progress", Napi::Number::New(env, v->progress));
               info.Set("percent", Napi::Number::New(env, v->percent));
@@ -68,6 +109,9 @@ struct MonitorHandle {
     }
   }
 
+  // The monitor to pass to Tesseract, or null if nobody listens.
+  tesseract::ETEXT_DESC *Monitor() { return target ? &monitor : nullptr; }
+
   MonitorHandle(const MonitorHandle &) = delete;
   MonitorHandle &operator=(const MonitorHandle &) = delete;
   MonitorHandle(MonitorHandle &&) = default;
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+// Argument and rejection helpers of the N-API entry points. Kept apart from
+// utils.hpp, which tesseract-ocrd compiles without N-API.
+
+#include <cstddef>
+#include <napi.h>
+#include <string>
+
+inline Napi::Value RejectWithError(Napi::Env env, Napi::Error error,
+                                   const char *code,
+                                   const std::string &message,
+                                   const char *method) {
+  error.Set("code", Napi::String::New(env, code));
+  error.Set("method", Napi::String::New(env, method));
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  deferred.Reject(error.Value());
+  return deferred.Promise();
+}
+
+inline Napi::Value RejectError(Napi::Env env, const std::string &message,
+                               const char *method) {
+  return RejectWithError(env, Napi::Error::New(env, message),
+                         "ERR_TESSERACT_RUNTIME", message, method);
+}
+
+inline Napi::Value RejectTypeError(Napi::Env env, const std::string &message,
+                                   const char *method) {
+  return RejectWithError(env, Napi::TypeError::New(env, message),
+                         "ERR_INVALID_ARGUMENT", message, method);
+}
+
+inline Napi::Value RejectRangeError(Napi::Env env, const std::string &message,
+                                    const char *method) {
+  return RejectWithError(env, Napi::RangeError::New(env, message),
+                         "ERR_OUT_OF_RANGE", message, method);
+}
+
+inline bool HasArg(const Napi::CallbackInfo &info, size_t index) {
+  return info.Length() > index && !info[index].IsUndefined();
+}
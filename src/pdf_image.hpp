@@ -0,0 +1,220 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "tracer.hpp"
+#include "utils.hpp"
+#include <allheaders.h>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <random>
+#include <sys/stat.h>
+#else
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+// How the image layer of a searchable PDF page is stored. TessPDFRenderer
+// embeds the page as it was decoded (JPEG files are passed through).
+struct PdfImagePolicy {
+  enum class Mode {
+    Keep,    // leave it to TessPDFRenderer
+    Jpeg,    // re-encode as JPEG, optionally downsampled
+    Bilevel, // Tesseract's own binarization, CCITT G4 compressed
+  };
+  Mode mode{Mode::Keep};
+  int dpi{0}; // Jpeg: downsample pages above this resolution, 0 = never
+  int jpeg_quality{85};
+};
+
+// Writes `page` to `path` as a JPEG the way `policy` asks for.
+inline void WritePdfJpeg(Pix *page, const PdfImagePolicy &policy,
+                         const std::string &path, const char *method) {
+  Pix *scaled = nullptr;
+  const int ppi = pixGetYRes(page);
+  if (policy.dpi > 0 && ppi > policy.dpi) {
+    const float factor = static_cast<float>(policy.dpi) / ppi;
+    // area mapping below 0.7, so downsampling does not alias
+    scaled = pixScale(page, factor, factor);
+    if (scaled == nullptr) {
+      throw_runtime("{}: failed to downsample the page image", method);
+    }
+    pixSetResolution(scaled, policy.dpi, policy.dpi);
+  }
+  const int status = pixWriteJpeg(path.c_str(), scaled ? scaled : page,
+                                  policy.jpeg_quality, 0);
+  pixDestroy(&scaled);
+  if (status != 0) {
+    throw_runtime("{}: cannot write the page image to \"{}\"", method, path);
+  }
+}
+
+// Creates an empty file of a unique name in the temporary directory and
+// returns its path. The name is claimed exclusively, so nothing else can
+// own it or have placed a link there.
+inline std::string CreatePdfImageFile(const char *method) {
+  std::error_code error;
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path(error);
+  if (error) {
+    throw_runtime("{}: no temporary directory for the page image: {}",
+                  method, error.message());
+  }
+#ifdef _WIN32
+  std::random_device random;
+  for (int attempt = 0; attempt < 100; ++attempt) {
+    const std::string path =
+        (directory / std::format("node-tesseract-page-{:08x}{:08x}.jpg",
+                                 random(), random()))
+            .string();
+    int fd = -1;
+    if (::_sopen_s(&fd, path.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY,
+                   _SH_DENYRW, _S_IREAD | _S_IWRITE) == 0) {
+      ::_close(fd);
+      return path;
+    }
+    if (errno != EEXIST) {
+      break;
+    }
+  }
+#else
+  std::string path = (directory / "node-tesseract-page-XXXXXX.jpg").string();
+  const int fd = ::mkstemps(path.data(), 4);
+  if (fd >= 0) {
+    ::close(fd);
+    return path;
+  }
+#endif
+  throw_runtime("{}: cannot create a file for the page image in \"{}\": {}",
+                method, directory.string(), std::strerror(errno));
+}
+
+// A page image being encoded into a temporary file of its own. The file is
+// removed once the page has been rendered or has failed, and the destructor
+// waits for the encoder, so it never writes a file nobody cleans up.
+class PendingPdfImage {
+public:
+  PendingPdfImage(std::future<void> done, const char *method)
+      : _done(std::move(done)), _path(CreatePdfImageFile(method)) {}
+  PendingPdfImage(const PendingPdfImage &) = delete;
+  PendingPdfImage &operator=(const PendingPdfImage &) = delete;
+  ~PendingPdfImage() {
+    if (_done.valid()) {
+      _done.wait();
+    }
+    std::error_code error;
+    std::filesystem::remove(_path, error);
+  }
+
+  const std::string &Path() const { return _path; }
+
+  // Rethrows whatever the encoder threw.
+  const std::string &Wait() {
+    _done.get();
+    return _path;
+  }
+
+private:
+  std::future<void> _done;
+  std::string _path;
+};
+
+// Encodes JPEG image layers on a helper thread of its own while the worker
+// recognizes the same page; TessPDFRenderer then copies the finished file
+// into the PDF instead of transcoding the page on the worker. Started on
+// the first page, stopped with the session.
+class PdfImageEncoder {
+public:
+  explicit PdfImageEncoder(PdfImagePolicy policy) : _policy(policy) {}
+
+  // Worker thread. `page` is only read, so the worker may keep using its
+  // own reference, but must not modify the pixels.
+  std::unique_ptr<PendingPdfImage> Encode(std::shared_ptr<Pix> page,
+                                          const char *method) {
+    std::promise<void> promise;
+    auto pending =
+        std::make_unique<PendingPdfImage>(promise.get_future(), method);
+    // declared after `pending`: if queueing throws, the promise is broken
+    // first and the destructor of `pending` does not wait forever
+    Request request{std::move(page), pending->Path(), method,
+                    std::move(promise)};
+    {
+      std::scoped_lock lock(_mutex);
+      _requests.push_back(std::move(request));
+    }
+    if (!_thread.joinable()) {
+      _thread = std::jthread([this](std::stop_token token) { Run(token); });
+    }
+    _cv.notify_one();
+    return pending;
+  }
+
+private:
+  struct Request {
+    std::shared_ptr<Pix> page;
+    std::string path;
+    const char *method{nullptr};
+    std::promise<void> promise;
+  };
+
+  void Run(std::stop_token token) {
+    TraceThreadName("tesseract-pdf-image");
+    while (true) {
+      Request request;
+      {
+        std::unique_lock lock(_mutex);
+        if (!_cv.wait(lock, token, [&] { return !_requests.empty(); })) {
+          return;
+        }
+        request = std::move(_requests.front());
+        _requests.pop_front();
+      }
+
+      try {
+        TraceSpan span{"pdf", "encodePageImage"};
+        WritePdfJpeg(request.page.get(), _policy, request.path,
+                     request.method);
+        request.promise.set_value();
+      } catch (...) {
+        request.promise.set_exception(std::current_exception());
+      }
+    }
+  }
+
+  const PdfImagePolicy _policy;
+  std::mutex _mutex;
+  std::condition_variable_any _cv;
+  std::deque<Request> _requests;
+  std::jthread _thread;
+};
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "pix_pool.hpp"
+#include <algorithm>
+#include <allheaders.h>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace {
+
+constexpr int kMinShift = 16; // 64 KiB
+constexpr int kMaxShift = 28; // 256 MiB
+constexpr int kSubClasses = 4;
+constexpr int kClassCount = (kMaxShift - kMinShift) * kSubClasses + 1;
+
+constexpr uint64_t kDefaultMaxRetainedBytes = 256ull * 1024 * 1024;
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+struct SizeClass {
+  std::mutex mutex;
+  FreeBlock *head{nullptr};
+};
+
+// Size class of every pooled block Leptonica holds, keyed by address. The
+// pool never reads memory outside a block, so buffers allocated before it
+// was installed, or by another user of liblept, are told apart by lookup
+// alone and go to free().
+constexpr int kOwnerShards = 16;
+
+struct OwnerShard {
+  std::mutex mutex;
+  std::unordered_map<const void *, int> blocks;
+};
+
+constexpr std::array<size_t, kClassCount> MakeClassSizes() {
+  std::array<size_t, kClassCount> sizes{};
+  for (int c = 0; c < kClassCount; ++c) {
+    const size_t base = size_t{1} << (kMinShift + c / kSubClasses);
+    sizes[c] = base + (c % kSubClasses) * (base / kSubClasses);
+  }
+  return sizes;
+}
+
+constexpr std::array<size_t, kClassCount> kClassSizes = MakeClassSizes();
+
+std::array<SizeClass, kClassCount> g_classes;
+std::array<OwnerShard, kOwnerShards> g_owners;
+std::atomic<bool> g_installed{false};
+std::atomic<bool> g_enabled{true};
+std::atomic<uint64_t> g_max_retained{kDefaultMaxRetainedBytes};
+std::atomic<uint64_t> g_retained{0};
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_hits{0};
+std::atomic<uint64_t> g_misses{0};
+
+int ClassFor(size_t size) {
+  auto it = std::lower_bound(kClassSizes.begin(), kClassSizes.end(), size);
+  return it == kClassSizes.end() ? -1
+                                 : static_cast<int>(it - kClassSizes.begin());
+}
+
+OwnerShard &OwnerOf(const void *ptr) {
+  return g_owners[std::hash<const void *>{}(ptr) % kOwnerShards];
+}
+
+void *Own(void *block, int size_class) {
+  if (block == nullptr) {
+    return nullptr;
+  }
+  OwnerShard &shard = OwnerOf(block);
+  try {
+    std::scoped_lock lock(shard.mutex);
+    shard.blocks.emplace(block, size_class);
+  } catch (const std::bad_alloc &) {
+    std::free(block);
+    return nullptr;
+  }
+  return block;
+}
+
+// Removes `ptr` from the owned blocks and returns its size class, or -1 if
+// the pool did not allocate it.
+int Disown(void *ptr) {
+  OwnerShard &shard = OwnerOf(ptr);
+  std::scoped_lock lock(shard.mutex);
+  auto it = shard.blocks.find(ptr);
+  if (it == shard.blocks.end()) {
+    return -1;
+  }
+  const int size_class = it->second;
+  shard.blocks.erase(it);
+  return size_class;
+}
+
+void *PoolAlloc(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+  const int c = g_enabled.load(std::memory_order_relaxed) &&
+                        size >= kClassSizes.front()
+                    ? ClassFor(size)
+                    : -1;
+  if (c < 0) {
+    return std::malloc(size);
+  }
+
+  SizeClass &size_class = g_classes[c];
+  FreeBlock *block = nullptr;
+  {
+    std::scoped_lock lock(size_class.mutex);
+    if ((block = size_class.head) != nullptr) {
+      size_class.head = block->next;
+      g_retained.fetch_sub(kClassSizes[c], std::memory_order_relaxed);
+    }
+  }
+  if (block != nullptr) {
+    g_hits.fetch_add(1, std::memory_order_relaxed);
+    return Own(block, c);
+  }
+
+  g_misses.fetch_add(1, std::memory_order_relaxed);
+  return Own(std::malloc(kClassSizes[c]), c);
+}
+
+void PoolFree(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  const int c = Disown(ptr);
+  if (c < 0) {
+    // raster data the pool did not allocate: small, unpooled, or from
+    // before InstallPixPool()
+    std::free(ptr);
+    return;
+  }
+
+  const uint64_t bytes = kClassSizes[c];
+  if (g_enabled.load(std::memory_order_relaxed) &&
+      g_retained.fetch_add(bytes, std::memory_order_relaxed) + bytes <=
+          g_max_retained.load(std::memory_order_relaxed)) {
+    auto *block = static_cast<FreeBlock *>(ptr);
+    std::scoped_lock lock(g_classes[c].mutex);
+    block->next = g_classes[c].head;
+    g_classes[c].head = block;
+    return;
+  }
+
+  g_retained.fetch_sub(bytes, std::memory_order_relaxed);
+  std::free(ptr);
+}
+
+// Frees retained blocks, largest classes first, until at most `limit` bytes
+// stay in the pool.
+void Trim(uint64_t limit) {
+  for (int c = kClassCount - 1; c >= 0; --c) {
+    FreeBlock *released = nullptr;
+    {
+      std::scoped_lock lock(g_classes[c].mutex);
+      while (g_classes[c].head != nullptr &&
+             g_retained.load(std::memory_order_relaxed) > limit) {
+        FreeBlock *block = g_classes[c].head;
+        g_classes[c].head = block->next;
+        g_retained.fetch_sub(kClassSizes[c], std::memory_order_relaxed);
+        block->next = released;
+        released = block;
+      }
+    }
+    while (released != nullptr) {
+      FreeBlock *next = released->next;
+      std::free(released);
+      released = next;
+    }
+  }
+}
+
+} // namespace
+
+void InstallPixPool() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    const char *setting = std::getenv("NODE_TESSERACT_PIX_POOL");
+    if (setting != nullptr && std::strcmp(setting, "0") == 0) {
+      return;
+    }
+    setPixMemoryManager(&PoolAlloc, &PoolFree);
+    g_installed.store(true, std::memory_order_release);
+  });
+}
+
+void ConfigurePixPool(bool enabled, uint64_t max_retained_bytes) {
+  g_enabled.store(enabled, std::memory_order_relaxed);
+  g_max_retained.store(max_retained_bytes, std::memory_order_relaxed);
+  Trim(enabled ? max_retained_bytes : 0);
+}
+
+PixPoolStats GetPixPoolStats() {
+  return PixPoolStats{
+      .installed = g_installed.load(std::memory_order_acquire),
+      .enabled = g_enabled.load(std::memory_order_relaxed),
+      .allocations = g_allocations.load(std::memory_order_relaxed),
+      .hits = g_hits.load(std::memory_order_relaxed),
+      .misses = g_misses.load(std::memory_order_relaxed),
+      .retained_bytes = g_retained.load(std::memory_order_relaxed),
+      .max_retained_bytes = g_max_retained.load(std::memory_order_relaxed),
+  };
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Size-class pool for Leptonica raster data, installed process-wide through
+// setPixMemoryManager. Page-sized rasters (>= 64 KiB) are rounded up to one
+// of four classes per power of two and recycled instead of going back to
+// malloc; smaller buffers are passed straight through.
+//
+// Leptonica's memory manager is a global without user data, so there is one
+// pool per process, shared by all environments and worker threads.
+
+struct PixPoolStats {
+  bool installed{false};
+  bool enabled{false};
+  uint64_t allocations{0};
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t retained_bytes{0};
+  uint64_t max_retained_bytes{0};
+};
+
+// Installs the pool once per process. Honors NODE_TESSERACT_PIX_POOL=0 to
+// keep Leptonica's default allocator. Raster data allocated before, or not
+// by the pool, is recognized by address and handed to free().
+void InstallPixPool();
+
+// Enables/disables pooling and bounds the bytes kept in free lists. Lowering
+// the bound (or disabling) releases retained buffers immediately.
+void ConfigurePixPool(bool enabled, uint64_t max_retained_bytes);
+
+PixPoolStats GetPixPoolStats();
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "commands.hpp"
+#include "image_decode.hpp"
+#include "mapped_file.hpp"
+#include "memory.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Decoded pages a request lets the prefetcher hold ahead of the page the
+// worker is recognizing (recognizeFile's `readahead`).
+inline constexpr size_t kDefaultReadahead = 1;
+inline constexpr size_t kMaxReadahead = 64;
+
+// Reads and decodes image files on an I/O thread of its own, in request
+// order, so the next page is ready by the time the worker gets to it. A
+// request is decoded once fewer than its readahead + 1 pages are held; a
+// page leaves the window when its job releases it, and its bytes are
+// counted as in-flight memory until then. Requests of jobs that were
+// dropped before their turn (rejected, or the instance stopped) are
+// skipped.
+//
+// The thread is started on the first request. Requests still pending when
+// the prefetcher is destroyed end with a broken promise, which the waiting
+// job reports as a runtime error.
+class ImagePrefetcher {
+public:
+  explicit ImagePrefetcher(std::shared_ptr<MemoryAccount> memory)
+      : _memory(std::move(memory)) {}
+
+  ~ImagePrefetcher() {
+    if (_thread.joinable()) {
+      _thread.request_stop();
+      _thread.join();
+    }
+    std::deque<Request> pending;
+    {
+      std::scoped_lock lock(_window->mutex);
+      pending.swap(_window->requests);
+    }
+  }
+
+  // JS thread
+  PrefetchedImage Prefetch(std::string path, const ImageLimits &limits,
+                           size_t readahead, const char *method) {
+    auto ticket = std::make_shared<Ticket>(_window, _memory);
+    Request request{std::move(path), limits, readahead + 1, method, {},
+                    ticket};
+    PrefetchedImage image{request.promise.get_future().share(), ticket};
+    {
+      std::scoped_lock lock(_window->mutex);
+      _window->requests.push_back(std::move(request));
+    }
+    if (!_thread.joinable()) {
+      _thread = std::jthread([this](std::stop_token token) { Run(token); });
+    }
+    _window->cv.notify_one();
+    return image;
+  }
+
+private:
+  struct Ticket;
+
+  struct Request {
+    std::string path;
+    ImageLimits limits;
+    size_t window{kDefaultReadahead + 1}; // held pages it may be decoded at
+    const char *method{nullptr};
+    std::promise<std::shared_ptr<Pix>> promise;
+    std::weak_ptr<Ticket> ticket; // expired once the job is dropped
+  };
+
+  // Shared with the tickets, which live in jobs and may outlive the
+  // prefetcher.
+  struct Window {
+    std::mutex mutex;
+    std::condition_variable_any cv;
+    std::deque<Request> requests;
+    size_t held{0}; // decoded or decoding pages not yet released
+  };
+
+  struct Ticket {
+    Ticket(std::shared_ptr<Window> window,
+           std::shared_ptr<MemoryAccount> memory)
+        : window(std::move(window)), memory(std::move(memory)) {}
+    ~Ticket() {
+      memory->Release(bytes);
+      if (held) {
+        {
+          std::scoped_lock lock(window->mutex);
+          --window->held;
+        }
+        window->cv.notify_one();
+      }
+    }
+
+    std::shared_ptr<Window> window;
+    std::shared_ptr<MemoryAccount> memory;
+    bool held{false}; // set by the prefetch thread under window->mutex
+    int64_t bytes{0};
+  };
+
+  void Run(std::stop_token token) {
+    TraceThreadName("tesseract-prefetch");
+    while (true) {
+      Request request;
+      std::shared_ptr<Ticket> ticket;
+      {
+        std::unique_lock lock(_window->mutex);
+        if (!_window->cv.wait(lock, token, [&] {
+              return !_window->requests.empty() &&
+                     _window->held < _window->requests.front().window;
+            })) {
+          return;
+        }
+        request = std::move(_window->requests.front());
+        _window->requests.pop_front();
+        ticket = request.ticket.lock();
+        if (ticket != nullptr) {
+          ticket->held = true;
+          ++_window->held;
+        }
+      }
+      if (ticket == nullptr) {
+        continue; // nobody waits for this page any more
+      }
+
+      try {
+        Pix *pix = nullptr;
+        {
+          const MappedFile file =
+              MappedFile::Open(request.path, request.method);
+          pix = DecodeImage(file.data(), file.size(), request.limits,
+                            request.method);
+        }
+        if (pix == nullptr) {
+          throw_runtime("{}: failed to decode \"{}\"", request.method,
+                        request.path);
+        }
+        std::shared_ptr<Pix> page =
+            SharePix(NormalizePageImage(pix, request.method));
+        ticket->bytes = PixBytes(page.get());
+        _memory->AddPrefetched(ticket->bytes);
+        request.promise.set_value(std::move(page));
+      } catch (...) {
+        request.promise.set_exception(std::current_exception());
+      }
+      // may be the last reference: released outside the lock
+      ticket.reset();
+    }
+  }
+
+  std::shared_ptr<MemoryAccount> _memory;
+  std::shared_ptr<Window> _window = std::make_shared<Window>();
+  std::jthread _thread;
+};
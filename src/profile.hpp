@@ -0,0 +1,41 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "variable_overlay.hpp"
+#include <optional>
+#include <tesseract/publictypes.h>
+
+struct ProfileRect {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+};
+
+// Options of recognizeWithProfile jobs, validated once by createProfile and
+// shared, immutable, by every job that uses the profile.
+struct JobProfile {
+  std::optional<tesseract::PageSegMode> psm;
+  std::optional<ProfileRect> rect;
+  VariableOverlay variables; // set for each job, see OverlayState
+  bool text{true};
+  bool hocr{false};
+  bool tsv{false};
+  bool alto{false};
+  int timeout_millisec{0}; // 0 = unlimited
+};
@@ -0,0 +1,696 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <allheaders.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <napi.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Describes one JS property of a schema-typed result struct. The table of
+// fields is known at compile time, so marshalling never hashes or allocates
+// keys and defines every property with a single napi_define_properties call.
+template <typename S, typename T> struct Field {
+  const char *name;
+  T S::*member;
+};
+
+template <typename S, typename T> Field(const char *, T S::*) -> Field<S, T>;
+
+template <typename S>
+concept SchemaResult = requires { S::Fields(); };
+
+struct ResultVoid {};
+
+struct ResultBool {
+  bool value;
+};
+
+struct ResultInt {
+  int value;
+};
+
+struct ResultDouble {
+  double value;
+};
+
+struct ResultFloat {
+  float value;
+};
+
+struct ResultString {
+  std::string value;
+};
+
+struct ResultBuffer {
+  std::vector<uint8_t> value;
+};
+
+using ArrayValue = std::variant<std::vector<int>, std::vector<std::string>>;
+
+struct ResultArray {
+  ArrayValue value;
+};
+
+struct ResultOrientationScript {
+  int orientation_degrees{0};
+  float orientation_confidence{0.0f};
+  std::string script_name;
+  float script_confidence{0.0f};
+
+  static constexpr auto Fields() {
+    using S = ResultOrientationScript;
+    return std::tuple{
+        Field{"orientationDegrees", &S::orientation_degrees},
+        Field{"orientationConfidence", &S::orientation_confidence},
+        Field{"scriptName", &S::script_name},
+        Field{"scriptConfidence", &S::script_confidence},
+    };
+  }
+};
+
+struct ResultProcessPagesStatus {
+  bool active{false};
+  bool healthy{false};
+  int processed_pages{0};
+  int next_page_index{0};
+  std::string output_base;
+  int timeout_millisec{0};
+  bool textonly{false};
+
+  static constexpr auto Fields() {
+    using S = ResultProcessPagesStatus;
+    return std::tuple{
+        Field{"active", &S::active},
+        Field{"healthy", &S::healthy},
+        Field{"processedPages", &S::processed_pages},
+        Field{"nextPageIndex", &S::next_page_index},
+        Field{"outputBase", &S::output_base},
+        Field{"timeoutMillisec", &S::timeout_millisec},
+        Field{"textonly", &S::textonly},
+    };
+  }
+};
+
+struct ResultWorkerStatus {
+  bool initialized{false};
+  int queue_depth{0};
+  int queue_waiting{0}; // waitForCapacity() calls not resolved yet
+  int queue_capacity{0};
+  int queue_high_water{0};
+  std::string current_command; // empty while idle
+  int current_progress{0};
+  int64_t current_running_millis{0};
+  ResultProcessPagesStatus session;
+
+  static constexpr auto Fields() {
+    using S = ResultWorkerStatus;
+    return std::tuple{
+        Field{"initialized", &S::initialized},
+        Field{"queueDepth", &S::queue_depth},
+        Field{"queueWaiting", &S::queue_waiting},
+        Field{"queueCapacity", &S::queue_capacity},
+        Field{"queueHighWater", &S::queue_high_water},
+        Field{"currentCommand", &S::current_command},
+        Field{"currentProgress", &S::current_progress},
+        Field{"currentRunningMillis", &S::current_running_millis},
+        Field{"session", &S::session},
+    };
+  }
+};
+
+struct ResultThreadingConfig {
+  bool openmp{false};
+  int intra_op_threads{1};
+  int hardware_concurrency{0};
+  std::vector<int> cpu_affinity;
+
+  static constexpr auto Fields() {
+    using S = ResultThreadingConfig;
+    return std::tuple{
+        Field{"openmp", &S::openmp},
+        Field{"intraOpThreads", &S::intra_op_threads},
+        Field{"hardwareConcurrency", &S::hardware_concurrency},
+        Field{"cpuAffinity", &S::cpu_affinity},
+    };
+  }
+};
+
+struct ResultRegion {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  int psm{0};
+  std::string text;
+  int confidence{0};
+
+  static constexpr auto Fields() {
+    using S = ResultRegion;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"psm", &S::psm},
+        Field{"text", &S::text},
+        Field{"confidence", &S::confidence},
+    };
+  }
+};
+
+struct ResultCascadeItem {
+  std::string text;
+  float confidence{0.0f};
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  bool refined{false};
+
+  static constexpr auto Fields() {
+    using S = ResultCascadeItem;
+    return std::tuple{
+        Field{"text", &S::text},
+        Field{"confidence", &S::confidence},
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"refined", &S::refined},
+    };
+  }
+};
+
+struct ResultCascade {
+  std::string text;
+  int refined_count{0};
+  std::vector<ResultCascadeItem> items;
+
+  static constexpr auto Fields() {
+    using S = ResultCascade;
+    return std::tuple{
+        Field{"text", &S::text},
+        Field{"refinedCount", &S::refined_count},
+        Field{"items", &S::items},
+    };
+  }
+};
+
+struct ResultFrameLine {
+  int id{0};
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  std::string text;
+  float confidence{0.0f};
+
+  static constexpr auto Fields() {
+    using S = ResultFrameLine;
+    return std::tuple{
+        Field{"id", &S::id},
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"text", &S::text},
+        Field{"confidence", &S::confidence},
+    };
+  }
+};
+
+struct ResultFrame {
+  int64_t frame{0};
+  int changed_tiles{0};
+  int total_tiles{0};
+  std::vector<ResultFrameLine> added;
+  std::vector<int> removed;
+  std::string text;
+
+  static constexpr auto Fields() {
+    using S = ResultFrame;
+    return std::tuple{
+        Field{"frame", &S::frame},
+        Field{"changedTiles", &S::changed_tiles},
+        Field{"totalTiles", &S::total_tiles},
+        Field{"added", &S::added},
+        Field{"removed", &S::removed},
+        Field{"text", &S::text},
+    };
+  }
+};
+
+struct ResultMemoryUsage {
+  int64_t in_flight_bytes{0};
+  int64_t result_bytes{0};
+  int64_t image_bytes{0};
+  int64_t model_bytes{0};
+  int64_t total_bytes{0};
+  int64_t budget_bytes{0};
+
+  static constexpr auto Fields() {
+    using S = ResultMemoryUsage;
+    return std::tuple{
+        Field{"inFlightBytes", &S::in_flight_bytes},
+        Field{"resultBytes", &S::result_bytes},
+        Field{"imageBytes", &S::image_bytes},
+        Field{"modelBytes", &S::model_bytes},
+        Field{"totalBytes", &S::total_bytes},
+        Field{"budgetBytes", &S::budget_bytes},
+    };
+  }
+};
+
+struct ResultLayoutBaseline {
+  int x1{0};
+  int y1{0};
+  int x2{0};
+  int y2{0};
+
+  static constexpr auto Fields() {
+    using S = ResultLayoutBaseline;
+    return std::tuple{
+        Field{"x1", &S::x1},
+        Field{"y1", &S::y1},
+        Field{"x2", &S::x2},
+        Field{"y2", &S::y2},
+    };
+  }
+};
+
+struct ResultLayoutWord {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+
+  static constexpr auto Fields() {
+    using S = ResultLayoutWord;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+    };
+  }
+};
+
+struct ResultLayoutLine {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  ResultLayoutBaseline baseline;
+  std::vector<ResultLayoutWord> words;
+
+  static constexpr auto Fields() {
+    using S = ResultLayoutLine;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"baseline", &S::baseline},
+        Field{"words", &S::words},
+    };
+  }
+};
+
+struct ResultLayoutParagraph {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  std::vector<ResultLayoutLine> lines;
+
+  static constexpr auto Fields() {
+    using S = ResultLayoutParagraph;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"lines", &S::lines},
+    };
+  }
+};
+
+struct ResultLayoutBlock {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  std::string block_type;
+  std::string orientation;
+  std::string writing_direction;
+  std::string textline_order;
+  float deskew_angle{0.0f};
+  std::vector<ResultLayoutParagraph> paragraphs;
+
+  static constexpr auto Fields() {
+    using S = ResultLayoutBlock;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"blockType", &S::block_type},
+        Field{"orientation", &S::orientation},
+        Field{"writingDirection", &S::writing_direction},
+        Field{"textlineOrder", &S::textline_order},
+        Field{"deskewAngle", &S::deskew_angle},
+        Field{"paragraphs", &S::paragraphs},
+    };
+  }
+};
+
+struct ResultLayout {
+  std::vector<ResultLayoutBlock> blocks;
+
+  static constexpr auto Fields() {
+    using S = ResultLayout;
+    return std::tuple{
+        Field{"blocks", &S::blocks},
+    };
+  }
+};
+
+// Leptonica image handed to JS as an external Buffer over its raster data.
+// The Buffer holds a reference to the Pix and drops it from its finalizer.
+struct PixData {
+  std::shared_ptr<Pix> pix;
+};
+
+inline std::shared_ptr<Pix> SharePix(Pix *pix) {
+  return std::shared_ptr<Pix>(pix, [](Pix *p) { pixDestroy(&p); });
+}
+
+struct ResultComponentImageData {
+  int width{0};
+  int height{0};
+  int depth{0};
+  int bytes_per_line{0};
+  PixData data;
+
+  static constexpr auto Fields() {
+    using S = ResultComponentImageData;
+    return std::tuple{
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"depth", &S::depth},
+        Field{"bytesPerLine", &S::bytes_per_line},
+        Field{"data", &S::data},
+    };
+  }
+};
+
+struct ResultComponentImage {
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  int block_index{-1};
+  int paragraph_index{-1};
+  ResultComponentImageData image;
+
+  static constexpr auto Fields() {
+    using S = ResultComponentImage;
+    return std::tuple{
+        Field{"left", &S::left},
+        Field{"top", &S::top},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"blockIndex", &S::block_index},
+        Field{"paragraphIndex", &S::paragraph_index},
+        Field{"image", &S::image},
+    };
+  }
+};
+
+// One file of a processFiles batch. Outputs that were not requested stay
+// empty.
+struct ResultRecognizedFile {
+  std::string path;
+  int width{0};
+  int height{0};
+  int mean_confidence{0};
+  std::string text;
+  std::string hocr;
+  std::string tsv;
+  std::string alto;
+
+  static constexpr auto Fields() {
+    using S = ResultRecognizedFile;
+    return std::tuple{
+        Field{"path", &S::path},
+        Field{"width", &S::width},
+        Field{"height", &S::height},
+        Field{"meanConfidence", &S::mean_confidence},
+        Field{"text", &S::text},
+        Field{"hocr", &S::hocr},
+        Field{"tsv", &S::tsv},
+        Field{"alto", &S::alto},
+    };
+  }
+};
+
+// Array of schema-typed results, marshalled as a JS array of objects.
+template <SchemaResult S> struct ResultList {
+  std::vector<S> value;
+};
+
+using Result =
+    std::variant<ResultVoid, ResultBool, ResultInt, ResultDouble, ResultFloat,
+                 ResultString, ResultArray, ResultBuffer,
+                 ResultOrientationScript, ResultProcessPagesStatus,
+                 ResultThreadingConfig, ResultList<ResultRegion>,
+                 ResultCascade, ResultMemoryUsage, ResultLayout,
+                 ResultList<ResultComponentImage>, ResultWorkerStatus,
+                 ResultRecognizedFile, ResultFrame>;
+
+// Native bytes a result holds until it is marshalled on the JS thread,
+// charged to the instance's MemoryAccount while the job is settling.
+inline size_t NativeBytes(const std::string &s) { return s.size(); }
+
+inline size_t NativeBytes(const std::vector<uint8_t> &vec) {
+  return vec.size();
+}
+
+inline size_t NativeBytes(const std::vector<int> &vec) {
+  return vec.size() * sizeof(int);
+}
+
+inline size_t NativeBytes(const std::vector<std::string> &vec) {
+  size_t bytes = 0;
+  for (const auto &s : vec) {
+    bytes += s.size();
+  }
+  return bytes;
+}
+
+inline size_t NativeBytes(const PixData &image) {
+  if (image.pix == nullptr) {
+    return 0;
+  }
+  return static_cast<size_t>(pixGetWpl(image.pix.get())) * 4 *
+         pixGetHeight(image.pix.get());
+}
+
+template <typename T>
+  requires std::is_arithmetic_v<T>
+size_t NativeBytes(const T &) {
+  return 0;
+}
+
+template <SchemaResult S> size_t NativeBytes(const std::vector<S> &vec);
+
+template <SchemaResult S> size_t NativeBytes(const S &s) {
+  return std::apply(
+      [&](const auto &...field) {
+        return (size_t{0} + ... + NativeBytes(s.*(field.member)));
+      },
+      S::Fields());
+}
+
+template <SchemaResult S> size_t NativeBytes(const std::vector<S> &vec) {
+  size_t bytes = 0;
+  for (const auto &item : vec) {
+    bytes += NativeBytes(item);
+  }
+  return bytes;
+}
+
+inline size_t ResultBytes(const Result &result) {
+  return std::visit(
+      [](const auto &r) -> size_t {
+        using T = std::decay_t<decltype(r)>;
+        if constexpr (SchemaResult<T>) {
+          return NativeBytes(r);
+        } else if constexpr (std::is_same_v<T, ResultArray>) {
+          return std::visit([](const auto &vec) { return NativeBytes(vec); },
+                            r.value);
+        } else if constexpr (requires { NativeBytes(r.value); }) {
+          return NativeBytes(r.value);
+        } else {
+          return 0;
+        }
+      },
+      result);
+}
+
+template <class... Ts> struct match : Ts... {
+  using Ts::operator()...;
+};
+
+template <class... Ts> match(Ts...) -> match<Ts...>;
+
+template <typename T>
+static Napi::Array VectorToNapiArray(Napi::Env env, const std::vector<T> &vec) {
+  Napi::Array arr = Napi::Array::New(env, vec.size());
+  for (size_t i = 0; i < vec.size(); ++i) {
+    arr.Set(static_cast<uint32_t>(i), vec[i]);
+  }
+  return arr;
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, bool b) {
+  return Napi::Boolean::New(env, b);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, int i) {
+  return Napi::Number::New(env, i);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, int64_t i) {
+  return Napi::Number::New(env, static_cast<double>(i));
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, uint64_t i) {
+  return Napi::Number::New(env, static_cast<double>(i));
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, double d) {
+  return Napi::Number::New(env, d);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, float f) {
+  return Napi::Number::New(env, f);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, const std::string &s) {
+  return Napi::String::New(env, s);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env,
+                               const std::vector<uint8_t> &vec) { // Buffer
+  return Napi::Buffer<uint8_t>::Copy(env, vec.data(), vec.size());
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, const PixData &image) {
+  if (image.pix == nullptr) {
+    return Napi::Buffer<uint8_t>::New(env, 0);
+  }
+
+  Pix *pix = image.pix.get();
+  auto *data = reinterpret_cast<uint8_t *>(pixGetData(pix));
+  const size_t length =
+      static_cast<size_t>(pixGetWpl(pix)) * 4 * pixGetHeight(pix);
+
+  // copies (and finalizes right away) where external buffers are disallowed
+  return Napi::Buffer<uint8_t>::NewOrCopy(
+      env, data, length,
+      [](Napi::Env, uint8_t *, std::shared_ptr<Pix> *owner) { delete owner; },
+      new std::shared_ptr<Pix>(image.pix));
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env, const std::vector<int> &vec) {
+  return VectorToNapiArray(env, vec);
+}
+
+inline Napi::Value ToNapiValue(Napi::Env env,
+                               const std::vector<std::string> &vec) {
+  return VectorToNapiArray(env, vec);
+}
+
+template <SchemaResult S>
+Napi::Value ToNapiValue(Napi::Env env, const std::vector<S> &vec);
+
+template <SchemaResult S> Napi::Value ToNapiValue(Napi::Env env, const S &s) {
+  Napi::Object obj = Napi::Object::New(env);
+  std::apply(
+      [&](const auto &...field) {
+        obj.DefineProperties({Napi::PropertyDescriptor::Value(
+            field.name, ToNapiValue(env, s.*(field.member)),
+            napi_default_jsproperty)...});
+      },
+      S::Fields());
+  return obj;
+}
+
+template <SchemaResult S>
+Napi::Value ToNapiValue(Napi::Env env, const std::vector<S> &vec) {
+  Napi::Array arr = Napi::Array::New(env, vec.size());
+  for (size_t i = 0; i < vec.size(); ++i) {
+    arr.Set(static_cast<uint32_t>(i), ToNapiValue(env, vec[i]));
+  }
+  return arr;
+}
+
+inline Napi::Value MatchResult(Napi::Env env, const Result &r) {
+  return std::visit(
+      match{[&](const ResultVoid &) -> Napi::Value { return env.Undefined(); },
+            [&](const ResultBool &v) -> Napi::Value {
+              return Napi::Boolean::New(env, v.value);
+            },
+            [&](const ResultInt &v) -> Napi::Value {
+              return Napi::Number::New(env, v.value);
+            },
+            [&](const ResultDouble &v) -> Napi::Value {
+              return Napi::Number::New(env, v.value);
+            },
+            [&](const ResultFloat &v) -> Napi::Value {
+              return Napi::Number::New(env, v.value);
+            },
+            [&](const ResultString &v) -> Napi::Value {
+              return Napi::String::New(env, v.value);
+            },
+            [&](const ResultBuffer &v) -> Napi::Value {
+              return Napi::Buffer<uint8_t>::Copy(env, v.value.data(),
+                                                 v.value.size());
+            },
+            [&](const ResultArray &v) -> Napi::Value {
+              return std::visit(
+                  [&](const auto &vec) -> Napi::Value {
+                    return VectorToNapiArray(env, vec);
+                  },
+                  v.value);
+            },
+            [&]<SchemaResult S>(const S &v) -> Napi::Value {
+              return ToNapiValue(env, v);
+            },
+            [&]<SchemaResult S>(const ResultList<S> &v) -> Napi::Value {
+              return ToNapiValue(env, v.value);
+            }},
+      r);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "results.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Worker state published for the JS thread, so that status calls answer
+// without queueing behind a running job. The worker thread writes, the JS
+// thread only loads; neither side ever waits for the other.
+//
+// Scalars are plain atomics. The session status holds a string, so it is
+// published as an immutable snapshot that is swapped as a whole. Queue
+// figures are read from the SubmissionRing directly.
+class WorkerStatus {
+public:
+  // Worker thread: `name` must be a string literal.
+  void JobStarted(const char *name) {
+    _progress.store(0, std::memory_order_relaxed);
+    _started_at.store(NowMillis(), std::memory_order_relaxed);
+    _current.store(name, std::memory_order_release);
+  }
+  void JobFinished() { _current.store(nullptr, std::memory_order_release); }
+
+  // Written through t_progress_sink by MonitorHandle.
+  std::atomic<int> &Progress() { return _progress; }
+
+  void PublishSession(ResultProcessPagesStatus session) {
+    _session.store(std::make_shared<const ResultProcessPagesStatus>(
+                       std::move(session)),
+                   std::memory_order_release);
+  }
+
+  ResultProcessPagesStatus Session() const {
+    auto session = _session.load(std::memory_order_acquire);
+    return session ? *session : ResultProcessPagesStatus{};
+  }
+
+  ResultWorkerStatus Snapshot(bool initialized) const {
+    ResultWorkerStatus status{};
+    status.initialized = initialized;
+
+    const char *current = _current.load(std::memory_order_acquire);
+    if (current != nullptr) {
+      status.current_command = current;
+      status.current_progress = _progress.load(std::memory_order_relaxed);
+      status.current_running_millis =
+          NowMillis() - _started_at.load(std::memory_order_relaxed);
+    }
+
+    status.session = Session();
+    return status;
+  }
+
+private:
+  static int64_t NowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  std::atomic<const char *> _current{nullptr};
+  std::atomic<int> _progress{0};
+  std::atomic<int64_t> _started_at{0};
+  std::atomic<std::shared_ptr<const ResultProcessPagesStatus>> _session;
+};
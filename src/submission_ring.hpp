@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "commands.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <napi.h>
+#include <stop_token>
+#include <utility>
+
+inline constexpr size_t kDefaultQueueCapacity = 1024;
+inline constexpr size_t kMaxQueueCapacity = size_t{1} << 20;
+
+struct QueueOptions {
+  size_t capacity{kDefaultQueueCapacity};
+};
+
+// Bounded multi-producer, single-consumer ring of submitted jobs. Every cell
+// carries a sequence number that says whose turn it is (Vyukov's bounded
+// queue), so neither side takes a lock. The worker sleeps on a counter that
+// producers bump after each push.
+//
+// A full ring rejects jobs, except end(), which is parked in a single slot.
+// Producers that want to wait for room ask for a capacity promise instead,
+// so no job payload is held outside the ring. The slot and the waiters
+// belong to the JS thread: the completion drain refills the slot and
+// resolves waiters as the worker frees cells. Once stop is requested, the
+// worker takes the slot over while the JS thread waits in WorkerThread::Stop.
+class SubmissionRing {
+public:
+  explicit SubmissionRing(size_t capacity)
+      : _capacity(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+        _cells(std::make_unique<Cell[]>(_capacity)) {
+    for (size_t i = 0; i < _capacity; ++i) {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t Capacity() const { return _capacity; }
+
+  // Moves `job` into the ring; leaves it untouched if the ring is full.
+  bool TryPush(std::shared_ptr<Job> &job) {
+    size_t pos = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = _cells[pos & (_capacity - 1)];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto lag = static_cast<intptr_t>(sequence - pos);
+      if (lag < 0) {
+        return false; // the consumer has not freed this cell yet
+      }
+      if (lag > 0) {
+        pos = _tail.load(std::memory_order_relaxed); // another producer won
+        continue;
+      }
+      if (_tail.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        cell.job = std::move(job);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        break;
+      }
+    }
+
+    const size_t depth = Size();
+    size_t high_water = _high_water.load(std::memory_order_relaxed);
+    while (depth > high_water &&
+           !_high_water.compare_exchange_weak(high_water, depth,
+                                              std::memory_order_relaxed)) {
+    }
+
+    _signal.fetch_add(1, std::memory_order_release);
+    _signal.notify_one();
+    return true;
+  }
+
+  // Worker thread: blocks until a job arrives. Returns nullptr once stop is
+  // requested, leaving queued jobs for Drain.
+  std::shared_ptr<Job> Pop(std::stop_token token) {
+    while (true) {
+      // load before checking, so a Wake in between ends the wait below
+      const uint32_t signal = _signal.load(std::memory_order_acquire);
+      if (token.stop_requested()) {
+        return nullptr;
+      }
+      if (auto job = TryPop()) {
+        return job;
+      }
+      _signal.wait(signal, std::memory_order_acquire);
+    }
+  }
+
+  void Wake() {
+    _signal.fetch_add(1, std::memory_order_release);
+    _signal.notify_all();
+  }
+
+  // Worker thread: hands every queued job to `fn` in submission order.
+  template <typename F> void Drain(F &&fn) {
+    while (auto job = TryPop()) {
+      fn(std::move(job));
+    }
+  }
+
+  // Worker thread, only after stop was requested (see above).
+  std::shared_ptr<Job> TakeParked() { return std::exchange(_parked, nullptr); }
+
+  // JS thread
+  bool HasParked() const { return _parked != nullptr; }
+  void Park(std::shared_ptr<Job> job) { _parked = std::move(job); }
+  void Refill() {
+    if (_parked != nullptr) {
+      TryPush(_parked); // clears the slot once pushed
+    }
+  }
+
+  // JS thread: cells a producer can fill right now
+  size_t FreeCells() const {
+    const size_t used = Size() + (HasParked() ? 1 : 0);
+    return used < _capacity ? _capacity - used : 0;
+  }
+  size_t WaiterCount() const { return _waiters.size(); }
+  void AddWaiter(Napi::Promise::Deferred deferred) {
+    _waiters.push_back(std::move(deferred));
+  }
+  // Resolves the oldest waiters, one per free cell. Free cells only grow
+  // while the JS thread is in here, so every waiter left over is behind a
+  // full ring and a later drain will get to it.
+  void ResolveWaiters(Napi::Env env) {
+    for (size_t free = FreeCells(); free > 0 && !_waiters.empty(); --free) {
+      _waiters.front().Resolve(env.Undefined());
+      _waiters.pop_front();
+    }
+  }
+
+  size_t Size() const {
+    const size_t head = _head.load(std::memory_order_acquire);
+    return _tail.load(std::memory_order_acquire) - head;
+  }
+  size_t HighWater() const {
+    return _high_water.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence{0};
+    std::shared_ptr<Job> job;
+  };
+
+  // single consumer: only the worker moves _head
+  std::shared_ptr<Job> TryPop() {
+    const size_t pos = _head.load(std::memory_order_relaxed);
+    Cell &cell = _cells[pos & (_capacity - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+      return nullptr; // empty, or the producer is still writing the cell
+    }
+
+    std::shared_ptr<Job> job = std::move(cell.job);
+    _head.store(pos + 1, std::memory_order_release);
+    cell.sequence.store(pos + _capacity, std::memory_order_release);
+    return job;
+  }
+
+  const size_t _capacity;
+  std::unique_ptr<Cell[]> _cells;
+
+  // producers and the consumer write different ends; keep them apart
+  alignas(64) std::atomic<size_t> _tail{0};
+  alignas(64) std::atomic<size_t> _head{0};
+  alignas(64) std::atomic<uint32_t> _signal{0};
+  std::atomic<size_t> _high_water{0};
+
+  std::shared_ptr<Job> _parked;
+  std::deque<Napi::Promise::Deferred> _waiters;
+};
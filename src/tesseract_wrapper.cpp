@@ -16,49 +16,190 @@
 
 #include "tesseract_wrapper.hpp"
 #include "commands.hpp"
+#include "napi_utils.hpp"
 #include "worker_thread.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <format>
 #include <iostream>
 #include <leptonica/allheaders.h>
+#include <optional>
 #include <string>
 #include <tesseract/publictypes.h>
-
-Napi::FunctionReference TesseractWrapper::constructor;
+#include <tuple>
+#include <utility>
 
 namespace {
 
-Napi::Value RejectWithError(Napi::Env env, Napi::Error error, const char *code,
-                            const std::string &message, const char *method) {
-  error.Set("code", Napi::String::New(env, code));
-  error.Set("method", Napi::String::New(env, method));
+enum class ParseStatus { Ok, InvalidType, OutOfRange };
+
+// Parses an optional page segmentation mode; leaves `out` untouched when
+// `value` is undefined.
+ParseStatus ParseOptionalPsm(const Napi::Value &value,
+                             std::optional<tesseract::PageSegMode> &out) {
+  if (value.IsUndefined()) {
+    return ParseStatus::Ok;
+  }
+  if (!value.IsNumber()) {
+    return ParseStatus::InvalidType;
+  }
+
+  auto psm = static_cast<tesseract::PageSegMode>(
+      value.As<Napi::Number>().Int32Value());
+  if (psm < 0 || psm >= tesseract::PageSegMode::PSM_COUNT) {
+    return ParseStatus::OutOfRange;
+  }
 
-  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
-  deferred.Reject(error.Value());
-  return deferred.Promise();
+  out = psm;
+  return ParseStatus::Ok;
 }
 
-Napi::Value RejectError(Napi::Env env, const std::string &message,
-                        const char *method) {
-  return RejectWithError(env, Napi::Error::New(env, message),
-                         "ERR_TESSERACT_RUNTIME", message, method);
+// Parses an object of string variables, sorted by name; leaves `vars`
+// untouched when `value` is undefined. InvalidType for a non-object or a
+// non-string value.
+ParseStatus ParseVariables(const Napi::Value &value, VariableOverlay &vars) {
+  if (value.IsUndefined()) {
+    return ParseStatus::Ok;
+  }
+  if (!value.IsObject()) {
+    return ParseStatus::InvalidType;
+  }
+
+  auto object = value.As<Napi::Object>();
+  Napi::Array names = object.GetPropertyNames();
+  vars.clear();
+  vars.reserve(names.Length());
+  for (uint32_t i = 0; i < names.Length(); ++i) {
+    const Napi::Value name = names.Get(i);
+    const Napi::Value variable = object.Get(name);
+    if (!name.IsString() || !variable.IsString()) {
+      return ParseStatus::InvalidType;
+    }
+    vars.emplace_back(name.As<Napi::String>().Utf8Value(),
+                      variable.As<Napi::String>().Utf8Value());
+  }
+  SortOverlay(vars);
+  return ParseStatus::Ok;
 }
 
-Napi::Value RejectTypeError(Napi::Env env, const std::string &message,
-                            const char *method) {
-  return RejectWithError(env, Napi::TypeError::New(env, message),
-                         "ERR_INVALID_ARGUMENT", message, method);
+// Parses a list of "text", "hocr", "tsv" and "alto"; leaves the flags
+// untouched when `value` is undefined. InvalidType for a non-array,
+// OutOfRange for an unknown entry.
+ParseStatus ParseFileOutputs(const Napi::Value &value, bool &text, bool &hocr,
+                             bool &tsv, bool &alto) {
+  if (value.IsUndefined()) {
+    return ParseStatus::Ok;
+  }
+  if (!value.IsArray()) {
+    return ParseStatus::InvalidType;
+  }
+
+  text = hocr = tsv = alto = false;
+  Napi::Array list = value.As<Napi::Array>();
+  for (uint32_t i = 0; i < list.Length(); ++i) {
+    const Napi::Value item = list.Get(i);
+    const std::string output =
+        item.IsString() ? item.As<Napi::String>().Utf8Value() : "";
+    if (output == "text") {
+      text = true;
+    } else if (output == "hocr") {
+      hocr = true;
+    } else if (output == "tsv") {
+      tsv = true;
+    } else if (output == "alto") {
+      alto = true;
+    } else {
+      return ParseStatus::OutOfRange;
+    }
+  }
+  return ParseStatus::Ok;
 }
 
-Napi::Value RejectRangeError(Napi::Env env, const std::string &message,
-                             const char *method) {
-  return RejectWithError(env, Napi::RangeError::New(env, message),
-                         "ERR_OUT_OF_RANGE", message, method);
+void ThrowConstructorError(Napi::Env env, Napi::Error error,
+                           const char *code) {
+  error.Set("code", Napi::String::New(env, code));
+  error.Set("method", Napi::String::New(env, "constructor"));
+  error.ThrowAsJavaScriptException();
 }
 
-bool HasArg(const Napi::CallbackInfo &info, size_t index) {
-  return info.Length() > index && !info[index].IsUndefined();
+// Reads `new Tesseract({ queueCapacity })`. On invalid options a
+// JS exception is left pending, which makes `new` throw, and the defaults
+// are returned.
+QueueOptions ParseQueueOptions(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (!HasArg(info, 0)) {
+    return QueueOptions{};
+  }
+  if (!info[0].IsObject()) {
+    ThrowConstructorError(
+        env,
+        Napi::TypeError::New(env,
+                             "Tesseract(options): options must be an object"),
+        "ERR_INVALID_ARGUMENT");
+    return QueueOptions{};
+  }
+  auto options = info[0].As<Napi::Object>();
+  QueueOptions queue{};
+
+  const Napi::Value capacity = options.Get("queueCapacity");
+  if (!capacity.IsUndefined()) {
+    if (!capacity.IsNumber()) {
+      ThrowConstructorError(
+          env,
+          Napi::TypeError::New(env, "Tesseract(options): "
+                                    "options.queueCapacity must be a number"),
+          "ERR_INVALID_ARGUMENT");
+      return QueueOptions{};
+    }
+    const double value = capacity.As<Napi::Number>().DoubleValue();
+    if (!(value >= 1 && value <= static_cast<double>(kMaxQueueCapacity)) ||
+        value != static_cast<double>(static_cast<int64_t>(value))) {
+      ThrowConstructorError(
+          env,
+          Napi::RangeError::New(env, "Tesseract(options): "
+                                     "options.queueCapacity must be an "
+                                     "integer between 1 and 1048576"),
+          "ERR_OUT_OF_RANGE");
+      return QueueOptions{};
+    }
+    queue.capacity = static_cast<size_t>(value);
+  }
+
+  return queue;
+}
+
+// Reads the optional `filename` and `progressCallback` page options. Returns
+// the message for a TypeError if one is invalid.
+std::optional<std::string>
+ParsePageOptions(Napi::Env env, const Napi::Object &options,
+                 const char *signature, std::string &filename,
+                 std::shared_ptr<MonitorContext> &monitor_context) {
+  Napi::Value filename_value = options.Get("filename");
+  if (!filename_value.IsUndefined() && !filename_value.IsNull()) {
+    if (!filename_value.IsString()) {
+      return std::format("{}: options.filename must be a string", signature);
+    }
+    filename = filename_value.As<Napi::String>().Utf8Value();
+  }
+
+  Napi::Value progress_callback_value = options.Get("progressCallback");
+  if (!progress_callback_value.IsUndefined() &&
+      !progress_callback_value.IsNull()) {
+    if (!progress_callback_value.IsFunction()) {
+      return std::format("{}: options.progressCallback must be a function",
+                         signature);
+    }
+
+    Napi::Function progress_callback =
+        progress_callback_value.As<Napi::Function>();
+    Napi::ThreadSafeFunction progress_tsfn = Napi::ThreadSafeFunction::New(
+        env, progress_callback, "tesseract_progress_callback", 0, 1);
+    monitor_context =
+        std::make_shared<MonitorContext>(std::move(progress_tsfn));
+  }
+
+  return std::nullopt;
 }
 
 } // namespace
@@ -89,9 +230,13 @@ Napi::Object TesseractWrapper::InitAddon(Napi::Env env, Napi::Object exports) {
           InstanceMethod("initForAnalysePage",
                          &TesseractWrapper::InitForAnalysePage),
           InstanceMethod("analyseLayout", &TesseractWrapper::AnalyseLayout),
+          InstanceMethod("getComponentImages",
+                         &TesseractWrapper::GetComponentImages),
           InstanceMethod("beginProcessPages",
                          &TesseractWrapper::BeginProcessPages),
           InstanceMethod("addProcessPage", &TesseractWrapper::AddProcessPage),
+          InstanceMethod("addProcessPageFromFile",
+                         &TesseractWrapper::AddProcessPageFromFile),
           InstanceMethod("finishProcessPages",
                          &TesseractWrapper::FinishProcessPages),
           InstanceMethod("abortProcessPages",
@@ -108,6 +253,8 @@ Napi::Object TesseractWrapper::InitAddon(Napi::Env env, Napi::Object exports) {
           InstanceMethod("getStringVariable",
                          &TesseractWrapper::GetStringVariable),
           InstanceMethod("setImage", &TesseractWrapper::SetImage),
+          InstanceMethod("setImageFromFile",
+                         &TesseractWrapper::SetImageFromFile),
           // InstanceMethod("printVariables",
           // &TesseractWrapper::PrintVariables),
           InstanceMethod("setPageMode", &TesseractWrapper::SetPageMode),
@@ -115,6 +262,16 @@ Napi::Object TesseractWrapper::InitAddon(Napi::Env env, Napi::Object exports) {
           InstanceMethod("setSourceResolution",
                          &TesseractWrapper::SetSourceResolution),
           InstanceMethod("recognize", &TesseractWrapper::Recognize),
+          InstanceMethod("recognizeFile", &TesseractWrapper::RecognizeFile),
+          InstanceMethod("createProfile", &TesseractWrapper::CreateProfile),
+          InstanceMethod("recognizeWithProfile",
+                         &TesseractWrapper::RecognizeWithProfile),
+          InstanceMethod("recognizeRegions",
+                         &TesseractWrapper::RecognizeRegions),
+          InstanceMethod("recognizeFrame", &TesseractWrapper::RecognizeFrame),
+          InstanceMethod("initCascade", &TesseractWrapper::InitCascade),
+          InstanceMethod("recognizeCascade",
+                         &TesseractWrapper::RecognizeCascade),
           InstanceMethod("detectOrientationScript",
                          &TesseractWrapper::DetectOrientationScript),
           InstanceMethod("meanTextConf", &TesseractWrapper::MeanTextConf),
@@ -137,19 +294,34 @@ Napi::Object TesseractWrapper::InitAddon(Napi::Env env, Napi::Object exports) {
                          &TesseractWrapper::GetLoadedLanguages),
           InstanceMethod("getAvailableLanguages",
                          &TesseractWrapper::GetAvailableLanguages),
+          InstanceMethod("getThreadingConfig",
+                         &TesseractWrapper::GetThreadingConfig),
+          InstanceMethod("getMemoryUsage", &TesseractWrapper::GetMemoryUsage),
+          InstanceMethod("getStatus", &TesseractWrapper::GetStatus),
+          InstanceMethod("waitForCapacity",
+                         &TesseractWrapper::WaitForCapacity),
           InstanceMethod("clear", &TesseractWrapper::Clear),
           InstanceMethod("end", &TesseractWrapper::End),
       });
 
-  constructor = Napi::Persistent(func);
-  constructor.SuppressDestruct();
+  auto *data = new AddonData{};
+  data->tesseract_constructor = Napi::Persistent(func);
+  data->profile_constructor = Napi::Persistent(TesseractProfile::Define(env));
+  env.SetInstanceData<AddonData>(data);
+
   exports.Set("Tesseract", func);
   return exports;
 }
 
 TesseractWrapper::TesseractWrapper(const Napi::CallbackInfo &info)
     : Napi::ObjectWrap<TesseractWrapper>(info), _env(info.Env()),
-      _worker_thread(info.Env()) {}
+      _worker_thread(info.Env(), ParseQueueOptions(info)) {
+  // an invalid option has thrown, so the object never reaches JS
+  if (info.Env().IsExceptionPending()) {
+    return;
+  }
+  _worker_thread.Start();
+}
 
 TesseractWrapper::~TesseractWrapper() {}
 
@@ -165,7 +337,7 @@ Napi::Value TesseractWrapper::IsInitialized(const Napi::CallbackInfo &info) {
                            "isInitialized");
   }
 
-  return _worker_thread.Enqueue(CommandIsInitialized{});
+  return _worker_thread.IsInitialized();
 }
 
 Napi::Value TesseractWrapper::SetInputName(const Napi::CallbackInfo &info) {
@@ -400,6 +572,115 @@ Napi::Value TesseractWrapper::Init(const Napi::CallbackInfo &info) {
         set_only_non_debug_params.As<Napi::Boolean>().Value();
   }
 
+  const Napi::Value intra_op_threads = options.Get("intraOpThreads");
+  if (!intra_op_threads.IsUndefined()) {
+    if (!intra_op_threads.IsNumber()) {
+      return RejectTypeError(
+          env, "init(options): options.intraOpThreads must be a number",
+          "init");
+    }
+
+    const int32_t threads = intra_op_threads.As<Napi::Number>().Int32Value();
+    if (threads < 1) {
+      return RejectRangeError(
+          env, "init(options): options.intraOpThreads must be at least 1",
+          "init");
+    }
+
+    command.intra_op_threads = threads;
+  }
+
+  const Napi::Value memory_budget = options.Get("memoryBudget");
+  if (!memory_budget.IsUndefined()) {
+    if (!memory_budget.IsNumber()) {
+      return RejectTypeError(
+          env, "init(options): options.memoryBudget must be a number", "init");
+    }
+
+    const int64_t budget = memory_budget.As<Napi::Number>().Int64Value();
+    if (budget < 0) {
+      return RejectRangeError(
+          env, "init(options): options.memoryBudget must not be negative",
+          "init");
+    }
+
+    command.memory_budget = budget;
+  }
+
+  const Napi::Value image_limits = options.Get("imageLimits");
+  if (!image_limits.IsUndefined()) {
+    if (!image_limits.IsObject()) {
+      return RejectTypeError(
+          env, "init(options): options.imageLimits must be an object", "init");
+    }
+
+    auto limits_object = image_limits.As<Napi::Object>();
+    ImageLimits limits{};
+    const std::pair<const char *, int64_t *> fields[] = {
+        {"maxWidth", &limits.max_width},   {"maxHeight", &limits.max_height},
+        {"maxPixels", &limits.max_pixels}, {"maxBytes", &limits.max_bytes},
+        {"maxPages", &limits.max_pages},
+    };
+    for (const auto &[name, out] : fields) {
+      const Napi::Value value = limits_object.Get(name);
+      if (value.IsUndefined()) {
+        continue;
+      }
+      const std::string field =
+          std::string("init(options): options.imageLimits.") + name;
+      if (!value.IsNumber()) {
+        return RejectTypeError(env, field + " must be a number", "init");
+      }
+      *out = value.As<Napi::Number>().Int64Value();
+      if (*out < 0) {
+        return RejectRangeError(env, field + " must not be negative", "init");
+      }
+    }
+
+    const Napi::Value downscale = limits_object.Get("downscale");
+    if (!downscale.IsUndefined()) {
+      if (!downscale.IsBoolean()) {
+        return RejectTypeError(
+            env,
+            "init(options): options.imageLimits.downscale must be a boolean",
+            "init");
+      }
+      limits.downscale = downscale.As<Napi::Boolean>().Value();
+    }
+
+    command.image_limits = limits;
+  }
+
+  const Napi::Value cpu_affinity = options.Get("cpuAffinity");
+  if (!cpu_affinity.IsUndefined()) {
+    if (!cpu_affinity.IsArray()) {
+      return RejectTypeError(
+          env, "init(options): options.cpuAffinity must be an array of numbers",
+          "init");
+    }
+
+    Napi::Array cpus = cpu_affinity.As<Napi::Array>();
+    const uint32_t len = cpus.Length();
+    command.cpu_affinity.reserve(len);
+
+    for (uint32_t i = 0; i < len; ++i) {
+      Napi::Value item = cpus.Get(i);
+      if (!item.IsNumber()) {
+        return RejectTypeError(
+            env, "init(options): options.cpuAffinity must contain only numbers",
+            "init");
+      }
+
+      const int32_t cpu = item.As<Napi::Number>().Int32Value();
+      if (cpu < 0) {
+        return RejectRangeError(
+            env, "init(options): options.cpuAffinity contains a negative cpu",
+            "init");
+      }
+      command.cpu_affinity.push_back(cpu);
+    }
+  }
+
   const Napi::Value v = options.Get("configs");
   if (!v.IsUndefined()) {
     if (!v.IsArray()) {
@@ -493,6 +774,90 @@ Napi::Value TesseractWrapper::AnalyseLayout(const Napi::CallbackInfo &info) {
   return _worker_thread.Enqueue(command);
 }
 
+Napi::Value
+TesseractWrapper::GetComponentImages(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandGetComponentImages command{};
+
+  if (info.Length() > 1) {
+    return RejectTypeError(
+        env, "getComponentImages(options?): expected at most 1 argument",
+        "getComponentImages");
+  }
+
+  if (HasArg(info, 0)) {
+    if (!info[0].IsObject()) {
+      return RejectTypeError(
+          env, "getComponentImages(options?): options must be an object",
+          "getComponentImages");
+    }
+
+    auto options = info[0].As<Napi::Object>();
+
+    const Napi::Value level = options.Get("level");
+    if (!level.IsUndefined()) {
+      const std::string name =
+          level.IsString() ? level.As<Napi::String>().Utf8Value() : "";
+      if (name == "block") {
+        command.level = tesseract::RIL_BLOCK;
+      } else if (name == "paragraph") {
+        command.level = tesseract::RIL_PARA;
+      } else if (name == "textline") {
+        command.level = tesseract::RIL_TEXTLINE;
+      } else if (name == "word") {
+        command.level = tesseract::RIL_WORD;
+      } else {
+        return RejectTypeError(env,
+                               "getComponentImages(options?): options.level "
+                               "must be 'block', 'paragraph', 'textline' or "
+                               "'word'",
+                               "getComponentImages");
+      }
+    }
+
+    const Napi::Value text_only = options.Get("textOnly");
+    if (!text_only.IsUndefined()) {
+      if (!text_only.IsBoolean()) {
+        return RejectTypeError(
+            env,
+            "getComponentImages(options?): options.textOnly must be a boolean",
+            "getComponentImages");
+      }
+      command.text_only = text_only.As<Napi::Boolean>().Value();
+    }
+
+    const Napi::Value raw = options.Get("raw");
+    if (!raw.IsUndefined()) {
+      if (!raw.IsBoolean()) {
+        return RejectTypeError(
+            env, "getComponentImages(options?): options.raw must be a boolean",
+            "getComponentImages");
+      }
+      command.raw_image = raw.As<Napi::Boolean>().Value();
+    }
+
+    const Napi::Value padding = options.Get("padding");
+    if (!padding.IsUndefined()) {
+      if (!padding.IsNumber()) {
+        return RejectTypeError(
+            env,
+            "getComponentImages(options?): options.padding must be a number",
+            "getComponentImages");
+      }
+      const int32_t value = padding.As<Napi::Number>().Int32Value();
+      if (value < 0) {
+        return RejectRangeError(env,
+                                "getComponentImages(options?): "
+                                "options.padding must be non-negative",
+                                "getComponentImages");
+      }
+      command.raw_padding = value;
+    }
+  }
+
+  return _worker_thread.Enqueue(command);
+}
+
 Napi::Value
 TesseractWrapper::BeginProcessPages(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
@@ -546,6 +911,65 @@ TesseractWrapper::BeginProcessPages(const Napi::CallbackInfo &info) {
     command.textonly = textonly.As<Napi::Boolean>().Value();
   }
 
+  const Napi::Value page_image = options.Get("pageImage");
+  if (!page_image.IsUndefined()) {
+    if (!page_image.IsObject()) {
+      return RejectTypeError(env,
+                             "beginProcessPages(options): options.pageImage "
+                             "must be an object",
+                             "beginProcessPages");
+    }
+
+    auto image_object = page_image.As<Napi::Object>();
+    PdfImagePolicy policy{};
+    const Napi::Value mode = image_object.Get("mode");
+    const std::string mode_name =
+        mode.IsString() ? mode.As<Napi::String>().Utf8Value() : "";
+    if (mode_name == "keep") {
+      policy.mode = PdfImagePolicy::Mode::Keep;
+    } else if (mode_name == "jpeg") {
+      policy.mode = PdfImagePolicy::Mode::Jpeg;
+    } else if (mode_name == "bilevel") {
+      policy.mode = PdfImagePolicy::Mode::Bilevel;
+    } else {
+      return RejectTypeError(env,
+                             "beginProcessPages(options): "
+                             "options.pageImage.mode must be \"keep\", "
+                             "\"jpeg\" or \"bilevel\"",
+                             "beginProcessPages");
+    }
+
+    const std::tuple<const char *, int *, int, int> fields[] = {
+        {"dpi", &policy.dpi, 1, 2400},
+        {"jpegQuality", &policy.jpeg_quality, 1, 100},
+    };
+    for (const auto &[name, out, min, max] : fields) {
+      const Napi::Value value = image_object.Get(name);
+      if (value.IsUndefined()) {
+        continue;
+      }
+      const std::string field =
+          std::string("beginProcessPages(options): options.pageImage.") +
+          name;
+      if (!value.IsNumber()) {
+        return RejectTypeError(env, field + " must be a number",
+                               "beginProcessPages");
+      }
+      if (policy.mode != PdfImagePolicy::Mode::Jpeg) {
+        return RejectRangeError(env, field + " needs mode \"jpeg\"",
+                                "beginProcessPages");
+      }
+      *out = value.As<Napi::Number>().Int32Value();
+      if (*out < min || *out > max) {
+        return RejectRangeError(
+            env, std::format("{} must be between {} and {}", field, min, max),
+            "beginProcessPages");
+      }
+    }
+
+    command.image_policy = policy;
+  }
+
   return _worker_thread.Enqueue(std::move(command));
 }
 
@@ -576,36 +1000,50 @@ Napi::Value TesseractWrapper::AddProcessPage(const Napi::CallbackInfo &info) {
                            "addProcessPage");
   }
 
-  Napi::Value filename_value = options.Get("filename");
-  if (!filename_value.IsUndefined() && !filename_value.IsNull()) {
-    if (!filename_value.IsString()) {
-      return RejectTypeError(
-          env, "addProcessPage(options): options.filename must be a string",
-          "addProcessPage");
-    }
-    command.filename = filename_value.As<Napi::String>().Utf8Value();
+  if (auto error = ParsePageOptions(env, options, "addProcessPage(options)",
+                                    command.filename,
+                                    command.monitor_context)) {
+    return RejectTypeError(env, *error, "addProcessPage");
   }
 
-  Napi::Value progress_callback_value = options.Get("progressCallback");
-  if (!progress_callback_value.IsUndefined() &&
-      !progress_callback_value.IsNull()) {
-    if (!progress_callback_value.IsFunction()) {
-      return RejectTypeError(env,
-                             "addProcessPage(options): "
-                             "options.progressCallback must be a function",
-                             "addProcessPage");
-    }
+  command.page.bytes.resize(length);
+  std::memcpy(command.page.bytes.data(), page_buffer.Data(), length);
 
-    Napi::Function progress_callback =
-        progress_callback_value.As<Napi::Function>();
-    Napi::ThreadSafeFunction progress_tsfn = Napi::ThreadSafeFunction::New(
-        env, progress_callback, "tesseract_progress_callback", 0, 1);
-    command.monitor_context =
-        std::make_shared<MonitorContext>(std::move(progress_tsfn));
+  return _worker_thread.Enqueue(std::move(command));
+}
+
+Napi::Value
+TesseractWrapper::AddProcessPageFromFile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandAddProcessPageFromFile command{};
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsString()) {
+    return RejectTypeError(env,
+                           "addProcessPageFromFile(path, options?): path "
+                           "must be a string",
+                           "addProcessPageFromFile");
+  }
+  command.path = info[0].As<Napi::String>().Utf8Value();
+  if (command.path.empty()) {
+    return RejectTypeError(
+        env, "addProcessPageFromFile(path, options?): path is empty",
+        "addProcessPageFromFile");
   }
 
-  command.page.bytes.resize(length);
-  std::memcpy(command.page.bytes.data(), page_buffer.Data(), length);
+  if (HasArg(info, 1)) {
+    if (!info[1].IsObject()) {
+      return RejectTypeError(env,
+                             "addProcessPageFromFile(path, options?): "
+                             "options must be an object",
+                             "addProcessPageFromFile");
+    }
+    if (auto error = ParsePageOptions(
+            env, info[1].As<Napi::Object>(),
+            "addProcessPageFromFile(path, options?)", command.filename,
+            command.monitor_context)) {
+      return RejectTypeError(env, *error, "addProcessPageFromFile");
+    }
+  }
 
   return _worker_thread.Enqueue(std::move(command));
 }
@@ -634,7 +1072,7 @@ TesseractWrapper::GetProcessPagesStatus(const Napi::CallbackInfo &info) {
                            "getProcessPagesStatus");
   }
 
-  return _worker_thread.Enqueue(CommandGetProcessPagesStatus{});
+  return _worker_thread.GetProcessPagesStatus();
 }
 
 Napi::Value TesseractWrapper::SetDebugVariable(const Napi::CallbackInfo &info) {
@@ -798,7 +1236,14 @@ Napi::Value TesseractWrapper::SetImage(const Napi::CallbackInfo &info) {
                            "setImage");
   }
 
-  Pix *pix = pixReadMem(data, length);
+  Pix *pix = nullptr;
+  try {
+    pix = DecodeImage(data, length, _worker_thread.CurrentImageLimits(),
+                      "setImage(buffer)");
+  } catch (const ImageLimitError &error) {
+    return RejectWithError(env, Napi::Error::New(env, error.what()),
+                           "ERR_IMAGE_LIMIT", error.what(), "setImage");
+  }
   if (!pix) {
     return RejectError(env, "setImage(buffer): failed to decode image buffer",
                        "setImage");
@@ -858,6 +1303,24 @@ Napi::Value TesseractWrapper::SetImage(const Napi::CallbackInfo &info) {
   return _worker_thread.Enqueue(command);
 }
 
+Napi::Value
+TesseractWrapper::SetImageFromFile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandSetImageFromFile command{};
+
+  if (info.Length() != 1 || !info[0].IsString()) {
+    return RejectTypeError(env, "setImageFromFile(path): path must be a string",
+                           "setImageFromFile");
+  }
+  command.path = info[0].As<Napi::String>().Utf8Value();
+  if (command.path.empty()) {
+    return RejectTypeError(env, "setImageFromFile(path): path is empty",
+                           "setImageFromFile");
+  }
+
+  return _worker_thread.Enqueue(std::move(command));
+}
+
 Napi::Value TesseractWrapper::SetPageMode(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   CommandSetPageMode command{};
@@ -949,19 +1412,635 @@ TesseractWrapper::SetSourceResolution(const Napi::CallbackInfo &info) {
   return _worker_thread.Enqueue(command);
 }
 
+Napi::Value TesseractWrapper::RecognizeFile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandRecognizeFile command{};
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsString()) {
+    return RejectTypeError(
+        env, "recognizeFile(path, options?): path must be a string",
+        "recognizeFile");
+  }
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  if (path.empty()) {
+    return RejectTypeError(env, "recognizeFile(path, options?): path is empty",
+                           "recognizeFile");
+  }
+
+  size_t readahead = kDefaultReadahead;
+
+  if (HasArg(info, 1)) {
+    if (!info[1].IsObject()) {
+      return RejectTypeError(
+          env, "recognizeFile(path, options?): options must be an object",
+          "recognizeFile");
+    }
+
+    switch (ParseFileOutputs(info[1].As<Napi::Object>().Get("outputs"),
+                             command.text, command.hocr, command.tsv,
+                             command.alto)) {
+    case ParseStatus::InvalidType:
+      return RejectTypeError(env,
+                             "recognizeFile(path, options?): "
+                             "options.outputs must be an array",
+                             "recognizeFile");
+    case ParseStatus::OutOfRange:
+      return RejectTypeError(env,
+                             "recognizeFile(path, options?): "
+                             "options.outputs entries must be \"text\", "
+                             "\"hocr\", \"tsv\" or \"alto\"",
+                             "recognizeFile");
+    case ParseStatus::Ok:
+      break;
+    }
+
+    if (ParseVariables(info[1].As<Napi::Object>().Get("vars"),
+                       command.vars) != ParseStatus::Ok) {
+      return RejectTypeError(env,
+                             "recognizeFile(path, options?): "
+                             "options.vars must be an object of strings",
+                             "recognizeFile");
+    }
+
+    const Napi::Value readahead_option =
+        info[1].As<Napi::Object>().Get("readahead");
+    if (!readahead_option.IsUndefined()) {
+      if (!readahead_option.IsNumber()) {
+        return RejectTypeError(env,
+                               "recognizeFile(path, options?): "
+                               "options.readahead must be a number",
+                               "recognizeFile");
+      }
+      const double value = readahead_option.As<Napi::Number>().DoubleValue();
+      if (!(value >= 0 && value <= static_cast<double>(kMaxReadahead)) ||
+          value != static_cast<double>(static_cast<int64_t>(value))) {
+        return RejectRangeError(env,
+                                "recognizeFile(path, options?): "
+                                "options.readahead must be an integer "
+                                "between 0 and 64",
+                                "recognizeFile");
+      }
+      readahead = static_cast<size_t>(value);
+    }
+  }
+
+  command.image = _worker_thread.Prefetch(path, readahead);
+  command.path = std::move(path);
+  return _worker_thread.Enqueue(std::move(command));
+}
+
+Napi::Function TesseractProfile::Define(Napi::Env env) {
+  return DefineClass(env, "TesseractProfile", {});
+}
+
+Napi::Value TesseractWrapper::CreateProfile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 1 || !info[0].IsObject()) {
+    return RejectTypeError(
+        env, "createProfile(options): options must be an object",
+        "createProfile");
+  }
+  auto options = info[0].As<Napi::Object>();
+  auto profile = std::make_shared<JobProfile>();
+
+  switch (ParseOptionalPsm(options.Get("psm"), profile->psm)) {
+  case ParseStatus::InvalidType:
+    return RejectTypeError(
+        env, "createProfile(options): options.psm must be a number",
+        "createProfile");
+  case ParseStatus::OutOfRange:
+    return RejectRangeError(
+        env, "createProfile(options): options.psm is out of range",
+        "createProfile");
+  case ParseStatus::Ok:
+    break;
+  }
+
+  const Napi::Value rect = options.Get("rect");
+  if (!rect.IsUndefined()) {
+    if (!rect.IsObject()) {
+      return RejectTypeError(
+          env, "createProfile(options): options.rect must be an object",
+          "createProfile");
+    }
+    auto rect_object = rect.As<Napi::Object>();
+    ProfileRect bounds{};
+    const std::tuple<const char *, int *, int> fields[] = {
+        {"left", &bounds.left, 0},
+        {"top", &bounds.top, 0},
+        {"width", &bounds.width, 1},
+        {"height", &bounds.height, 1},
+    };
+    for (const auto &[name, out, min] : fields) {
+      const Napi::Value value = rect_object.Get(name);
+      const std::string field =
+          std::string("createProfile(options): options.rect.") + name;
+      if (!value.IsNumber()) {
+        return RejectTypeError(env, field + " must be a number",
+                               "createProfile");
+      }
+      *out = value.As<Napi::Number>().Int32Value();
+      if (*out < min) {
+        return RejectRangeError(env,
+                                std::format("{} must be at least {}", field,
+                                            min),
+                                "createProfile");
+      }
+    }
+    profile->rect = bounds;
+  }
+
+  if (ParseVariables(options.Get("vars"), profile->variables) !=
+      ParseStatus::Ok) {
+    return RejectTypeError(env,
+                           "createProfile(options): options.vars must be an "
+                           "object of strings",
+                           "createProfile");
+  }
+  for (const auto &[name, value] : profile->variables) {
+    if (name.empty() || value.empty()) {
+      return RejectTypeError(env,
+                             "createProfile(options): options.vars must not "
+                             "contain empty names or values",
+                             "createProfile");
+    }
+  }
+
+  switch (ParseFileOutputs(options.Get("outputs"), profile->text,
+                           profile->hocr, profile->tsv, profile->alto)) {
+  case ParseStatus::InvalidType:
+    return RejectTypeError(
+        env, "createProfile(options): options.outputs must be an array",
+        "createProfile");
+  case ParseStatus::OutOfRange:
+    return RejectTypeError(env,
+                           "createProfile(options): options.outputs entries "
+                           "must be \"text\", \"hocr\", \"tsv\" or \"alto\"",
+                           "createProfile");
+  case ParseStatus::Ok:
+    break;
+  }
+
+  const Napi::Value timeout = options.Get("timeout");
+  if (!timeout.IsUndefined()) {
+    if (!timeout.IsNumber()) {
+      return RejectTypeError(
+          env, "createProfile(options): options.timeout must be a number",
+          "createProfile");
+    }
+    profile->timeout_millisec = timeout.As<Napi::Number>().Int32Value();
+    if (profile->timeout_millisec < 0) {
+      return RejectRangeError(
+          env, "createProfile(options): options.timeout must not be negative",
+          "createProfile");
+    }
+  }
+
+  CommandCheckProfileVariables command{};
+  for (const auto &[name, value] : profile->variables) {
+    command.names.push_back(name);
+  }
+
+  Napi::Object handle =
+      env.GetInstanceData<AddonData>()->profile_constructor.New({});
+  TesseractProfile::Unwrap(handle)->profile = std::move(profile);
+
+  if (command.names.empty()) {
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    deferred.Resolve(handle);
+    return deferred.Promise();
+  }
+
+  // Resolves with the handle once the worker accepted the variables. The
+  // handle is bound to the callback, which keeps it alive until then.
+  Napi::Promise checked = _worker_thread.Enqueue(std::move(command));
+  Napi::Function resolve = Napi::Function::New(
+      env, [](const Napi::CallbackInfo &info) -> Napi::Value {
+        return info[0];
+      });
+  Napi::Value bound = resolve.Get("bind").As<Napi::Function>().Call(
+      resolve, {env.Undefined(), handle});
+  return checked.Get("then").As<Napi::Function>().Call(checked, {bound});
+}
+
+Napi::Value
+TesseractWrapper::RecognizeWithProfile(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandRecognizeWithProfile command{};
+
+  if (info.Length() != 2 || !info[0].IsBuffer()) {
+    return RejectTypeError(
+        env, "recognizeWithProfile(image, profile): image must be a Buffer",
+        "recognizeWithProfile");
+  }
+  auto image = info[0].As<Napi::Buffer<uint8_t>>();
+  if (image.Length() == 0) {
+    return RejectTypeError(
+        env, "recognizeWithProfile(image, profile): image is empty",
+        "recognizeWithProfile");
+  }
+
+  const Napi::FunctionReference &profile_constructor =
+      env.GetInstanceData<AddonData>()->profile_constructor;
+  if (info[1].IsObject() &&
+      info[1].As<Napi::Object>().InstanceOf(profile_constructor.Value())) {
+    command.profile = TesseractProfile::Unwrap(info[1].As<Napi::Object>())
+                          ->profile;
+  }
+  if (command.profile == nullptr) {
+    return RejectTypeError(env,
+                           "recognizeWithProfile(image, profile): profile "
+                           "must come from createProfile(...)",
+                           "recognizeWithProfile");
+  }
+
+  command.bytes.assign(image.Data(), image.Data() + image.Length());
+  return _worker_thread.Enqueue(std::move(command));
+}
+
 Napi::Value TesseractWrapper::Recognize(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   CommandRecognize command{};
 
   if (HasArg(info, 0)) {
     if (!info[0].IsFunction()) {
+      return RejectTypeError(env,
+                             "recognize(progressCallback?, options?): "
+                             "progressCallback must be a function",
+                             "recognize");
+    }
+
+    Napi::Function progress_callback = info[0].As<Napi::Function>();
+    Napi::ThreadSafeFunction progress_tsfn = Napi::ThreadSafeFunction::New(
+        env, progress_callback, "tesseract_progress_callback", 0, 1);
+
+    command.monitor_context =
+        std::make_shared<MonitorContext>(std::move(progress_tsfn));
+  }
+
+  if (HasArg(info, 1)) {
+    if (!info[1].IsObject()) {
       return RejectTypeError(
           env,
-          "recognize(progressCallback?): progressCallback must be a function",
+          "recognize(progressCallback?, options?): options must be an object",
           "recognize");
     }
 
-    Napi::Function progress_callback = info[0].As<Napi::Function>();
+    const Napi::Value auto_rotate =
+        info[1].As<Napi::Object>().Get("autoRotate");
+    if (!auto_rotate.IsUndefined()) {
+      if (!auto_rotate.IsBoolean()) {
+        return RejectTypeError(env,
+                               "recognize(progressCallback?, options?): "
+                               "options.autoRotate must be a boolean",
+                               "recognize");
+      }
+      command.auto_rotate = auto_rotate.As<Napi::Boolean>().Value();
+    }
+
+    if (ParseVariables(info[1].As<Napi::Object>().Get("vars"),
+                       command.vars) != ParseStatus::Ok) {
+      return RejectTypeError(env,
+                             "recognize(progressCallback?, options?): "
+                             "options.vars must be an object of strings",
+                             "recognize");
+    }
+  }
+
+  return _worker_thread.Enqueue(command);
+}
+
+Napi::Value TesseractWrapper::RecognizeRegions(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandRecognizeRegions command{};
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsArray()) {
+    return RejectTypeError(env,
+                           "recognizeRegions(regions, options?): regions must "
+                           "be an array of rectangles",
+                           "recognizeRegions");
+  }
+
+  if (HasArg(info, 1)) {
+    if (!info[1].IsObject()) {
+      return RejectTypeError(
+          env,
+          "recognizeRegions(regions, options?): options must be an object",
+          "recognizeRegions");
+    }
+
+    switch (ParseOptionalPsm(info[1].As<Napi::Object>().Get("psm"),
+                             command.psm)) {
+    case ParseStatus::InvalidType:
+      return RejectTypeError(
+          env,
+          "recognizeRegions(regions, options?): options.psm must be a number",
+          "recognizeRegions");
+    case ParseStatus::OutOfRange:
+      return RejectRangeError(
+          env,
+          "recognizeRegions(regions, options?): options.psm is out of range",
+          "recognizeRegions");
+    case ParseStatus::Ok:
+      break;
+    }
+  }
+
+  Napi::Array regions = info[0].As<Napi::Array>();
+  const uint32_t length = regions.Length();
+  command.regions.reserve(length);
+
+  for (uint32_t i = 0; i < length; ++i) {
+    Napi::Value item = regions.Get(i);
+    if (!item.IsObject()) {
+      return RejectTypeError(env,
+                             "recognizeRegions(regions, options?): regions "
+                             "must contain only objects",
+                             "recognizeRegions");
+    }
+
+    Napi::Object rectangle = item.As<Napi::Object>();
+    Napi::Value maybe_left = rectangle.Get("left");
+    Napi::Value maybe_top = rectangle.Get("top");
+    Napi::Value maybe_width = rectangle.Get("width");
+    Napi::Value maybe_height = rectangle.Get("height");
+
+    if (!maybe_left.IsNumber() || !maybe_top.IsNumber() ||
+        !maybe_width.IsNumber() || !maybe_height.IsNumber()) {
+      return RejectTypeError(env,
+                             "recognizeRegions(regions, options?): "
+                             "region.left/top/width/height must be numbers",
+                             "recognizeRegions");
+    }
+
+    Region region{};
+    region.left = maybe_left.As<Napi::Number>().Int32Value();
+    region.top = maybe_top.As<Napi::Number>().Int32Value();
+    region.width = maybe_width.As<Napi::Number>().Int32Value();
+    region.height = maybe_height.As<Napi::Number>().Int32Value();
+
+    switch (ParseOptionalPsm(rectangle.Get("psm"), region.psm)) {
+    case ParseStatus::InvalidType:
+      return RejectTypeError(
+          env,
+          "recognizeRegions(regions, options?): region.psm must be a number",
+          "recognizeRegions");
+    case ParseStatus::OutOfRange:
+      return RejectRangeError(
+          env,
+          "recognizeRegions(regions, options?): region.psm is out of range",
+          "recognizeRegions");
+    case ParseStatus::Ok:
+      break;
+    }
+
+    command.regions.push_back(region);
+  }
+
+  return _worker_thread.Enqueue(std::move(command));
+}
+
+Napi::Value TesseractWrapper::RecognizeFrame(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandRecognizeFrame command{};
+
+  if (info.Length() < 1 || info.Length() > 2 || !info[0].IsObject()) {
+    return RejectTypeError(
+        env, "recognizeFrame(frame, options?): frame must be an object",
+        "recognizeFrame");
+  }
+
+  auto frame = info[0].As<Napi::Object>();
+  const Napi::Value data = frame.Get("data");
+  if (!data.IsBuffer()) {
+    return RejectTypeError(
+        env, "recognizeFrame(frame, options?): frame.data must be a Buffer",
+        "recognizeFrame");
+  }
+
+  const std::tuple<const char *, int *, bool> fields[] = {
+      {"width", &command.width, true},
+      {"height", &command.height, true},
+      {"bytesPerPixel", &command.bytes_per_pixel, true},
+      {"bytesPerLine", &command.bytes_per_line, false},
+  };
+  for (const auto &[name, out, required] : fields) {
+    const Napi::Value value = frame.Get(name);
+    if (value.IsUndefined() && !required) {
+      continue;
+    }
+    const std::string field =
+        std::string("recognizeFrame(frame, options?): frame.") + name;
+    if (!value.IsNumber()) {
+      return RejectTypeError(env, field + " must be a number",
+                             "recognizeFrame");
+    }
+    *out = value.As<Napi::Number>().Int32Value();
+    if (*out <= 0) {
+      return RejectRangeError(env, field + " must be positive",
+                              "recognizeFrame");
+    }
+  }
+
+  if (command.bytes_per_pixel != 1 && command.bytes_per_pixel != 3 &&
+      command.bytes_per_pixel != 4) {
+    return RejectRangeError(env,
+                            "recognizeFrame(frame, options?): "
+                            "frame.bytesPerPixel must be 1, 3 or 4",
+                            "recognizeFrame");
+  }
+  const int64_t row_bytes =
+      static_cast<int64_t>(command.width) * command.bytes_per_pixel;
+  if (command.bytes_per_line == 0) {
+    if (row_bytes > INT32_MAX) {
+      return RejectRangeError(
+          env, "recognizeFrame(frame, options?): frame.width is too large",
+          "recognizeFrame");
+    }
+    command.bytes_per_line = static_cast<int>(row_bytes);
+  }
+  if (command.bytes_per_line < row_bytes) {
+    return RejectRangeError(env,
+                            "recognizeFrame(frame, options?): "
+                            "frame.bytesPerLine is shorter than a row",
+                            "recognizeFrame");
+  }
+
+  auto buffer = data.As<Napi::Buffer<uint8_t>>();
+  const int64_t frame_bytes =
+      static_cast<int64_t>(command.bytes_per_line) * (command.height - 1) +
+      row_bytes;
+  if (static_cast<int64_t>(buffer.Length()) < frame_bytes) {
+    return RejectRangeError(
+        env,
+        std::format("recognizeFrame(frame, options?): frame.data holds {} "
+                    "bytes, the frame needs {}",
+                    buffer.Length(), frame_bytes),
+        "recognizeFrame");
+  }
+
+  if (HasArg(info, 1)) {
+    if (!info[1].IsObject()) {
+      return RejectTypeError(
+          env, "recognizeFrame(frame, options?): options must be an object",
+          "recognizeFrame");
+    }
+    auto options = info[1].As<Napi::Object>();
+
+    const Napi::Value tile_size = options.Get("tileSize");
+    if (!tile_size.IsUndefined()) {
+      if (!tile_size.IsNumber()) {
+        return RejectTypeError(env,
+                               "recognizeFrame(frame, options?): "
+                               "options.tileSize must be a number",
+                               "recognizeFrame");
+      }
+      command.tile_size = tile_size.As<Napi::Number>().Int32Value();
+      if (command.tile_size < 8 || command.tile_size > 1024) {
+        return RejectRangeError(env,
+                                "recognizeFrame(frame, options?): "
+                                "options.tileSize must be between 8 and 1024",
+                                "recognizeFrame");
+      }
+    }
+
+    const Napi::Value reset = options.Get("reset");
+    if (!reset.IsUndefined()) {
+      if (!reset.IsBoolean()) {
+        return RejectTypeError(env,
+                               "recognizeFrame(frame, options?): "
+                               "options.reset must be a boolean",
+                               "recognizeFrame");
+      }
+      command.reset = reset.As<Napi::Boolean>().Value();
+    }
+  }
+
+  command.bytes.assign(buffer.Data(),
+                       buffer.Data() + static_cast<size_t>(frame_bytes));
+  return _worker_thread.Enqueue(std::move(command));
+}
+
+Napi::Value TesseractWrapper::InitCascade(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 1 || !info[0].IsObject()) {
+    return RejectTypeError(env,
+                           "initCascade(options): required argument at index "
+                           "0 must be an object",
+                           "initCascade");
+  }
+
+  auto options = info[0].As<Napi::Object>();
+  CommandInitCascade command{};
+
+  const Napi::Value data_path = options.Get("dataPath");
+  if (!data_path.IsUndefined()) {
+    if (!data_path.IsString()) {
+      return RejectTypeError(
+          env, "initCascade(options): options.dataPath must be a string",
+          "initCascade");
+    }
+    command.data_path = data_path.As<Napi::String>().Utf8Value();
+  }
+
+  const Napi::Value langs = options.Get("langs");
+  if (!langs.IsUndefined()) {
+    if (!langs.IsArray()) {
+      return RejectTypeError(env,
+                             "initCascade(options): options.langs must be an "
+                             "array of strings",
+                             "initCascade");
+    }
+
+    Napi::Array languages = langs.As<Napi::Array>();
+    for (uint32_t i = 0; i < languages.Length(); ++i) {
+      if (!languages.Get(i).IsString())
+        continue;
+      if (!command.language.empty())
+        command.language += "+";
+      command.language += languages.Get(i).As<Napi::String>().Utf8Value();
+    }
+  }
+
+  const Napi::Value oem = options.Get("oem");
+  if (!oem.IsUndefined()) {
+    if (!oem.IsNumber()) {
+      return RejectTypeError(
+          env, "initCascade(options): options.oem must be a number",
+          "initCascade");
+    }
+    const int32_t mode = oem.As<Napi::Number>().Int32Value();
+    if (mode < 0 || mode >= tesseract::OEM_COUNT) {
+      return RejectRangeError(
+          env, "initCascade(options): options.oem is out of supported range",
+          "initCascade");
+    }
+    command.oem = static_cast<tesseract::OcrEngineMode>(mode);
+  }
+
+  return _worker_thread.Enqueue(std::move(command));
+}
+
+Napi::Value TesseractWrapper::RecognizeCascade(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  CommandRecognizeCascade command{};
+
+  if (HasArg(info, 0)) {
+    if (!info[0].IsObject()) {
+      return RejectTypeError(env,
+                             "recognizeCascade(options?, progressCallback?): "
+                             "options must be an object",
+                             "recognizeCascade");
+    }
+
+    auto options = info[0].As<Napi::Object>();
+
+    const Napi::Value min_confidence = options.Get("minConfidence");
+    if (!min_confidence.IsUndefined()) {
+      if (!min_confidence.IsNumber()) {
+        return RejectTypeError(env,
+                               "recognizeCascade(options?, progressCallback?): "
+                               "options.minConfidence must be a number",
+                               "recognizeCascade");
+      }
+      const int32_t value = min_confidence.As<Napi::Number>().Int32Value();
+      if (value < 0 || value > 100) {
+        return RejectRangeError(env,
+                                "recognizeCascade(options?, progressCallback?):"
+                                " options.minConfidence must be in 0..100",
+                                "recognizeCascade");
+      }
+      command.min_confidence = value;
+    }
+
+    const Napi::Value level = options.Get("level");
+    if (!level.IsUndefined()) {
+      const std::string name =
+          level.IsString() ? level.As<Napi::String>().Utf8Value() : "";
+      if (name == "word") {
+        command.level = tesseract::RIL_WORD;
+      } else if (name == "textline") {
+        command.level = tesseract::RIL_TEXTLINE;
+      } else {
+        return RejectTypeError(env,
+                               "recognizeCascade(options?, progressCallback?): "
+                               "options.level must be 'word' or 'textline'",
+                               "recognizeCascade");
+      }
+    }
+  }
+
+  if (HasArg(info, 1)) {
+    if (!info[1].IsFunction()) {
+      return RejectTypeError(env,
+                             "recognizeCascade(options?, progressCallback?): "
+                             "progressCallback must be a function",
+                             "recognizeCascade");
+    }
+
+    Napi::Function progress_callback = info[1].As<Napi::Function>();
     Napi::ThreadSafeFunction progress_tsfn = Napi::ThreadSafeFunction::New(
         env, progress_callback, "tesseract_progress_callback", 0, 1);
 
@@ -969,7 +2048,7 @@ Napi::Value TesseractWrapper::Recognize(const Napi::CallbackInfo &info) {
         std::make_shared<MonitorContext>(std::move(progress_tsfn));
   }
 
-  return _worker_thread.Enqueue(command);
+  return _worker_thread.Enqueue(std::move(command));
 }
 
 Napi::Value
@@ -1183,6 +2262,31 @@ TesseractWrapper::GetAvailableLanguages(const Napi::CallbackInfo &info) {
   return _worker_thread.Enqueue(CommandGetAvailableLanguages{});
 }
 
+Napi::Value
+TesseractWrapper::GetThreadingConfig(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() > 0) {
+    return RejectTypeError(env, "getThreadingConfig(): expected no arguments",
+                           "getThreadingConfig");
+  }
+
+  return _worker_thread.Enqueue(CommandGetThreadingConfig{});
+}
+
+Napi::Value TesseractWrapper::GetMemoryUsage(const Napi::CallbackInfo &info) {
+  return _worker_thread.GetMemoryUsage();
+}
+
+Napi::Value TesseractWrapper::GetStatus(const Napi::CallbackInfo &info) {
+  return _worker_thread.GetStatus();
+}
+
+Napi::Value
+TesseractWrapper::WaitForCapacity(const Napi::CallbackInfo &info) {
+  return _worker_thread.WaitForCapacity();
+}
+
 Napi::Value TesseractWrapper::Clear(const Napi::CallbackInfo &info) {
   return _worker_thread.Enqueue(CommandClear{});
 }
@@ -16,11 +16,34 @@
 
 #pragma once
 
+#include "profile.hpp"
 #include "worker_thread.hpp"
+#include <memory>
 #include <napi.h>
 #include <tesseract/baseapi.h>
 #include <tesseract/publictypes.h>
 
+// Per-environment addon state. The main thread and every worker_threads
+// Worker that loads the addon get their own copy, owned by that environment
+// through napi_set_instance_data and freed when it is torn down.
+struct AddonData {
+  Napi::FunctionReference tesseract_constructor;
+  Napi::FunctionReference profile_constructor;
+};
+
+// JS handle of a JobProfile, returned by Tesseract#createProfile. It holds
+// only the validated options, so any instance may use it.
+class TesseractProfile : public Napi::ObjectWrap<TesseractProfile> {
+public:
+  static Napi::Function Define(Napi::Env env);
+
+  explicit TesseractProfile(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<TesseractProfile>(info) {}
+
+  // null for objects not made by createProfile
+  std::shared_ptr<const JobProfile> profile;
+};
+
 class TesseractWrapper : public Napi::ObjectWrap<TesseractWrapper> {
 
 public:
@@ -32,8 +55,6 @@ public:
   Napi::Env Env() const { return _env; }
 
 private:
-  static Napi::FunctionReference constructor;
-
   // JS Methods
   Napi::Value Version(const Napi::CallbackInfo &info);
   Napi::Value IsInitialized(const Napi::CallbackInfo &info);
@@ -51,8 +72,10 @@ private:
   Napi::Value Init(const Napi::CallbackInfo &info);
   Napi::Value InitForAnalysePage(const Napi::CallbackInfo &info);
   Napi::Value AnalyseLayout(const Napi::CallbackInfo &info);
+  Napi::Value GetComponentImages(const Napi::CallbackInfo &info);
   Napi::Value BeginProcessPages(const Napi::CallbackInfo &info);
   Napi::Value AddProcessPage(const Napi::CallbackInfo &info);
+  Napi::Value AddProcessPageFromFile(const Napi::CallbackInfo &info);
   Napi::Value FinishProcessPages(const Napi::CallbackInfo &info);
   Napi::Value AbortProcessPages(const Napi::CallbackInfo &info);
   Napi::Value GetProcessPagesStatus(const Napi::CallbackInfo &info);
@@ -64,11 +87,19 @@ private:
   Napi::Value GetDoubleVariable(const Napi::CallbackInfo &info);
   Napi::Value GetStringVariable(const Napi::CallbackInfo &info);
   Napi::Value SetImage(const Napi::CallbackInfo &info);
+  Napi::Value SetImageFromFile(const Napi::CallbackInfo &info);
   // Napi::Value PrintVariables(const Napi::CallbackInfo &info);
   Napi::Value SetPageMode(const Napi::CallbackInfo &info);
   Napi::Value SetRectangle(const Napi::CallbackInfo &info);
   Napi::Value SetSourceResolution(const Napi::CallbackInfo &info);
   Napi::Value Recognize(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeFile(const Napi::CallbackInfo &info);
+  Napi::Value CreateProfile(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeWithProfile(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeRegions(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeFrame(const Napi::CallbackInfo &info);
+  Napi::Value InitCascade(const Napi::CallbackInfo &info);
+  Napi::Value RecognizeCascade(const Napi::CallbackInfo &info);
   Napi::Value DetectOrientationScript(const Napi::CallbackInfo &info);
   Napi::Value MeanTextConf(const Napi::CallbackInfo &info);
   Napi::Value AllWordConfidences(const Napi::CallbackInfo &info);
@@ -85,6 +116,10 @@ private:
   Napi::Value GetInitLanguages(const Napi::CallbackInfo &info);
   Napi::Value GetLoadedLanguages(const Napi::CallbackInfo &info);
   Napi::Value GetAvailableLanguages(const Napi::CallbackInfo &info);
+  Napi::Value GetThreadingConfig(const Napi::CallbackInfo &info);
+  Napi::Value GetMemoryUsage(const Napi::CallbackInfo &info);
+  Napi::Value GetStatus(const Napi::CallbackInfo &info);
+  Napi::Value WaitForCapacity(const Napi::CallbackInfo &info);
   Napi::Value Clear(const Napi::CallbackInfo &info);
   Napi::Value End(const Napi::CallbackInfo &info);
 
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "tracer.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Rings start small and double as their thread records more, up to this.
+constexpr uint64_t kInitialCapacity = uint64_t{1} << 10; // events
+constexpr uint64_t kMaxCapacity = uint64_t{1} << 16;
+
+enum class Kind : uint8_t { Complete, Async, Counter };
+
+struct EventCopy {
+  Kind kind;
+  const char *category;
+  const char *name;
+  int64_t start;
+  int64_t end;
+  uint64_t id;
+};
+
+// Fields are relaxed atomics, so a dump racing with the writer reads stale
+// or torn events rather than undefined behavior; torn ones are dropped.
+struct Event {
+  std::atomic<Kind> kind{Kind::Complete};
+  std::atomic<const char *> category{nullptr};
+  std::atomic<const char *> name{nullptr};
+  std::atomic<int64_t> start{0};
+  std::atomic<int64_t> end{0}; // Counter: the value
+  std::atomic<uint64_t> id{0};
+
+  void Store(const EventCopy &event) {
+    kind.store(event.kind, std::memory_order_relaxed);
+    category.store(event.category, std::memory_order_relaxed);
+    name.store(event.name, std::memory_order_relaxed);
+    start.store(event.start, std::memory_order_relaxed);
+    end.store(event.end, std::memory_order_relaxed);
+    id.store(event.id, std::memory_order_relaxed);
+  }
+  EventCopy Load() const {
+    return {kind.load(std::memory_order_relaxed),
+            category.load(std::memory_order_relaxed),
+            name.load(std::memory_order_relaxed),
+            start.load(std::memory_order_relaxed),
+            end.load(std::memory_order_relaxed),
+            id.load(std::memory_order_relaxed)};
+  }
+};
+
+// Single writer (the owning thread), single reader (a dump, under the
+// registry lock). The writer bumps `_claimed` before it touches a slot and
+// `_published` after, like a seqlock, so the reader can tell which of the
+// events it copied may have been overwritten meanwhile. The ring itself is
+// only replaced under the registry lock, so a dump never sees it change.
+class ThreadBuffer {
+public:
+  explicit ThreadBuffer(uint32_t tid) : tid(tid) {}
+
+  // `mutex` is the registry lock, taken only to grow the ring.
+  void Record(const EventCopy &copy, std::mutex &mutex) {
+    const uint64_t index = _claimed.load(std::memory_order_relaxed);
+    if (index >= _capacity && _capacity < kMaxCapacity) {
+      Grow(mutex);
+    }
+    _claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _events[index % _capacity].Store(copy);
+    _published.store(index + 1, std::memory_order_release);
+  }
+
+  // Appends the events published since the previous call.
+  void Collect(std::vector<EventCopy> &out) {
+    const uint64_t published = _published.load(std::memory_order_acquire);
+    const uint64_t from = std::max(
+        _collected, published > _capacity ? published - _capacity : 0);
+    const size_t first = out.size();
+    for (uint64_t i = from; i < published; ++i) {
+      out.push_back(_events[i % _capacity].Load());
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // slots the writer claimed while we copied may hold a mix of two events
+    const uint64_t claimed = _claimed.load(std::memory_order_relaxed);
+    const uint64_t intact_from = claimed > _capacity ? claimed - _capacity : 0;
+    if (intact_from > from) {
+      const size_t torn = static_cast<size_t>(
+          std::min<uint64_t>(intact_from - from, out.size() - first));
+      out.erase(out.begin() + first, out.begin() + first + torn);
+    }
+    _collected = published;
+  }
+
+  // Under the registry lock, while no thread writes: frees the ring and
+  // starts over as track `new_tid`.
+  void Reset(uint32_t new_tid) {
+    tid = new_tid;
+    thread_name.store(nullptr, std::memory_order_relaxed);
+    _events.reset();
+    _capacity = 0;
+    _claimed.store(0, std::memory_order_relaxed);
+    _published.store(0, std::memory_order_relaxed);
+    _collected = 0;
+  }
+
+  uint32_t tid; // under the registry lock
+  std::atomic<const char *> thread_name{nullptr};
+  bool retired{false}; // under the registry lock: the thread has ended
+
+private:
+  void Grow(std::mutex &mutex) {
+    std::scoped_lock lock(mutex);
+    const uint64_t capacity =
+        _capacity == 0 ? kInitialCapacity : _capacity * 2;
+    auto events = std::make_unique<Event[]>(capacity);
+    const uint64_t published = _published.load(std::memory_order_relaxed);
+    for (uint64_t i = published > _capacity ? published - _capacity : 0;
+         i < published; ++i) {
+      events[i % capacity].Store(_events[i % _capacity].Load());
+    }
+    _events = std::move(events);
+    _capacity = capacity;
+  }
+
+  std::unique_ptr<Event[]> _events;
+  uint64_t _capacity{0}; // written by the writer under the registry lock
+  std::atomic<uint64_t> _claimed{0};
+  std::atomic<uint64_t> _published{0};
+  uint64_t _collected{0}; // reader only
+};
+
+// Buffers of ended threads stay in `buffers`, so a dump still shows their
+// events; the dump then frees their rings. New threads take retired buffers
+// first, oldest first, so there are never more buffers than threads that
+// were tracing at the same time. Never destroyed: threads may record during
+// static destruction.
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  std::deque<ThreadBuffer *> retired;
+  uint32_t next_tid{0};
+};
+
+Registry &GetRegistry() {
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+thread_local bool t_exited = false; // the buffer was handed back
+thread_local const char *t_thread_name = nullptr;
+
+// Hands the thread's buffer back to the registry when the thread exits.
+struct BufferOwner {
+  ThreadBuffer *buffer{nullptr};
+
+  ~BufferOwner() {
+    t_buffer = nullptr;
+    t_exited = true; // later records, e.g. from other thread_locals, drop
+    if (buffer != nullptr) {
+      Registry &registry = GetRegistry();
+      std::scoped_lock lock(registry.mutex);
+      buffer->retired = true;
+      registry.retired.push_back(buffer);
+    }
+  }
+};
+thread_local BufferOwner t_owner;
+
+ThreadBuffer *CurrentBuffer() {
+  if (t_buffer != nullptr || t_exited) {
+    return t_buffer;
+  }
+  Registry &registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  ThreadBuffer *buffer = nullptr;
+  if (!registry.retired.empty()) {
+    // its thread's events are lost if they were not dumped yet
+    buffer = registry.retired.front();
+    registry.retired.pop_front();
+    buffer->Reset(++registry.next_tid);
+    buffer->retired = false;
+  } else {
+    registry.buffers.push_back(
+        std::make_unique<ThreadBuffer>(++registry.next_tid));
+    buffer = registry.buffers.back().get();
+  }
+  buffer->thread_name.store(t_thread_name, std::memory_order_relaxed);
+  t_owner.buffer = buffer;
+  t_buffer = buffer;
+  return buffer;
+}
+
+void Record(Kind kind, const char *category, const char *name, int64_t start,
+            int64_t end, uint64_t id) {
+  if (!TraceEnabled()) {
+    return;
+  }
+  if (ThreadBuffer *buffer = CurrentBuffer()) {
+    buffer->Record({kind, category, name, start, end, id},
+                   GetRegistry().mutex);
+  }
+}
+
+int ProcessId() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return static_cast<int>(::getpid());
+#endif
+}
+
+} // namespace
+
+void EnableTracing() {
+  trace_detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceThreadName(const char *name) {
+  t_thread_name = name;
+  if (t_buffer != nullptr) {
+    t_buffer->thread_name.store(name, std::memory_order_relaxed);
+  }
+}
+
+void TraceComplete(const char *category, const char *name, int64_t start) {
+  Record(Kind::Complete, category, name, start, TraceNow(), 0);
+}
+
+void TraceAsync(const char *category, const char *name, uint64_t id,
+                int64_t start, int64_t end) {
+  Record(Kind::Async, category, name, start, end, id);
+}
+
+void TraceCounter(const char *name, int64_t value) {
+  Record(Kind::Counter, "counter", name, TraceNow(), value, 0);
+}
+
+size_t DumpTrace(const std::string &path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw_runtime("dumpTrace: cannot open \"{}\"", path);
+  }
+
+  const int pid = ProcessId();
+  size_t count = 0;
+  bool first = true;
+  auto begin = [&](const char *phase, uint32_t tid) -> std::ostream & {
+    out << (first ? "\n" : ",\n") << "{\"ph\":\"" << phase
+        << "\",\"pid\":" << pid << ",\"tid\":" << tid;
+    first = false;
+    return out;
+  };
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  Registry &registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  std::vector<EventCopy> events;
+  for (const auto &buffer : registry.buffers) {
+    if (const char *name =
+            buffer->thread_name.load(std::memory_order_relaxed)) {
+      begin("M", buffer->tid)
+          << R"(,"name":"thread_name","args":{"name":")" << name << "\"}}";
+    }
+
+    events.clear();
+    buffer->Collect(events);
+    if (buffer->retired) {
+      buffer->Reset(buffer->tid); // nobody writes it any more
+    }
+    for (const EventCopy &event : events) {
+      switch (event.kind) {
+      case Kind::Complete:
+        begin("X", buffer->tid)
+            << ",\"cat\":\"" << event.category << "\",\"name\":\""
+            << event.name << "\",\"ts\":" << event.start
+            << ",\"dur\":" << event.end - event.start << "}";
+        break;
+      case Kind::Async:
+        for (const auto &[phase, ts] :
+             {std::pair{"b", event.start}, std::pair{"e", event.end}}) {
+          begin(phase, buffer->tid)
+              << ",\"cat\":\"" << event.category << "\",\"name\":\""
+              << event.name << "\",\"id\":" << event.id << ",\"ts\":" << ts
+              << "}";
+        }
+        break;
+      case Kind::Counter:
+        begin("C", buffer->tid)
+            << ",\"name\":\"" << event.name << "\",\"id\":" << buffer->tid
+            << ",\"ts\":" << event.start << R"(,"args":{"value":)"
+            << event.end << "}}";
+        break;
+      }
+    }
+    count += events.size();
+  }
+  out << "\n]}\n";
+
+  out.flush();
+  if (!out) {
+    throw_runtime("dumpTrace: failed to write \"{}\"", path);
+  }
+  return count;
+}
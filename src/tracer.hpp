@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Opt-in timeline of what the addon's threads spend their time on, dumped
+// as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Every thread records into a ring buffer of its own, so recording takes no
+// lock and never waits for a dump, except the few times its ring grows; a
+// thread that records faster than it is dumped loses its oldest events.
+// Buffers of ended threads are reused. While tracing is off, every call below
+// costs one relaxed load. Names and categories must be string literals:
+// only the pointer is kept.
+
+namespace trace_detail {
+inline std::atomic<bool> g_enabled{false};
+} // namespace trace_detail
+
+inline bool TraceEnabled() {
+  return trace_detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+// Tracing stays on until the process exits.
+void EnableTracing();
+
+// Microseconds on the trace clock (steady_clock).
+inline int64_t TraceNow() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Names the calling thread's track.
+void TraceThreadName(const char *name);
+
+// A span that ran on the calling thread from `start` until now.
+void TraceComplete(const char *category, const char *name, int64_t start);
+
+// A span that may cross threads, e.g. the wait between submission and
+// execution; `id` tells concurrent ones apart.
+void TraceAsync(const char *category, const char *name, uint64_t id,
+                int64_t start, int64_t end);
+
+// A sample of a value over time, drawn as a graph on the thread's track.
+void TraceCounter(const char *name, int64_t value);
+
+// Writes every event recorded since the previous dump to `path` and returns
+// how many there were. Throws (ERR_TESSERACT_RUNTIME) if `path` cannot be
+// written.
+size_t DumpTrace(const std::string &path);
+
+// Records the enclosing scope as a span, if tracing was on when it began.
+class TraceSpan {
+public:
+  TraceSpan(const char *category, const char *name)
+      : _category(category), _name(name),
+        _start(TraceEnabled() ? TraceNow() : -1) {}
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+  ~TraceSpan() {
+    if (_start >= 0) {
+      TraceComplete(_category, _name, _start);
+    }
+  }
+
+private:
+  const char *_category;
+  const char *_name;
+  int64_t _start;
+};
@@ -0,0 +1,406 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "traineddata.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <zlib.h>
+
+#ifdef NODE_TESSERACT_HAVE_ZSTD
+#include <memory>
+#include <zstd.h>
+#endif
+
+namespace {
+
+// TessdataManager refuses larger tables (kMaxNumTessdataEntries)
+constexpr int32_t kMaxEntries = 1000;
+constexpr size_t kMaxTableSize =
+    sizeof(int32_t) + sizeof(int64_t) * kMaxEntries;
+
+constexpr size_t kChunk = size_t{1} << 20;
+
+// Sizes of the models ReadTraineddata loaded, by normalized plain name.
+struct LoadedModels {
+  std::mutex mutex;
+  std::unordered_map<std::string, int64_t> bytes;
+};
+
+LoadedModels &Loaded() {
+  static LoadedModels loaded;
+  return loaded;
+}
+
+std::string ModelKey(const std::string &filename) {
+  return std::filesystem::path(filename).lexically_normal().string();
+}
+
+bool RecordLoaded(const std::string &filename, bool read,
+                  const std::vector<char> &data) {
+  if (read) {
+    LoadedModels &loaded = Loaded();
+    std::scoped_lock lock(loaded.mutex);
+    loaded.bytes[ModelKey(filename)] = static_cast<int64_t>(data.size());
+  }
+  return read;
+}
+
+// Searched in order when the plain model is missing.
+#ifdef NODE_TESSERACT_HAVE_ZSTD
+constexpr std::array<std::string_view, 2> kCompressedSuffixes{".zst", ".gz"};
+#else
+constexpr std::array<std::string_view, 1> kCompressedSuffixes{".gz"};
+#endif
+
+template <typename T> T ByteSwap(T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  std::reverse(bytes, bytes + sizeof(T));
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+TraineddataHeader Invalid(std::string reason) {
+  return TraineddataHeader{false, 0, std::move(reason)};
+}
+
+bool EndsWith(std::string_view value, std::string_view suffix) {
+  return value.size() >= suffix.size() &&
+         value.substr(value.size() - suffix.size()) == suffix;
+}
+
+// Makes room for at least kChunk more bytes after the used part of `out`
+// and returns the used size. Reserved capacity is handed out first.
+size_t Grow(std::vector<char> &out) {
+  const size_t used = out.size();
+  out.resize(std::max(out.capacity(), used + kChunk));
+  return used;
+}
+
+// ISIZE trailer: size of the last member modulo 2^32, exact for models
+uint64_t GzipContentSize(const uint8_t *data, size_t size) {
+  if (size < 18) {
+    return UINT64_MAX;
+  }
+  const uint8_t *isize = data + size - 4;
+  return uint32_t{isize[0]} | uint32_t{isize[1]} << 8 |
+         uint32_t{isize[2]} << 16 | uint32_t{isize[3]} << 24;
+}
+
+// Inflates until the stream ends or `out` holds `limit` bytes.
+bool Gunzip(const uint8_t *data, size_t size, size_t limit,
+            std::vector<char> &out, std::string &error) {
+  z_stream stream{};
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+    error = "cannot initialize zlib";
+    return false;
+  }
+  const uint64_t content = GzipContentSize(data, size);
+  if (content != UINT64_MAX) {
+    out.reserve(static_cast<size_t>(std::min<uint64_t>(content, limit)));
+  }
+
+  size_t consumed = 0;
+  int status = Z_OK;
+  while ((status != Z_STREAM_END || consumed < size) && out.size() < limit) {
+    if (status == Z_STREAM_END) {
+      inflateReset(&stream); // concatenated members
+    }
+    const size_t in = std::min<size_t>(size - consumed, UINT_MAX);
+    stream.next_in = const_cast<Bytef *>(data + consumed);
+    stream.avail_in = static_cast<uInt>(in);
+    const size_t used = Grow(out);
+    const size_t room =
+        std::min({out.size() - used, limit - used, size_t{UINT_MAX}});
+    stream.next_out = reinterpret_cast<Bytef *>(out.data() + used);
+    stream.avail_out = static_cast<uInt>(room);
+
+    status = inflate(&stream, Z_NO_FLUSH);
+    consumed += in - stream.avail_in;
+    out.resize(used + room - stream.avail_out);
+    if (status == Z_BUF_ERROR) {
+      error = "truncated gzip stream";
+      break;
+    }
+    if (status != Z_OK && status != Z_STREAM_END) {
+      error = std::format("corrupt gzip stream: {}",
+                          stream.msg != nullptr ? stream.msg : "bad data");
+      break;
+    }
+  }
+  inflateEnd(&stream);
+  return error.empty();
+}
+
+#ifdef NODE_TESSERACT_HAVE_ZSTD
+bool Unzstd(const uint8_t *data, size_t size, size_t limit,
+            std::vector<char> &out, std::string &error) {
+  const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context{
+      ZSTD_createDCtx(), ZSTD_freeDCtx};
+  if (!context) {
+    error = "cannot initialize zstd";
+    return false;
+  }
+  const unsigned long long content = ZSTD_getFrameContentSize(data, size);
+  if (content != ZSTD_CONTENTSIZE_UNKNOWN &&
+      content != ZSTD_CONTENTSIZE_ERROR) {
+    out.reserve(
+        static_cast<size_t>(std::min<unsigned long long>(content, limit)));
+  }
+
+  ZSTD_inBuffer input{data, size, 0};
+  while (out.size() < limit) {
+    const size_t used = Grow(out);
+    ZSTD_outBuffer output{out.data() + used,
+                          std::min(out.size() - used, limit - used), 0};
+    const size_t status = ZSTD_decompressStream(context.get(), &output, &input);
+    out.resize(used + output.pos);
+    if (ZSTD_isError(status)) {
+      error = std::format("corrupt zstd stream: {}", ZSTD_getErrorName(status));
+      return false;
+    }
+    if (input.pos == input.size) {
+      if (status == 0) {
+        return true;
+      }
+      if (output.pos < output.size) {
+        error = "truncated zstd stream";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+// Decompresses a .gz or .zst model into `out`, or only its first `limit`
+// bytes; `error` says why not. `content_size`, if given, receives the
+// decompressed size of the whole model: the size the stream declares when
+// it stopped at `limit`, UINT64_MAX if it declares none.
+bool Decompress(const std::string &path, std::vector<char> &out,
+                std::string &error, size_t limit = SIZE_MAX,
+                uint64_t *content_size = nullptr) {
+#ifndef NODE_TESSERACT_HAVE_ZSTD
+  if (EndsWith(path, ".zst")) {
+    error = "the addon was built without zstd support";
+    return false;
+  }
+#endif
+  try {
+    const MappedFile file = MappedFile::Open(path, "traineddata");
+    out.clear();
+    bool read = false;
+    uint64_t declared = UINT64_MAX;
+#ifdef NODE_TESSERACT_HAVE_ZSTD
+    if (EndsWith(path, ".zst")) {
+      read = Unzstd(file.data(), file.size(), limit, out, error);
+      const unsigned long long content =
+          ZSTD_getFrameContentSize(file.data(), file.size());
+      if (content != ZSTD_CONTENTSIZE_UNKNOWN &&
+          content != ZSTD_CONTENTSIZE_ERROR) {
+        declared = content;
+      }
+    } else
+#endif
+    {
+      read = Gunzip(file.data(), file.size(), limit, out, error);
+      declared = GzipContentSize(file.data(), file.size());
+    }
+    if (content_size != nullptr) {
+      *content_size = out.size() < limit ? out.size() : declared;
+    }
+    return read;
+  } catch (const std::exception &e) {
+    error = e.what();
+    return false;
+  }
+}
+
+// Same as tesseract::LoadDataFromFile.
+bool ReadPlain(const std::string &path, std::vector<char> &out) {
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  if (!stream) {
+    return false;
+  }
+  const std::streamoff size = stream.tellg();
+  if (size <= 0) {
+    return false;
+  }
+  out.resize(static_cast<size_t>(size));
+  stream.seekg(0);
+  return static_cast<bool>(stream.read(out.data(), size));
+}
+
+// `data` holds the first `size` bytes of a model of `file_size` bytes, at
+// least the whole component table if the model has one.
+TraineddataHeader InspectTable(const char *data, size_t size,
+                               uint64_t file_size) {
+  if (size < 4) {
+    return Invalid("shorter than the component table");
+  }
+  if (std::memcmp(data, "PK\x03\x04", 4) == 0) {
+    return TraineddataHeader{true, 0, ""};
+  }
+
+  int32_t entries = 0;
+  std::memcpy(&entries, data, sizeof(entries));
+  const bool swapped = entries < 0 || entries > kMaxEntries;
+  if (swapped) {
+    entries = ByteSwap(entries);
+  }
+  if (entries <= 0 || entries > kMaxEntries) {
+    return Invalid(std::format("implausible component count {}", entries));
+  }
+
+  const uint64_t table_end =
+      sizeof(int32_t) + sizeof(int64_t) * static_cast<uint64_t>(entries);
+  if (size < table_end) {
+    return Invalid("shorter than the component table");
+  }
+
+  TraineddataHeader header{true, 0, ""};
+  int64_t previous = static_cast<int64_t>(table_end);
+  for (int32_t i = 0; i < entries; ++i) {
+    int64_t offset = 0;
+    std::memcpy(&offset, data + sizeof(int32_t) + sizeof(int64_t) * i,
+                sizeof(offset));
+    if (swapped) {
+      offset = ByteSwap(offset);
+    }
+    if (offset == -1) {
+      continue;
+    }
+    if (offset < previous || static_cast<uint64_t>(offset) > file_size) {
+      return Invalid(std::format(
+          "component {} at offset {} lies outside the file or out of order", i,
+          offset));
+    }
+    previous = offset;
+    ++header.components;
+  }
+  if (header.components == 0) {
+    return Invalid("no components");
+  }
+  return header;
+}
+
+} // namespace
+
+bool IsCompressedTraineddata(const std::string &path) {
+  return EndsWith(path, ".gz") || EndsWith(path, ".zst");
+}
+
+std::vector<std::string> SupportedTraineddataCompressions() {
+#ifdef NODE_TESSERACT_HAVE_ZSTD
+  return {"none", "gzip", "zstd"};
+#else
+  return {"none", "gzip"};
+#endif
+}
+
+void AddCompressedLanguages(const std::string &datapath,
+                            std::vector<std::string> &langs) {
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(datapath, error)) {
+    std::string name = entry.path().filename().string();
+    if (!IsCompressedTraineddata(name)) {
+      continue;
+    }
+    name.erase(name.rfind('.')); // .gz or .zst
+    constexpr std::string_view kSuffix = ".traineddata";
+    if (name.size() <= kSuffix.size() || !EndsWith(name, kSuffix)) {
+      continue;
+    }
+    std::string lang = name.substr(0, name.size() - kSuffix.size());
+    if (std::find(langs.begin(), langs.end(), lang) == langs.end()) {
+      langs.push_back(std::move(lang));
+    }
+  }
+  std::sort(langs.begin(), langs.end());
+}
+
+bool ReadTraineddata(const char *filename, std::vector<char> *data) {
+  const std::string path{filename};
+  std::error_code error;
+  if (std::filesystem::exists(path, error)) {
+    return RecordLoaded(path, ReadPlain(path, *data), *data);
+  }
+  for (const std::string_view suffix : kCompressedSuffixes) {
+    std::string candidate = path + std::string{suffix};
+    if (std::filesystem::exists(candidate, error)) {
+      std::string reason;
+      return RecordLoaded(path, Decompress(candidate, *data, reason), *data);
+    }
+  }
+  return false;
+}
+
+int64_t LoadedTraineddataBytes(const std::string &filename) {
+  LoadedModels &loaded = Loaded();
+  std::scoped_lock lock(loaded.mutex);
+  const auto it = loaded.bytes.find(ModelKey(filename));
+  return it != loaded.bytes.end() ? it->second : -1;
+}
+
+TraineddataHeader InspectTraineddata(const char *data, size_t size) {
+  return InspectTable(data, size, size);
+}
+
+TraineddataHeader InspectTraineddata(const std::string &path) {
+  if (IsCompressedTraineddata(path)) {
+    // Only the table is inflated. A stream that declares no size (zstd
+    // written without one) gets no upper bound on its component offsets.
+    std::vector<char> table;
+    std::string reason;
+    uint64_t content_size = UINT64_MAX;
+    if (!Decompress(path, table, reason, kMaxTableSize, &content_size)) {
+      return Invalid(std::move(reason));
+    }
+    return InspectTable(table.data(), table.size(), content_size);
+  }
+
+  std::error_code error;
+  const auto file_size = std::filesystem::file_size(path, error);
+  if (error) {
+    return Invalid(std::format("cannot stat: {}", error.message()));
+  }
+
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    return Invalid("cannot open");
+  }
+  // the table is all that is checked, so only it is read
+  std::vector<char> table(
+      static_cast<size_t>(std::min<uint64_t>(file_size, kMaxTableSize)));
+  if (!stream.read(table.data(), static_cast<std::streamsize>(table.size()))) {
+    return Invalid("cannot read");
+  }
+  return InspectTable(table.data(), table.size(), file_size);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Result of checking a .traineddata file's component table.
+struct TraineddataHeader {
+  bool valid{false};
+  int components{0}; // present components
+  std::string reason; // why the file is not valid, empty otherwise
+};
+
+// Models may be kept compressed on disk as <lang>.traineddata.zst (when the
+// addon is built with libzstd) or <lang>.traineddata.gz. Compressed files
+// are decompressed straight into memory and never written back out.
+bool IsCompressedTraineddata(const std::string &path);
+
+// Compressions ReadTraineddata can read: "none", "gzip" and, in builds with
+// libzstd, "zstd".
+std::vector<std::string> SupportedTraineddataCompressions();
+
+// Adds the languages of compressed models in `datapath` to `langs`, which
+// TessBaseAPI::GetAvailableLanguagesAsVector leaves out, and sorts it.
+void AddCompressedLanguages(const std::string &datapath,
+                            std::vector<std::string> &langs);
+
+// tesseract::FileReader handed to TessBaseAPI::Init. Reads `filename` as
+// is, or, when it does not exist, the first of `filename`.zst and
+// `filename`.gz that does. Returns false if none can be read.
+bool ReadTraineddata(const char *filename, std::vector<char> *data);
+
+// Bytes ReadTraineddata last loaded for `filename` (the plain name, as
+// Tesseract asks for it), after decompression; -1 if it never loaded it.
+int64_t LoadedTraineddataBytes(const std::string &filename);
+
+// Reads the component table the way TessdataManager::LoadMemBuffer does: an
+// int32 entry count followed by one int64 offset per entry, -1 for absent
+// components, in the writer's byte order. Every present component has to
+// start after the table, in order, and inside the file, which catches
+// truncated and garbage files before TessBaseAPI::Init loads them. Zip
+// archives (libarchive builds) are accepted without looking inside.
+// Of compressed models only the table is inflated; their offsets are
+// bounded by the decompressed size the stream declares, if any.
+TraineddataHeader InspectTraineddata(const std::string &path);
+TraineddataHeader InspectTraineddata(const char *data, size_t size);
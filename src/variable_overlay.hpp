@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Philipp Czarnetzki
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#pragma once
+
+#include "utils.hpp"
+#include <algorithm>
+#include <string>
+#include <tesseract/baseapi.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Variables one job runs with, sorted by name (see SortOverlay).
+using VariableOverlay = std::vector<std::pair<std::string, std::string>>;
+
+// Sorts `overlay` by name; of duplicate names the last one wins.
+inline void SortOverlay(VariableOverlay &overlay) {
+  std::stable_sort(overlay.begin(), overlay.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.first < b.first;
+                   });
+  VariableOverlay sorted;
+  sorted.reserve(overlay.size());
+  for (auto &entry : overlay) {
+    if (!sorted.empty() && sorted.back().first == entry.first) {
+      sorted.back().second = std::move(entry.second);
+    } else {
+      sorted.push_back(std::move(entry));
+    }
+  }
+  overlay = std::move(sorted);
+}
+
+// Throws unless `name` is a variable of the engine that SetVariable can
+// change after init; returns its current value without changing it.
+inline std::string CheckSettableVariable(tesseract::TessBaseAPI &api,
+                                         const std::string &name,
+                                         const char *method) {
+  std::string value;
+  if (!api.GetVariableAsString(name.c_str(), &value)) {
+    throw_runtime("{}: variable '{}' was not found", method, name);
+  }
+  // SetVariable skips init-only variables; writing the current value back
+  // finds them before anything changed
+  if (!api.SetVariable(name.c_str(), value.c_str())) {
+    throw_runtime("{}: variable '{}' can only be set by init", method, name);
+  }
+  return value;
+}
+
+// Applies per-job variable overlays to one engine and puts the engine's own
+// values back. Restoring is lazy: an overlay stays set until the next job
+// that recognizes with a different overlay, or none, or that reads or sets
+// variables itself, so a run of jobs with the same overlay sets it once and
+// the jobs that render its results in between see it too. The engine's own
+// value of a variable is read the first time an overlay sets it and cached
+// until Forget().
+class OverlayState {
+public:
+  // Makes `overlay` the active overlay; an empty one restores the engine's
+  // own values. Throws, without changing anything, if a variable does not
+  // exist or can only be set by init.
+  void Apply(tesseract::TessBaseAPI &api, const VariableOverlay &overlay,
+             const char *method) {
+    if (overlay == _active) {
+      return;
+    }
+    for (const auto &[name, value] : overlay) {
+      if (_originals.contains(name)) {
+        continue;
+      }
+      _originals.emplace(name, CheckSettableVariable(api, name, method));
+    }
+
+    for (const auto &[name, value] : _active) {
+      if (!Sets(overlay, name)) {
+        Set(api, name, _originals.at(name), method);
+      }
+    }
+    // first, so the next Apply also restores a partly set overlay
+    _active = overlay;
+    for (const auto &[name, value] : _active) {
+      Set(api, name, value, method);
+    }
+  }
+
+  void Restore(tesseract::TessBaseAPI &api, const char *method) {
+    Apply(api, VariableOverlay{}, method);
+  }
+
+  // Drops the cached values after the engine's own values changed, e.g. by
+  // init or setVariable. Only called while no overlay is active.
+  void Forget() { _originals.clear(); }
+
+private:
+  static void Set(tesseract::TessBaseAPI &api, const std::string &name,
+                  const std::string &value, const char *method) {
+    if (!api.SetVariable(name.c_str(), value.c_str())) {
+      throw_runtime("{}: cannot set variable '{}' to \"{}\"", method, name,
+                    value);
+    }
+  }
+
+  static bool Sets(const VariableOverlay &overlay, const std::string &name) {
+    const auto it = std::lower_bound(
+        overlay.begin(), overlay.end(), name,
+        [](const auto &entry, const std::string &key) {
+          return entry.first < key;
+        });
+    return it != overlay.end() && it->first == name;
+  }
+
+  VariableOverlay _active;
+  std::unordered_map<std::string, std::string> _originals;
+};
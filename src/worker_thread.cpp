@@ -16,27 +16,25 @@
 
 #include "worker_thread.hpp"
 #include "commands.hpp"
+#include "tracer.hpp"
+#include <cstdint>
 #include <exception>
+#include <format>
 #include <memory>
-#include <mutex>
 #include <optional>
-#include <queue>
 #include <stop_token>
 #include <thread>
 #include <type_traits>
 #include <variant>
-#include <vector>
 
 namespace {
 
-std::string CommandName(const Command &command) {
+const char *CommandName(const Command &command) {
   return std::visit(
-      [](const auto &c) -> std::string {
+      [](const auto &c) -> const char * {
         using T = std::decay_t<decltype(c)>;
         if constexpr (std::is_same_v<T, CommandVersion>)
           return "version";
-        if constexpr (std::is_same_v<T, CommandIsInitialized>)
-          return "isInitialized";
         if constexpr (std::is_same_v<T, CommandInit>)
           return "init";
         if constexpr (std::is_same_v<T, CommandInitForAnalysePage>)
@@ -75,14 +73,32 @@ std::string CommandName(const Command &command) {
           return "getSourceYResolution";
         if constexpr (std::is_same_v<T, CommandSetImage>)
           return "setImage";
+        if constexpr (std::is_same_v<T, CommandSetImageFromFile>)
+          return "setImageFromFile";
         if constexpr (std::is_same_v<T, CommandGetThresholdedImage>)
           return "getThresholdedImage";
         if constexpr (std::is_same_v<T, CommandGetThresholdedImageScaleFactor>)
           return "getThresholdedImageScaleFactor";
         if constexpr (std::is_same_v<T, CommandRecognize>)
           return "recognize";
+        if constexpr (std::is_same_v<T, CommandRecognizeFile>)
+          return "recognizeFile";
+        if constexpr (std::is_same_v<T, CommandCheckProfileVariables>)
+          return "createProfile";
+        if constexpr (std::is_same_v<T, CommandRecognizeWithProfile>)
+          return "recognizeWithProfile";
+        if constexpr (std::is_same_v<T, CommandRecognizeRegions>)
+          return "recognizeRegions";
+        if constexpr (std::is_same_v<T, CommandRecognizeFrame>)
+          return "recognizeFrame";
+        if constexpr (std::is_same_v<T, CommandInitCascade>)
+          return "initCascade";
+        if constexpr (std::is_same_v<T, CommandRecognizeCascade>)
+          return "recognizeCascade";
         if constexpr (std::is_same_v<T, CommandAnalyseLayout>)
           return "analyseLayout";
+        if constexpr (std::is_same_v<T, CommandGetComponentImages>)
+          return "getComponentImages";
         if constexpr (std::is_same_v<T, CommandDetectOrientationScript>)
           return "detectOrientationScript";
         if constexpr (std::is_same_v<T, CommandMeanTextConf>)
@@ -113,6 +129,8 @@ std::string CommandName(const Command &command) {
           return "beginProcessPages";
         if constexpr (std::is_same_v<T, CommandAddProcessPage>)
           return "addProcessPage";
+        if constexpr (std::is_same_v<T, CommandAddProcessPageFromFile>)
+          return "addProcessPageFromFile";
         if constexpr (std::is_same_v<T, CommandFinishProcessPages>)
           return "finishProcessPages";
         if constexpr (std::is_same_v<T, CommandAbortProcessPages>)
@@ -123,6 +141,8 @@ std::string CommandName(const Command &command) {
           return "getLoadedLanguages";
         if constexpr (std::is_same_v<T, CommandGetAvailableLanguages>)
           return "getAvailableLanguages";
+        if constexpr (std::is_same_v<T, CommandGetThreadingConfig>)
+          return "getThreadingConfig";
         if constexpr (std::is_same_v<T, CommandClearPersistentCache>)
           return "clearPersistentCache";
         if constexpr (std::is_same_v<T, CommandClearAdaptiveClassifier>)
@@ -136,111 +156,296 @@ std::string CommandName(const Command &command) {
       command);
 }
 
+void SettleJob(Napi::Env env, Job &job) {
+  if (job.error.has_value()) {
+    Napi::Error error = Napi::Error::New(env, *job.error);
+    if (job.error_code.has_value()) {
+      error.Set("code", Napi::String::New(env, *job.error_code));
+    }
+    if (job.error_method.has_value()) {
+      error.Set("method", Napi::String::New(env, *job.error_method));
+    }
+    job.deffered.Reject(error.Value());
+    return;
+  }
+
+  if (!job.result.has_value()) {
+    job.deffered.Resolve(env.Undefined());
+    return;
+  }
+
+  job.deffered.Resolve(MatchResult(env, *job.result));
+}
+
 } // namespace
 
-WorkerThread::WorkerThread(Napi::Env env)
+WorkerThread::WorkerThread(Napi::Env env, QueueOptions queue)
     : _env(env),
-      _main_thread(Napi::ThreadSafeFunction::New(
-          env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}),
-          "main_thread_callback", 0, 1)) {
+      _submissions(std::make_shared<SubmissionRing>(queue.capacity)) {}
+
+void WorkerThread::Start() {
+  TraceThreadName("js");
+  _main_thread = Napi::ThreadSafeFunction::New(
+      _env, Napi::Function::New(_env, [](const Napi::CallbackInfo &) {}),
+      "main_thread_callback", 0, 1);
   _worker_thread =
       std::jthread([this](std::stop_token token) { this->Run(token); });
+  _cleanup_hook = _env.AddCleanupHook(&WorkerThread::OnEnvCleanup, this);
 }
 
 WorkerThread::~WorkerThread() {
+  if (_worker_thread.joinable()) {
+    _cleanup_hook.Remove(_env);
+  }
+  Stop();
+  Napi::MemoryManagement::AdjustExternalMemory(
+      _env, _memory->TakeExternalRemainder());
+}
+
+void WorkerThread::OnEnvCleanup(WorkerThread *worker) { worker->Stop(); }
+
+bool WorkerThread::IsClosing() {
+  return _closing.load() || _worker_thread.get_stop_token().stop_requested();
+}
+
+void WorkerThread::RejectClosing(Napi::Promise::Deferred &deferred) {
+  Napi::Error error = Napi::Error::New(_env, "Worker is closing");
+  error.Set("code", Napi::String::New(_env, "ERR_WORKER_CLOSED"));
+  deferred.Reject(error.Value());
+}
+
+Napi::Promise WorkerThread::Answer(const Result &result) {
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(_env);
+  if (IsClosing()) {
+    RejectClosing(deferred);
+  } else {
+    deferred.Resolve(MatchResult(_env, result));
+  }
+  return deferred.Promise();
+}
+
+Napi::Promise WorkerThread::IsInitialized() {
+  return Answer(ResultBool{_initialized.load(std::memory_order_acquire)});
+}
+
+Napi::Promise WorkerThread::GetProcessPagesStatus() {
+  return Answer(_status.Session());
+}
+
+Napi::Promise WorkerThread::GetMemoryUsage() {
+  return Answer(ResultMemoryUsage{
+      .in_flight_bytes = _memory->InFlight(),
+      .result_bytes = _memory->Results(),
+      .image_bytes = _memory->Image(),
+      .model_bytes = _memory->Model(),
+      .total_bytes = _memory->Total(),
+      .budget_bytes = _memory->Budget(),
+  });
+}
+
+Napi::Promise WorkerThread::GetStatus() {
+  ResultWorkerStatus status =
+      _status.Snapshot(_initialized.load(std::memory_order_acquire));
+  status.queue_depth = static_cast<int>(_submissions->Size() +
+                                        (_submissions->HasParked() ? 1 : 0));
+  status.queue_waiting = static_cast<int>(_submissions->WaiterCount());
+  status.queue_capacity = static_cast<int>(_submissions->Capacity());
+  status.queue_high_water = static_cast<int>(_submissions->HighWater());
+  return Answer(status);
+}
+
+Napi::Promise WorkerThread::WaitForCapacity() {
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(_env);
+  if (IsClosing()) {
+    RejectClosing(deferred);
+  } else if (_submissions->WaiterCount() == 0 &&
+             _submissions->FreeCells() > 0) {
+    deferred.Resolve(_env.Undefined());
+  } else {
+    // earlier waiters go first
+    _submissions->AddWaiter(deferred);
+  }
+  return deferred.Promise();
+}
+
+void WorkerThread::Stop() {
   _worker_thread.request_stop();
-  _queue_cv.notify_all();
+  _submissions->Wake();
   if (_worker_thread.joinable()) {
     _worker_thread.join();
   }
 }
 
-void WorkerThread::MakeCallback(std::shared_ptr<Job> *p_job) {
-  auto status = _main_thread.NonBlockingCall(
-      p_job, [](Napi::Env env, Napi::Function /* unused */,
-                std::shared_ptr<Job> *_job) {
-        // break the reference to the underlying job reference
-        std::shared_ptr<Job> job = *_job;
-        delete _job;
-
-        if (job->error.has_value()) {
-          Napi::Error error = Napi::Error::New(env, *job->error);
-          if (job->error_code.has_value()) {
-            error.Set("code", Napi::String::New(env, *job->error_code));
-          }
-          if (job->error_method.has_value()) {
-            error.Set("method", Napi::String::New(env, *job->error_method));
-          }
-          job->deffered.Reject(error.Value());
-          return;
-        }
+bool WorkerThread::Admit(Job &job) {
+  const int64_t bytes = PayloadBytes(job.command);
+  if (!_memory->TryReserve(bytes)) {
+    Napi::Error error = Napi::Error::New(
+        _env, std::format("Memory budget of {} bytes exceeded: {} bytes in "
+                          "use, {} bytes requested",
+                          _memory->Budget(), _memory->Total(), bytes));
+    error.Set("code", Napi::String::New(_env, "ERR_MEMORY_BUDGET"));
+    error.Set("method", Napi::String::New(_env, CommandName(job.command)));
+    job.deffered.Reject(error.Value());
+    return false;
+  }
 
-        if (!job->result.has_value()) {
-          job->deffered.Resolve(env.Undefined());
-          return;
-        }
+  job.reserved_bytes = bytes;
+  Napi::MemoryManagement::AdjustExternalMemory(_env,
+                                               _memory->TakeExternalDelta());
+  return true;
+}
+
+void WorkerThread::RejectQueueFull(Job &job) {
+  _memory->Release(job.reserved_bytes);
+  job.reserved_bytes = 0;
+  Napi::MemoryManagement::AdjustExternalMemory(_env,
+                                               _memory->TakeExternalDelta());
 
-        job->deffered.Resolve(MatchResult(env, *job->result));
+  Napi::Error error = Napi::Error::New(
+      _env, std::format("Submission queue is full ({} jobs queued)",
+                        _submissions->Capacity()));
+  error.Set("code", Napi::String::New(_env, "ERR_QUEUE_FULL"));
+  error.Set("method", Napi::String::New(_env, CommandName(job.command)));
+  job.deffered.Reject(error.Value());
+}
+
+// Runs on the worker thread after every job; only commands that can change
+// what the engines hold are checked.
+void WorkerThread::UpdateEngineMemory(const Command &command) {
+  if (!_initialized.load(std::memory_order_acquire)) {
+    _memory->SetImage(0);
+  } else if (PayloadBytes(command) > 0 ||
+             std::holds_alternative<CommandSetImageFromFile>(command) ||
+             std::holds_alternative<CommandAddProcessPageFromFile>(command) ||
+             std::holds_alternative<CommandRecognize>(command) ||
+             std::holds_alternative<CommandRecognizeFile>(command) ||
+             std::holds_alternative<CommandClear>(command)) {
+    _memory->SetImage(EngineImageBytes(_api));
+  }
+
+  if (std::holds_alternative<CommandInit>(command) ||
+      std::holds_alternative<CommandInitCascade>(command) ||
+      std::holds_alternative<CommandEnd>(command)) {
+    _memory->SetModel(EngineModelBytes(_api) + EngineModelBytes(_cascade.api));
+  }
+}
+
+void WorkerThread::Complete(std::shared_ptr<Job> job) {
+  if (!_completions->Push(std::move(job))) {
+    return; // the drain scheduled by an earlier job will pick it up
+  }
+
+  // One call per batch: everything that finishes before the JS thread gets
+  // to it is settled in the same event-loop turn.
+  auto status = _main_thread.NonBlockingCall(
+      [completions = _completions, memory = _memory,
+       submissions = _submissions](Napi::Env env,
+                                   Napi::Function /* unused */) {
+        completions->Drain([&](std::shared_ptr<Job> job) {
+          memory->Release(job->reserved_bytes);
+          job->reserved_bytes = 0;
+          TraceSpan span{"settle", CommandName(job->command)};
+          SettleJob(env, *job);
+          memory->ReleaseResults(job->result_bytes);
+          job->result_bytes = 0;
+        });
+        // The worker popped every job drained above before finishing it,
+        // so their cells are free by now. Refilling first could miss a job
+        // that completes during the drain without scheduling another one.
+        submissions->Refill();
+        submissions->ResolveWaiters(env);
+        Napi::MemoryManagement::AdjustExternalMemory(
+            env, memory->TakeExternalDelta());
       });
 
   if (status != napi_ok) {
-    return;
+    // the environment is closing, the callback will never run
+    _completions->Drain([&](std::shared_ptr<Job> job) {
+      _memory->Release(job->reserved_bytes);
+      _memory->ReleaseResults(job->result_bytes);
+    });
   }
 }
 
 void WorkerThread::Run(std::stop_token token) {
   std::optional<ProcessPagesSession> process_pages_session;
+  t_progress_sink = &_status.Progress();
+  TraceThreadName("tesseract-worker");
 
-  auto drain_queue = [&](std::vector<std::shared_ptr<Job>> &pending_jobs) {
-    while (!_request_queue.empty()) {
-      pending_jobs.push_back(_request_queue.front());
-      _request_queue.pop();
+  auto reject_job = [&](std::shared_ptr<Job> pending_job) {
+    pending_job->error = "Worker stopped accepting new Commands";
+    pending_job->error_code = "ERR_WORKER_STOPPED";
+    pending_job->error_method = CommandName(pending_job->command);
+    Complete(std::move(pending_job));
+  };
+  auto reject_pending = [&]() {
+    _submissions->Drain(reject_job);
+    if (token.stop_requested()) {
+      // the JS thread is blocked in Stop(), the parked job is ours now
+      if (auto parked = _submissions->TakeParked()) {
+        reject_job(std::move(parked));
+      }
     }
   };
-  auto reject_jobs =
-      [&](const char *message,
-          const std::vector<std::shared_ptr<Job>> &pending_jobs) {
-        for (const auto &pending_job : pending_jobs) {
-          pending_job->error = message;
-          pending_job->error_code = "ERR_WORKER_STOPPED";
-          pending_job->error_method = CommandName(pending_job->command);
-          auto *sp_pending_job = new std::shared_ptr<Job>(pending_job);
-          MakeCallback(sp_pending_job);
-        }
-      };
 
   while (true) {
-    std::shared_ptr<Job> job;
-    {
-      std::unique_lock<std::mutex> lock(_queue_mutex);
-      std::vector<std::shared_ptr<Job>> pending_jobs;
-
-      // wait until queue is not empty anymore, or stop was requested
-      _queue_cv.wait(lock, [&] {
-        return !_request_queue.empty() || token.stop_requested();
-      });
-      if (token.stop_requested()) {
-        drain_queue(pending_jobs);
-        lock.unlock();
-        reject_jobs("Worker stopped accepting new Commands", pending_jobs);
-        break;
-      }
-
-      // if (_request_queue.empty()) {
-      //   break;
-      // }
+    // sleeps until a job is pushed or stop is requested
+    std::shared_ptr<Job> job = _submissions->Pop(token);
+    if (job == nullptr) {
+      reject_pending();
+      break;
+    }
 
-      job = _request_queue.front();
-      _request_queue.pop();
-    };
+    _status.JobStarted(CommandName(job->command));
+    const int64_t started = TraceEnabled() ? TraceNow() : -1;
+    if (started >= 0 && job->enqueued_us >= 0) {
+      TraceAsync("queue", CommandName(job->command),
+                 reinterpret_cast<uintptr_t>(job.get()), job->enqueued_us,
+                 started);
+    }
 
     try {
+      // an uninitialized engine has no variables to read
+      if (_initialized.load(std::memory_order_acquire)) {
+        switch (CommandOverlayUse(job->command)) {
+        case OverlayUse::Apply:
+          _overlay.Apply(_api, CommandOverlay(job->command),
+                         CommandName(job->command));
+          break;
+        case OverlayUse::Restore:
+          _overlay.Restore(_api, CommandName(job->command));
+          break;
+        case OverlayUse::Keep:
+          break;
+        }
+      }
+      std::visit(
+          [&](auto &command) {
+            if constexpr (requires { command.limits = ImageLimits{}; }) {
+              command.limits = CurrentImageLimits();
+            }
+          },
+          job->command);
       job->result = std::visit(
           [&](const auto &command) -> Result {
             if constexpr (requires {
-                            command.invoke(_api, process_pages_session,
-                                           _initialized);
+                            command.invoke(_api, _initialized, _cascade);
                           }) {
+              return command.invoke(_api, _initialized, _cascade);
+            } else if constexpr (requires {
+                                   command.invoke(_api, _initialized,
+                                                  _frame_stream);
+                                 }) {
+              return command.invoke(_api, _initialized, _frame_stream);
+            } else if constexpr (requires {
+                                   command.invoke(_api, _initialized,
+                                                  _rectangle);
+                                 }) {
+              return command.invoke(_api, _initialized, _rectangle);
+            } else if constexpr (requires {
+                                   command.invoke(_api, process_pages_session,
+                                                  _initialized);
+                                 }) {
               return command.invoke(_api, process_pages_session, _initialized);
             } else if constexpr (requires {
                                    command.invoke(_api, _initialized);
@@ -255,6 +460,10 @@ void WorkerThread::Run(std::stop_token token) {
             }
           },
           job->command);
+    } catch (const ImageLimitError &error) {
+      job->error = error.what();
+      job->error_code = "ERR_IMAGE_LIMIT";
+      job->error_method = CommandName(job->command);
     } catch (const std::exception &error) {
       job->error = error.what();
       job->error_code = "ERR_TESSERACT_RUNTIME";
@@ -264,22 +473,65 @@ void WorkerThread::Run(std::stop_token token) {
       job->error_code = "ERR_TESSERACT_RUNTIME";
       job->error_method = CommandName(job->command);
     }
+    if (started >= 0) {
+      TraceComplete("command", CommandName(job->command), started);
+    }
+    if (job->result) {
+      job->result_bytes = static_cast<int64_t>(ResultBytes(*job->result));
+      _memory->AddResults(job->result_bytes);
+    }
+
+    _status.JobFinished();
+    if (std::holds_alternative<CommandBeginProcessPages>(job->command) ||
+        std::holds_alternative<CommandAddProcessPage>(job->command) ||
+        std::holds_alternative<CommandAddProcessPageFromFile>(job->command) ||
+        std::holds_alternative<CommandFinishProcessPages>(job->command) ||
+        std::holds_alternative<CommandAbortProcessPages>(job->command)) {
+      _status.PublishSession(SessionStatus(process_pages_session));
+    }
+
+    if (std::holds_alternative<CommandInit>(job->command) ||
+        std::holds_alternative<CommandInitForAnalysePage>(job->command) ||
+        std::holds_alternative<CommandSetVariable>(job->command) ||
+        std::holds_alternative<CommandSetDebugVariable>(job->command)) {
+      _overlay.Forget();
+    }
+
+    if (const auto *init = std::get_if<CommandInit>(&job->command);
+        init != nullptr && !job->error) {
+      if (init->memory_budget) {
+        _memory->SetBudget(*init->memory_budget);
+      }
+      if (init->image_limits) {
+        std::scoped_lock lock(_limits_mutex);
+        _image_limits = *init->image_limits;
+      }
+    }
 
-    auto *sp_job = new std::shared_ptr<Job>(job);
-    MakeCallback(sp_job);
+    // drop the kept rectangle, and its image, once the image is replaced
+    if (_rectangle.image != nullptr &&
+        (!_initialized.load(std::memory_order_acquire) ||
+         _rectangle.image.get() != _api.GetInputImage())) {
+      _rectangle = {};
+    }
+
+    // the engine keeps its own reference; let the next page into the window
+    if (auto *file = std::get_if<CommandRecognizeFile>(&job->command)) {
+      file->image.Release();
+    }
+
+    UpdateEngineMemory(job->command);
+
+    Complete(job);
 
     if (token.stop_requested() ||
         std::holds_alternative<CommandEnd>(job->command)) {
-      std::vector<std::shared_ptr<Job>> pending_jobs;
-      {
-        std::unique_lock<std::mutex> lock(_queue_mutex);
-        drain_queue(pending_jobs);
-      }
-      reject_jobs("Worker stopped accepting new Commands", pending_jobs);
+      reject_pending();
       break;
     }
   };
 
   _api.End();
+  _cascade.api.End();
   _main_thread.Release();
 };
@@ -17,11 +17,14 @@
 #pragma once
 
 #include "commands.hpp"
+#include "completion_queue.hpp"
+#include "prefetcher.hpp"
+#include "status.hpp"
+#include "submission_ring.hpp"
 #include <atomic>
-#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <napi.h>
-#include <queue>
 #include <stop_token>
 #include <tesseract/baseapi.h>
 #include <thread>
@@ -29,14 +32,47 @@
 
 class WorkerThread {
 public:
-  explicit WorkerThread(Napi::Env env);
+  WorkerThread(Napi::Env env, QueueOptions queue);
   ~WorkerThread();
 
+  // Starts the worker thread; until then nothing holds the event loop.
+  void Start();
+
   template <typename C> Napi::Promise Enqueue(C &&command);
 
+  // Starts reading and decoding `path` ahead of the job that will use it.
+  PrefetchedImage Prefetch(std::string path, size_t readahead) {
+    return _prefetcher.Prefetch(std::move(path), CurrentImageLimits(),
+                                readahead, "recognizeFile");
+  }
+
+  // Limits of the last successful init(...). Jobs that decode on the worker
+  // get them when they run; setImage(buffer) and recognizeFile, which decode
+  // before their job runs, read them when they are called.
+  ImageLimits CurrentImageLimits() const {
+    std::scoped_lock lock(_limits_mutex);
+    return _image_limits;
+  }
+
+  // Answered on the JS thread from state the worker publishes, so they never
+  // wait behind a running job.
+  Napi::Promise IsInitialized();
+  Napi::Promise GetProcessPagesStatus();
+  Napi::Promise GetMemoryUsage();
+  Napi::Promise GetStatus();
+  Napi::Promise WaitForCapacity();
+
 private:
   void Run(std::stop_token token);
-  void MakeCallback(std::shared_ptr<Job> *job);
+  void Complete(std::shared_ptr<Job> job);
+  void Stop();
+  bool Admit(Job &job);
+  void RejectQueueFull(Job &job);
+  void UpdateEngineMemory(const Command &command);
+  static void OnEnvCleanup(WorkerThread *worker);
+  bool IsClosing();
+  void RejectClosing(Napi::Promise::Deferred &deferred);
+  Napi::Promise Answer(const Result &result);
 
 private:
   Napi::Env _env;
@@ -44,39 +80,65 @@ private:
 
   // for graceful shutdown of the worker
   std::atomic<bool> _closing{false};
-  std::mutex _queue_mutex;
-  std::condition_variable _queue_cv;
-  std::queue<std::shared_ptr<Job>> _request_queue;
 
   tesseract::TessBaseAPI _api;
   std::atomic<bool> _initialized{false};
+  CascadeEngine _cascade;
+  FrameStream _frame_stream; // worker thread only
+  OverlayState _overlay;     // worker thread only
+  RectangleState _rectangle; // worker thread only
+
+  mutable std::mutex _limits_mutex;
+  ImageLimits _image_limits; // written by the worker only
+
+  // shared with completion callbacks, which may outlive this object
+  std::shared_ptr<MemoryAccount> _memory = std::make_shared<MemoryAccount>();
+  std::shared_ptr<CompletionQueue> _completions =
+      std::make_shared<CompletionQueue>();
+  std::shared_ptr<SubmissionRing> _submissions;
+
+  WorkerStatus _status;
+  ImagePrefetcher _prefetcher{_memory};
 
   std::jthread _worker_thread;
+
+  // Stops the worker when its environment (e.g. a worker_threads Worker) is
+  // torn down while the instance is still alive.
+  Napi::Env::CleanupHook<void (*)(WorkerThread *), WorkerThread> _cleanup_hook;
 };
 
 template <typename C> Napi::Promise WorkerThread::Enqueue(C &&command) {
   Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(_env);
   auto job = std::make_shared<Job>(Job{Command{std::forward<C>(command)},
                                        deferred, std::nullopt, std::nullopt});
+  if (TraceEnabled()) {
+    job->enqueued_us = TraceNow();
+  }
 
-  {
-    std::scoped_lock<std::mutex> lock(_queue_mutex);
-    std::stop_token token = _worker_thread.get_stop_token();
+  if (IsClosing()) {
+    RejectClosing(deferred);
+    return deferred.Promise();
+  }
 
-    if (_closing.load() || token.stop_requested()) {
-      Napi::Error error = Napi::Error::New(_env, "Worker is closing");
-      error.Set("code", Napi::String::New(_env, "ERR_WORKER_CLOSED"));
-      deferred.Reject(error.Value());
-      return deferred.Promise();
-    }
+  if (!Admit(*job)) {
+    return deferred.Promise();
+  }
 
-    _request_queue.push(job);
+  if (std::holds_alternative<CommandEnd>(job->command)) {
+    _closing.store(true);
+  }
 
+  // a cell freed since the last drain may still be waiting for the slot
+  _submissions->Refill();
+  if (_submissions->HasParked() || !_submissions->TryPush(job)) {
+    // end() is never refused, so the instance can always be shut down;
+    // nothing is accepted after it, so the slot holds at most one job
     if (std::holds_alternative<CommandEnd>(job->command)) {
-      _closing.store(true);
+      _submissions->Park(std::move(job));
+    } else {
+      RejectQueueFull(*job);
     }
-  };
+  }
 
-  _queue_cv.notify_one();
   return deferred.Promise();
 }
@@ -14,23 +14,51 @@
  * permissions and limitations under the License.
  */
 
-import { readFileSync } from "node:fs";
-import { mkdtemp, rm } from "node:fs/promises";
+import { type ChildProcess, spawn } from "node:child_process";
+import { existsSync, readFileSync } from "node:fs";
+import {
+  mkdtemp,
+  readdir,
+  readFile,
+  rm,
+  stat,
+  writeFile,
+} from "node:fs/promises";
+import net from "node:net";
 import os from "node:os";
 import path from "node:path";
 import { fileURLToPath } from "node:url";
-
-import { afterEach, beforeEach, describe, expect, it, vi } from "vitest";
+import { Worker } from "node:worker_threads";
+
+import {
+  afterAll,
+  afterEach,
+  beforeAll,
+  beforeEach,
+  describe,
+  expect,
+  it,
+  vi,
+} from "vitest";
 
 import Tesseract, {
+  configurePixPool,
+  dumpTrace,
+  enableTracing,
+  getPixPoolStats,
+  inspectTraineddata,
   Language,
   PageSegmentationModes,
+  TesseractClient,
   TesseractInstance,
 } from "../../lib/index";
 
 const exampleImageUrl = new URL("../../example8.jpg", import.meta.url);
 const exampleImage = readFileSync(fileURLToPath(exampleImageUrl));
 const exampleImagePath = fileURLToPath(exampleImageUrl);
+const ocrdPath = fileURLToPath(
+  new URL("../../build/release/tesseract-ocrd", import.meta.url),
+);
 
 describe("tesseract api validation", () => {
   let tesseract: TesseractInstance;
@@ -160,7 +188,16 @@ describe("tesseract api validation", () => {
   it("rejects recognize with non-function callback", async () => {
     // @ts-expect-error - testing runtime validation for invalid type
     await expect(tesseract.recognize(123)).rejects.toThrow(
-      "recognize(progressCallback?): progressCallback must be a function",
+      "recognize(progressCallback?, options?): progressCallback must be a function",
+    );
+  });
+
+  it("rejects recognize with non-boolean autoRotate", async () => {
+    await expect(
+      // @ts-expect-error - testing runtime validation for invalid type
+      tesseract.recognize(undefined, { autoRotate: "yes" }),
+    ).rejects.toThrow(
+      "recognize(progressCallback?, options?): options.autoRotate must be a boolean",
     );
   });
 
@@ -260,6 +297,32 @@ describe("tesseract api validation", () => {
     await tesseract.finishProcessPages();
   });
 
+  it("reads images from file paths on the worker", async () => {
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImageFromFile(exampleImagePath);
+    await tesseract.recognize();
+    expect((await tesseract.getUTF8Text()).trim().length).toBeGreaterThan(0);
+
+    await expect(
+      tesseract.setImageFromFile(path.join(os.tmpdir(), "tess-missing.png")),
+    ).rejects.toMatchObject({
+      code: "ERR_TESSERACT_RUNTIME",
+      method: "setImageFromFile",
+    });
+
+    await tesseract.document.begin({
+      title: "x",
+      outputBase: path.join(os.tmpdir(), "tess-page-from-file"),
+      timeout: 0,
+      textonly: true,
+    });
+    await tesseract.document.addPageFromFile(exampleImagePath);
+    await expect(tesseract.document.status()).resolves.toMatchObject({
+      processedPages: 1,
+    });
+    await tesseract.document.finish();
+  });
+
   it("rejects document.addPage when called without an active session", async () => {
     await tesseract.init({ langs: [Language.eng] });
     await expect(
@@ -295,6 +358,16 @@ describe("tesseract api validation", () => {
     ).rejects.toThrow("setVariable(name, value): expected exactly 2 arguments");
   });
 
+  it("rejects recognize with non-string vars", async () => {
+    await expect(
+      tesseract.recognize(undefined, {
+        vars: { tessedit_char_whitelist: 1 as never },
+      }),
+    ).rejects.toThrow(
+      "recognize(progressCallback?, options?): options.vars must be an object of strings",
+    );
+  });
+
   it("rejects setDebugVariable with non-string value", async () => {
     await expect(
       // @ts-expect-error - testing runtime validation for invalid type
@@ -422,6 +495,33 @@ describe("tesseract api validation", () => {
     );
   });
 
+  it("rejects init with non-numeric image limit", async () => {
+    await expect(
+      // @ts-expect-error - testing runtime validation for invalid type
+      tesseract.init({ imageLimits: { maxPixels: "1" } }),
+    ).rejects.toThrow(
+      "init(options): options.imageLimits.maxPixels must be a number",
+    );
+  });
+
+  it("rejects getComponentImages with an unknown level", async () => {
+    await expect(
+      // @ts-expect-error - testing runtime validation for invalid value
+      tesseract.getComponentImages({ level: "symbol" }),
+    ).rejects.toMatchObject({
+      code: "ERR_INVALID_ARGUMENT",
+      method: "getComponentImages",
+    });
+  });
+
+  it("rejects getComponentImages with negative padding", async () => {
+    await expect(
+      tesseract.getComponentImages({ raw: true, padding: -1 }),
+    ).rejects.toThrow(
+      "getComponentImages(options?): options.padding must be non-negative",
+    );
+  });
+
   it("rejects getPAGEText with invalid callback type", async () => {
     // @ts-expect-error - testing runtime validation for invalid type
     await expect(tesseract.getPAGEText(1)).rejects.toThrow(
@@ -478,6 +578,105 @@ describe("tesseract api validation", () => {
     });
   });
 
+  it("rejects init with intraOpThreads below 1", async () => {
+    await expect(
+      tesseract.init({ intraOpThreads: 0, ensureTraineddata: false }),
+    ).rejects.toMatchObject({
+      code: "ERR_OUT_OF_RANGE",
+      method: "init",
+    });
+  });
+
+  it("rejects init with invalid cpuAffinity type", async () => {
+    await expect(
+      // @ts-expect-error - testing runtime validation for invalid type
+      tesseract.init({ cpuAffinity: "0", ensureTraineddata: false }),
+    ).rejects.toThrow(
+      "init(options): options.cpuAffinity must be an array of numbers",
+    );
+  });
+
+  it("rejects recognizeRegions with non-array regions", async () => {
+    await expect(
+      // @ts-expect-error - testing runtime validation for invalid type
+      tesseract.recognizeRegions({ left: 0, top: 0, width: 1, height: 1 }),
+    ).rejects.toThrow(
+      "recognizeRegions(regions, options?): regions must be an array of rectangles",
+    );
+  });
+
+  it("rejects recognizeRegions with out-of-range region psm", async () => {
+    await expect(
+      tesseract.recognizeRegions([
+        // @ts-expect-error - testing runtime validation for invalid value
+        { left: 0, top: 0, width: 1, height: 1, psm: 999 },
+      ]),
+    ).rejects.toMatchObject({
+      code: "ERR_OUT_OF_RANGE",
+      method: "recognizeRegions",
+    });
+  });
+
+  it("rejects recognizeCascade with out-of-range minConfidence", async () => {
+    await expect(
+      tesseract.recognizeCascade({ minConfidence: 101 }),
+    ).rejects.toMatchObject({
+      code: "ERR_OUT_OF_RANGE",
+      method: "recognizeCascade",
+    });
+  });
+
+  it("rejects recognizeCascade before init", async () => {
+    await expect(tesseract.recognizeCascade()).rejects.toMatchObject({
+      code: "ERR_TESSERACT_RUNTIME",
+      method: "recognizeCascade",
+    });
+  });
+
+  it("rejects init with negative memoryBudget", async () => {
+    await expect(tesseract.init({ memoryBudget: -1 })).rejects.toMatchObject({
+      code: "ERR_OUT_OF_RANGE",
+      method: "init",
+    });
+  });
+
+  it("rejects configurePixPool with invalid options", () => {
+    // @ts-expect-error - testing runtime validation for invalid type
+    expect(() => configurePixPool({ enabled: "yes" })).toThrow(
+      "configurePixPool(options): options.enabled must be a boolean",
+    );
+  });
+
+  it("inspects the traineddata component table", async () => {
+    const dir = await mkdtemp(path.join(os.tmpdir(), "tess-inspect-"));
+    try {
+      // 3 entries, the second absent, followed by two components
+      const table = Buffer.alloc(4 + 3 * 8);
+      table.writeInt32LE(3, 0);
+      table.writeBigInt64LE(28n, 4);
+      table.writeBigInt64LE(-1n, 12);
+      table.writeBigInt64LE(40n, 20);
+      const model = Buffer.concat([table, Buffer.alloc(22, 1)]);
+
+      const valid = path.join(dir, "valid.traineddata");
+      const truncated = path.join(dir, "truncated.traineddata");
+      await writeFile(valid, model);
+      await writeFile(truncated, model.subarray(0, 20));
+
+      expect(inspectTraineddata(valid)).toEqual({
+        valid: true,
+        components: 2,
+        reason: "",
+      });
+      expect(inspectTraineddata(truncated)).toMatchObject({
+        valid: false,
+        reason: "shorter than the component table",
+      });
+    } finally {
+      await rm(dir, { recursive: true, force: true });
+    }
+  });
+
   it("rejects isInitialized when arguments are provided", async () => {
     await expect(
       // @ts-expect-error - testing runtime validation for invalid call
@@ -487,6 +686,54 @@ describe("tesseract api validation", () => {
 });
 
 describe("tesseract api integration", () => {
+  it("loads and runs in several worker threads", async () => {
+    const root = fileURLToPath(new URL("../../", import.meta.url));
+    const source = `
+      const path = require("node:path");
+      const { parentPort, workerData } = require("node:worker_threads");
+      const { Tesseract } = require("pkg-prebuilds")(
+        workerData.root,
+        require(path.join(workerData.root, "binding-options.js")),
+      );
+      const tesseract = new Tesseract();
+      tesseract.version().then(async (version) => {
+        await tesseract.end();
+        parentPort.postMessage(version);
+      });
+    `;
+    const run = () =>
+      new Promise<string>((resolve, reject) => {
+        const worker = new Worker(source, { eval: true, workerData: { root } });
+        worker.once("message", (version: string) => {
+          resolve(version);
+          void worker.terminate();
+        });
+        worker.once("error", reject);
+      });
+
+    const tesseract = new Tesseract();
+    const versions = await Promise.all([run(), run(), run()]);
+    expect(new Set(versions)).toEqual(new Set([await tesseract.version()]));
+    await tesseract.end();
+  });
+
+  it("stops live instances when a worker thread is terminated", async () => {
+    const root = fileURLToPath(new URL("../../", import.meta.url));
+    const source = `
+      const path = require("node:path");
+      const { parentPort, workerData } = require("node:worker_threads");
+      const { Tesseract } = require("pkg-prebuilds")(
+        workerData.root,
+        require(path.join(workerData.root, "binding-options.js")),
+      );
+      globalThis.instance = new Tesseract();
+      parentPort.postMessage("ready");
+    `;
+    const worker = new Worker(source, { eval: true, workerData: { root } });
+    await new Promise((resolve) => worker.once("message", resolve));
+    await expect(worker.terminate()).resolves.toBeTypeOf("number");
+  });
+
   it("initializes and ends", async () => {
     const tesseract = new Tesseract();
     await tesseract.init({ langs: [Language.eng] });
@@ -531,6 +778,55 @@ describe("tesseract api integration", () => {
     await tesseract.end();
   });
 
+  it("auto-rotates and recognizes in one call", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const osd = await tesseract.recognize(undefined, { autoRotate: true });
+    expect([0, 90, 180, 270]).toContain(osd.orientationDegrees);
+    expect(osd.scriptName).toBeTypeOf("string");
+    expect(await tesseract.getUTF8Text()).toBeTypeOf("string");
+    await tesseract.end();
+  });
+
+  it("accounts native memory and enforces the budget", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const usage = await tesseract.getMemoryUsage();
+    expect(usage.imageBytes).toBeGreaterThan(0);
+    expect(usage.modelBytes).toBeGreaterThan(0);
+    expect(usage.inFlightBytes).toBe(0);
+    expect(usage.resultBytes).toBe(0);
+    expect(usage.totalBytes).toBe(usage.imageBytes + usage.modelBytes);
+    await tesseract.end();
+
+    const limited = new Tesseract();
+    await limited.init({ langs: [Language.eng], memoryBudget: 1 });
+    await expect(limited.setImage(exampleImage)).rejects.toMatchObject({
+      code: "ERR_MEMORY_BUDGET",
+      method: "setImage",
+    });
+    await limited.end();
+  });
+
+  it("recycles page rasters through the pix pool", async () => {
+    configurePixPool({ enabled: true });
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    await tesseract.setImage(exampleImage);
+    const stats = getPixPoolStats();
+    expect(stats.installed).toBe(true);
+    expect(stats.allocations).toBeGreaterThan(0);
+    expect(stats.hits).toBeGreaterThan(0);
+    await tesseract.end();
+
+    configurePixPool({ enabled: false });
+    expect(getPixPoolStats().retainedBytes).toBe(0);
+    configurePixPool({ enabled: true });
+  });
+
   it("sets and reads variables", async () => {
     const tesseract = new Tesseract();
     await tesseract.init({ langs: [Language.eng] });
@@ -550,6 +846,490 @@ describe("tesseract api integration", () => {
     await tesseract.end();
   });
 
+  it("recognizes multiple regions in one call", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const regions = await tesseract.recognizeRegions(
+      [
+        { left: 0, top: 0, width: 200, height: 100 },
+        {
+          left: 0,
+          top: 0,
+          width: 400,
+          height: 200,
+          psm: PageSegmentationModes.PSM_SINGLE_BLOCK,
+        },
+      ],
+      { psm: PageSegmentationModes.PSM_SINGLE_LINE },
+    );
+    expect(regions).toHaveLength(2);
+    expect(regions[0]).toMatchObject({
+      left: 0,
+      top: 0,
+      width: 200,
+      height: 100,
+      psm: PageSegmentationModes.PSM_SINGLE_LINE,
+    });
+    expect(regions[1].psm).toBe(PageSegmentationModes.PSM_SINGLE_BLOCK);
+    expect(regions[0].text).toBeTypeOf("string");
+    expect(regions[0].confidence).toBeTypeOf("number");
+    await tesseract.end();
+  });
+
+  it("keeps the rectangle set before recognizeRegions", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    await tesseract.setRectangle({ left: 0, top: 0, width: 400, height: 200 });
+    await tesseract.recognize();
+    const expected = await tesseract.getUTF8Text();
+
+    await tesseract.recognizeRegions([
+      { left: 0, top: 0, width: 200, height: 100 },
+    ]);
+    await tesseract.recognize();
+    expect(await tesseract.getUTF8Text()).toBe(expected);
+    await tesseract.end();
+  });
+
+  it("returns the page layout without recognizing", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const layout = await tesseract.analyseLayout();
+    expect(layout.blocks.length).toBeGreaterThan(0);
+
+    const block = layout.blocks.find((b) => b.paragraphs.length > 0)!;
+    expect(block.blockType).toBeTypeOf("string");
+    expect(block.orientation).toBe("pageUp");
+    const line = block.paragraphs[0].lines[0];
+    expect(line.width).toBeGreaterThan(0);
+    expect(line.baseline.x2).toBeGreaterThanOrEqual(line.baseline.x1);
+    expect(line.words.length).toBeGreaterThan(0);
+    await tesseract.end();
+  });
+
+  it("refuses images over the limits before decoding", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({
+      langs: [Language.eng],
+      imageLimits: { maxPixels: 100 * 100 },
+    });
+    await expect(tesseract.setImage(exampleImage)).rejects.toMatchObject({
+      code: "ERR_IMAGE_LIMIT",
+      method: "setImage",
+    });
+    await expect(tesseract.setInputImage(exampleImage)).rejects.toMatchObject({
+      code: "ERR_IMAGE_LIMIT",
+      method: "setInputImage",
+    });
+    await tesseract.end();
+  });
+
+  it("refuses GIF bombs without decoding them", async () => {
+    // a 65535x65535 frame in a few bytes of LZW data
+    const gif = Buffer.concat([
+      Buffer.from("GIF89a"),
+      Buffer.from([
+        1, 0, 1, 0, 0, 0, 0, 0x2c, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 0, 2, 2,
+        0x44, 1, 0, 0x3b,
+      ]),
+    ]);
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await expect(tesseract.setImage(gif)).rejects.toMatchObject({
+      code: "ERR_IMAGE_LIMIT",
+      method: "setImage",
+    });
+    await tesseract.end();
+  });
+
+  it("downscales oversized JPEGs while decoding", async () => {
+    const probe = new Tesseract();
+    await probe.init({ langs: [Language.eng] });
+    await probe.setInputImage(exampleImage);
+    const fullSize = (await probe.getInputImage()).length;
+    await probe.end();
+
+    const tesseract = new Tesseract();
+    await tesseract.init({
+      langs: [Language.eng],
+      imageLimits: { maxBytes: Math.floor(fullSize / 2), downscale: true },
+    });
+    await tesseract.setInputImage(exampleImage);
+    const reduced = await tesseract.getInputImage();
+    expect(reduced.length).toBeLessThanOrEqual(fullSize / 2);
+    await tesseract.end();
+  });
+
+  it("settles many small jobs in submission order", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    const order: number[] = [];
+    await Promise.all(
+      Array.from({ length: 200 }, (_, i) =>
+        tesseract.getInitLanguages().then(() => order.push(i)),
+      ),
+    );
+    expect(order).toEqual(Array.from({ length: 200 }, (_, i) => i));
+    await tesseract.end();
+  });
+
+  it("bounds the submission queue", async () => {
+    expect(() => new Tesseract({ queueCapacity: 0 })).toThrow(RangeError);
+
+    const tesseract = new Tesseract({ queueCapacity: 2 });
+    await tesseract.init({ langs: [Language.eng] });
+    const results = await Promise.allSettled(
+      Array.from({ length: 20 }, () => tesseract.getInitLanguages()),
+    );
+    const rejected = results.filter((r) => r.status === "rejected");
+    expect(rejected.length).toBeGreaterThan(0);
+    expect((rejected[0] as PromiseRejectedResult).reason).toMatchObject({
+      code: "ERR_QUEUE_FULL",
+      method: "getInitLanguages",
+    });
+
+    const order: number[] = [];
+    const jobs: Promise<unknown>[] = [];
+    for (let i = 0; i < 50; i++) {
+      await tesseract.waitForCapacity();
+      jobs.push(tesseract.getInitLanguages().then(() => order.push(i)));
+    }
+    await Promise.all(jobs);
+    expect(order).toEqual(Array.from({ length: 50 }, (_, i) => i));
+    const idle = await tesseract.getStatus();
+    expect(idle.queueCapacity).toBe(2);
+    expect(idle.queueHighWater).toBeLessThanOrEqual(2);
+    expect(idle.queueWaiting).toBe(0);
+    await tesseract.end();
+    await expect(tesseract.waitForCapacity()).rejects.toMatchObject({
+      code: "ERR_WORKER_CLOSED",
+    });
+  });
+
+  it("processes a manifest of files with readahead", async () => {
+    const dir = await mkdtemp(path.join(os.tmpdir(), "tess-manifest-"));
+    const manifest = path.join(dir, "files.txt");
+    await writeFile(
+      manifest,
+      [exampleImagePath, "# skipped", "", "missing.png", exampleImagePath].join(
+        "\n",
+      ),
+    );
+
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    const processed = [];
+    for await (const file of tesseract.processFiles(
+      { manifest },
+      { outputs: ["text", "hocr"], readahead: 2 },
+    )) {
+      processed.push(file);
+    }
+
+    expect(processed.map((file) => file.index)).toEqual([0, 1, 2]);
+    expect(processed[0].result?.text.length).toBeGreaterThan(0);
+    expect(processed[0].result?.hocr).toContain("ocr_page");
+    expect(processed[0].result?.tsv).toBe("");
+    expect(processed[1].path).toBe(path.join(dir, "missing.png"));
+    expect(processed[1].error).toMatchObject({ method: "recognizeFile" });
+    expect(processed[2].result?.text).toBe(processed[0].result?.text);
+    // prefetched pages leave the account with their jobs
+    expect((await tesseract.getMemoryUsage()).inFlightBytes).toBe(0);
+    await tesseract.end();
+    await rm(dir, { recursive: true, force: true });
+  });
+
+  it("validates the readahead of file jobs", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+
+    await expect(
+      tesseract.recognizeFile(exampleImagePath, { readahead: 65 }),
+    ).rejects.toMatchObject({
+      code: "ERR_OUT_OF_RANGE",
+      method: "recognizeFile",
+    });
+    await expect(
+      tesseract.processFiles([exampleImagePath], { readahead: 1.5 }).next(),
+    ).rejects.toBeInstanceOf(RangeError);
+
+    const file = await tesseract.recognizeFile(exampleImagePath, {
+      readahead: 8,
+    });
+    expect(file.text.length).toBeGreaterThan(0);
+    await tesseract.end();
+  });
+
+  it("recognizes images with a reusable profile", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    const profile = await tesseract.createProfile({
+      psm: PageSegmentationModes.PSM_SINGLE_BLOCK,
+      vars: { tessedit_char_whitelist: "0123456789" },
+      outputs: ["text", "tsv"],
+    });
+
+    const first = await tesseract.recognizeWithProfile(exampleImage, profile);
+    const second = await tesseract.recognizeWithProfile(exampleImage, profile);
+    expect(first.path).toBe("");
+    expect(first.tsv.length).toBeGreaterThan(0);
+    expect(first.hocr).toBe("");
+    expect(first.text.replace(/\s/g, "")).toMatch(/^\d*$/);
+    expect(second.text).toBe(first.text);
+    expect(await tesseract.getStringVariable("tessedit_char_whitelist")).toBe(
+      "",
+    );
+
+    await expect(
+      tesseract.recognizeWithProfile(exampleImage, {} as never),
+    ).rejects.toMatchObject({
+      code: "ERR_INVALID_ARGUMENT",
+      method: "recognizeWithProfile",
+    });
+    await expect(
+      tesseract.createProfile({
+        rect: { left: 0, top: 0, width: 0, height: 1 },
+      }),
+    ).rejects.toMatchObject({ code: "ERR_OUT_OF_RANGE" });
+    await tesseract.end();
+  });
+
+  it("checks the variables of a profile when it is created", async () => {
+    const tesseract = new Tesseract();
+    const vars = { tessedit_char_whitelist: "0123456789" };
+    await expect(tesseract.createProfile({ vars })).rejects.toMatchObject({
+      code: "ERR_TESSERACT_RUNTIME",
+      method: "createProfile",
+    });
+
+    await tesseract.init({ langs: [Language.eng] });
+    await expect(
+      tesseract.createProfile({ vars: { no_such_variable: "1" } as never }),
+    ).rejects.toThrow(
+      "createProfile: variable 'no_such_variable' was not found",
+    );
+    await expect(
+      tesseract.createProfile({ vars: { load_system_dawg: "0" } as never }),
+    ).rejects.toThrow("can only be set by init");
+    await expect(
+      tesseract.createProfile({ vars: { tessedit_char_whitelist: "" } }),
+    ).rejects.toMatchObject({ code: "ERR_INVALID_ARGUMENT" });
+
+    const profile = await tesseract.createProfile({ vars });
+    await expect(
+      tesseract.recognizeWithProfile(exampleImage, profile),
+    ).resolves.toMatchObject({ path: "" });
+    await expect(
+      tesseract.getStringVariable("tessedit_char_whitelist"),
+    ).resolves.toBe("");
+    await tesseract.end();
+  });
+
+  it("restores the variables of per-call overlays", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setVariable("tessedit_char_whitelist", "abc");
+    const vars = { tessedit_char_whitelist: "0123456789" };
+
+    const first = await tesseract.recognizeFile(exampleImagePath, { vars });
+    const second = await tesseract.recognizeFile(exampleImagePath, { vars });
+    expect(first.text.replace(/\s/g, "")).toMatch(/^\d*$/);
+    expect(second.text).toBe(first.text);
+    expect(await tesseract.getStringVariable("tessedit_char_whitelist")).toBe(
+      "abc",
+    );
+
+    await expect(
+      tesseract.recognizeFile(exampleImagePath, {
+        vars: { no_such_variable: "1" } as never,
+      }),
+    ).rejects.toMatchObject({
+      code: "ERR_TESSERACT_RUNTIME",
+      method: "recognizeFile",
+    });
+    await expect(
+      tesseract.recognizeFile(exampleImagePath, {
+        vars: { load_system_dawg: "0" } as never,
+      }),
+    ).rejects.toMatchObject({
+      code: "ERR_TESSERACT_RUNTIME",
+      method: "recognizeFile",
+    });
+    expect(await tesseract.getStringVariable("tessedit_char_whitelist")).toBe(
+      "abc",
+    );
+    await tesseract.end();
+  });
+
+  it("renders with the variables of the last recognize call", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+
+    await tesseract.recognize(undefined, {
+      vars: { tessedit_char_whitelist: "0123456789" },
+    });
+    const text = await tesseract.getUTF8Text();
+    expect(text.replace(/\s/g, "")).toMatch(/^\d*$/);
+    expect(await tesseract.getStringVariable("tessedit_char_whitelist")).toBe(
+      "",
+    );
+    await tesseract.end();
+  });
+
+  it("answers status reads without waiting for queued jobs", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    const order: string[] = [];
+    const setImage = tesseract.setImage(exampleImage);
+    const recognize = tesseract
+      .recognize()
+      .then(() => order.push("recognize"));
+
+    const status = await tesseract.getStatus();
+    order.push("status");
+    expect(status.initialized).toBe(true);
+    const pending = status.queueDepth + (status.currentCommand ? 1 : 0);
+    expect(pending).toBeGreaterThan(0);
+    expect(status.session.active).toBe(false);
+    await expect(tesseract.isInitialized()).resolves.toBe(true);
+
+    await Promise.all([setImage, recognize]);
+    expect(order).toEqual(["status", "recognize"]);
+
+    const idle = await tesseract.getStatus();
+    expect(idle.queueDepth).toBe(0);
+    expect(idle.currentCommand).toBe("");
+    await tesseract.end();
+  });
+
+  it("crops text line images in one call", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const lines = await tesseract.getComponentImages();
+    expect(lines.length).toBeGreaterThan(0);
+
+    const { image } = lines[0];
+    expect(image.depth).toBe(1);
+    expect(image.width).toBe(lines[0].width);
+    expect(image.data).toBeInstanceOf(Buffer);
+    expect(image.data.length).toBe(image.bytesPerLine * image.height);
+
+    const raw = await tesseract.getComponentImages({ raw: true, padding: 2 });
+    expect(raw[0].image.depth).toBeGreaterThan(1);
+    await tesseract.end();
+  });
+
+  it("recognizes only what changed between frames", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+    await tesseract.setImage(exampleImage);
+    const [block] = await tesseract.getComponentImages({
+      level: "block",
+      raw: true,
+    });
+    // Leptonica keeps pixels in native-endian 32-bit words
+    const { image } = block;
+    const frame = {
+      data: Buffer.from(image.data).swap32(),
+      width: image.width,
+      height: image.height,
+      bytesPerPixel: (image.depth / 8) as 1 | 4,
+      bytesPerLine: image.bytesPerLine,
+    };
+
+    const first = await tesseract.recognizeFrame(frame);
+    expect(first.frame).toBe(0);
+    expect(first.changedTiles).toBe(first.totalTiles);
+    expect(first.added.length).toBeGreaterThan(0);
+    expect(first.text.trim().length).toBeGreaterThan(0);
+
+    const same = await tesseract.recognizeFrame(frame);
+    expect(same).toMatchObject({
+      frame: 1,
+      changedTiles: 0,
+      added: [],
+      removed: [],
+      text: first.text,
+    });
+
+    const blank = await tesseract.recognizeFrame({
+      ...frame,
+      data: Buffer.alloc(frame.data.length, 0xff),
+    });
+    expect(blank.changedTiles).toBeGreaterThan(0);
+    expect(blank.removed).toEqual(
+      first.added.map((line) => line.id).sort((a, b) => a - b),
+    );
+    expect(blank.text).toBe("");
+
+    const again = await tesseract.recognizeFrame(frame);
+    const restarted = await tesseract.recognizeFrame(frame, { reset: true });
+    expect(restarted.removed).toEqual(
+      again.added.map((line) => line.id).sort((a, b) => a - b),
+    );
+    expect(restarted.added.length).toBe(again.added.length);
+
+    await expect(
+      tesseract.recognizeFrame({ ...frame, data: Buffer.alloc(1) }),
+    ).rejects.toMatchObject({ code: "ERR_OUT_OF_RANGE" });
+    await tesseract.end();
+  });
+
+  it("applies intraOpThreads on the worker thread", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng], intraOpThreads: 1 });
+    const config = await tesseract.getThreadingConfig();
+    expect(config.openmp).toBeTypeOf("boolean");
+    expect(config.intraOpThreads).toBe(1);
+    expect(config.cpuAffinity).toBeInstanceOf(Array);
+    await tesseract.end();
+  });
+
+  it("dumps a trace timeline of the worker", async () => {
+    const dir = await mkdtemp(path.join(os.tmpdir(), "tess-trace-"));
+    try {
+      enableTracing();
+      const tesseract = new Tesseract();
+      await tesseract.init({ langs: [Language.eng] });
+      await tesseract.setImage(exampleImage);
+      await tesseract.recognize(() => {});
+      await tesseract.end();
+
+      const tracePath = path.join(dir, "trace.json");
+      await expect(dumpTrace(tracePath)).resolves.toBeGreaterThan(0);
+      const { traceEvents } = JSON.parse(await readFile(tracePath, "utf8"));
+      const names = new Set(
+        traceEvents.map((event: { name: string; args?: { name?: string } }) =>
+          event.name === "thread_name" ? event.args?.name : event.name,
+        ),
+      );
+      for (const name of [
+        "tesseract-worker",
+        "setImage",
+        "decode",
+        "recognize",
+        "layout",
+        "progressCallback",
+      ]) {
+        expect(names).toContain(name);
+      }
+
+      await expect(
+        dumpTrace(path.join(dir, "missing", "trace.json")),
+      ).rejects.toMatchObject({
+        code: "ERR_TESSERACT_RUNTIME",
+        method: "dumpTrace",
+      });
+    } finally {
+      await rm(dir, { recursive: true, force: true });
+    }
+  });
+
   it("should set `osd` as available languages by default", async () => {
     const tesseract = new Tesseract();
     await tesseract.init({ dataPath: "./traineddata-local", langs: [] });
@@ -586,6 +1366,188 @@ describe("tesseract worker lifecycle errors", () => {
   });
 });
 
+describe("tesseract daemon client", () => {
+  it.skipIf(process.platform === "win32")(
+    "rejects with ERR_DAEMON_UNAVAILABLE when no daemon listens",
+    async () => {
+      const dir = await mkdtemp(path.join(os.tmpdir(), "ocrd-"));
+      try {
+        const client = new TesseractClient({
+          socketPath: path.join(dir, "missing.sock"),
+        });
+
+        await expect(client.info()).rejects.toMatchObject({
+          code: "ERR_DAEMON_UNAVAILABLE",
+          method: "info",
+        });
+        await expect(
+          client.recognize(exampleImage, { outputs: ["text"] }),
+        ).rejects.toMatchObject({
+          code: "ERR_DAEMON_UNAVAILABLE",
+          method: "recognize",
+        });
+        await expect(
+          client.recognizeFile(exampleImagePath, { psm: 99 as never }),
+        ).rejects.toMatchObject({ code: "ERR_OUT_OF_RANGE" });
+      } finally {
+        await rm(dir, { recursive: true, force: true });
+      }
+    },
+  );
+
+  it("validates the timeout option", () => {
+    for (const timeout of [-1, 1.5, 2 ** 31, Number.NaN]) {
+      expect(
+        () => new TesseractClient({ socketPath: "ocrd.sock", timeout }),
+      ).toThrow(
+        expect.objectContaining({
+          name: "RangeError",
+          code: "ERR_OUT_OF_RANGE",
+        }),
+      );
+    }
+  });
+
+  // Stands in for the daemon: accepts connections and hands each socket to
+  // `onConnection`.
+  const withFakeDaemon = async (
+    onConnection: (socket: net.Socket) => void,
+    run: (socketPath: string) => Promise<void>,
+  ) => {
+    const dir = await mkdtemp(path.join(os.tmpdir(), "ocrd-"));
+    const socketPath = path.join(dir, "ocrd.sock");
+    const sockets = new Set<net.Socket>();
+    const server = net.createServer((socket) => {
+      sockets.add(socket);
+      socket.on("error", () => {});
+      onConnection(socket);
+    });
+    await new Promise<void>((resolve) => server.listen(socketPath, resolve));
+    try {
+      await run(socketPath);
+    } finally {
+      for (const socket of sockets) {
+        socket.destroy();
+      }
+      await new Promise((resolve) => server.close(resolve));
+      await rm(dir, { recursive: true, force: true });
+    }
+  };
+
+  it.skipIf(process.platform === "win32")(
+    "rejects a malformed reply with ERR_DAEMON_UNAVAILABLE",
+    async () => {
+      await withFakeDaemon(
+        (socket) =>
+          socket.once("data", () => socket.end(Buffer.alloc(64, 0xab))),
+        async (socketPath) => {
+          const client = new TesseractClient({ socketPath });
+          await expect(client.info()).rejects.toMatchObject({
+            code: "ERR_DAEMON_UNAVAILABLE",
+            method: "info",
+          });
+        },
+      );
+    },
+  );
+
+  it.skipIf(process.platform === "win32")(
+    "rejects with ERR_DAEMON_TIMEOUT when the daemon does not reply",
+    async () => {
+      await withFakeDaemon(
+        () => {},
+        async (socketPath) => {
+          const client = new TesseractClient({ socketPath, timeout: 200 });
+          const started = Date.now();
+          await expect(
+            client.recognize(exampleImage, { outputs: ["text"] }),
+          ).rejects.toMatchObject({
+            code: "ERR_DAEMON_TIMEOUT",
+            method: "recognize",
+          });
+          expect(Date.now() - started).toBeGreaterThanOrEqual(190);
+        },
+      );
+    },
+  );
+
+  describe.skipIf(process.platform === "win32" || !existsSync(ocrdPath))(
+    "against tesseract-ocrd",
+    () => {
+      let dir: string;
+      let socketPath: string;
+      let daemon: ChildProcess;
+
+      beforeAll(async () => {
+        dir = await mkdtemp(path.join(os.tmpdir(), "ocrd-"));
+        socketPath = path.join(dir, "ocrd.sock");
+
+        // provisions eng.traineddata in `dir` for the daemon
+        const tesseract = new Tesseract();
+        await tesseract.init({ langs: ["eng"], dataPath: dir });
+        await tesseract.end();
+
+        daemon = spawn(
+          ocrdPath,
+          [
+            ...["--socket", socketPath, "--langs", "eng"],
+            ...["--datapath", dir, "--engines", "1"],
+          ],
+          { stdio: ["ignore", "ignore", "inherit"] },
+        );
+        const deadline = Date.now() + 30_000;
+        while (!existsSync(socketPath)) {
+          if (daemon.exitCode !== null || Date.now() > deadline) {
+            throw new Error("tesseract-ocrd did not start");
+          }
+          await new Promise((resolve) => setTimeout(resolve, 50));
+        }
+      }, 120_000);
+
+      afterAll(async () => {
+        if (daemon && daemon.exitCode === null) {
+          const exited = new Promise((resolve) => daemon.once("exit", resolve));
+          daemon.kill("SIGTERM");
+          await exited;
+        }
+        await rm(dir, { recursive: true, force: true });
+      });
+
+      it("recognizes through shared memory and through the socket", async () => {
+        const client = new TesseractClient({ socketPath });
+
+        await expect(client.info()).resolves.toMatchObject({
+          langs: "eng",
+          engines: 1,
+        });
+
+        const fromBuffer = await client.recognize(exampleImage, {
+          outputs: ["text"],
+        });
+        expect(fromBuffer.path).toBe("");
+        expect(fromBuffer.text.trim().length).toBeGreaterThan(0);
+
+        const fromFile = await client.recognizeFile(exampleImagePath, {
+          outputs: ["text"],
+        });
+        expect(fromFile.path).toBe(exampleImagePath);
+        expect(fromFile.text).toBe(fromBuffer.text);
+      });
+
+      it("drops a malformed frame and keeps serving", async () => {
+        const socket = net.createConnection(socketPath);
+        socket.on("error", () => {});
+        const closed = new Promise((resolve) => socket.once("close", resolve));
+        socket.write(Buffer.alloc(64, 0xab));
+        await closed;
+
+        const client = new TesseractClient({ socketPath });
+        await expect(client.info()).resolves.toMatchObject({ engines: 1 });
+      });
+    },
+  );
+});
+
 describe("tesseract multipage status api", () => {
   let tempDir: string;
 
@@ -665,4 +1627,46 @@ describe("tesseract multipage status api", () => {
 
     await tesseract.end();
   });
+
+  it("stores page images by the session's image policy", async () => {
+    const tesseract = new Tesseract();
+    await tesseract.init({ langs: [Language.eng] });
+
+    const sizes: Record<string, number> = {};
+    for (const pageImage of [
+      { mode: "keep" },
+      { mode: "jpeg", dpi: 72, jpegQuality: 40 },
+      { mode: "bilevel" },
+    ] as const) {
+      const outputBase = path.join(tempDir, pageImage.mode);
+      await tesseract.document.begin({
+        outputBase,
+        title: "test-doc",
+        timeout: 0,
+        textonly: false,
+        pageImage,
+      });
+      await tesseract.document.addPage({ buffer: exampleImage });
+      const pdfPath = await tesseract.document.finish();
+      sizes[pageImage.mode] = (await stat(pdfPath)).size;
+    }
+
+    expect(sizes.jpeg).toBeLessThan(sizes.keep);
+    expect(sizes.bilevel).toBeGreaterThan(0);
+    // encoded page images are removed once they are in the PDF
+    expect(
+      (await readdir(tempDir)).filter((name) => !name.endsWith(".pdf")),
+    ).toStrictEqual([]);
+
+    await expect(
+      tesseract.document.begin({
+        title: "x",
+        timeout: 0,
+        textonly: false,
+        pageImage: { mode: "bilevel", dpi: 150 },
+      }),
+    ).rejects.toMatchObject({ code: "ERR_OUT_OF_RANGE" });
+
+    await tesseract.end();
+  });
 });
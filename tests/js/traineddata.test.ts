@@ -14,21 +14,41 @@
  * permissions and limitations under the License.
  */
 
-import { mkdir, mkdtemp, readFile, rm, writeFile } from "node:fs/promises";
+import {
+  mkdir,
+  mkdtemp,
+  readFile,
+  rm,
+  stat,
+  utimes,
+  writeFile,
+} from "node:fs/promises";
 import os from "node:os";
 import path from "node:path";
+import { pathToFileURL } from "node:url";
 import { ReadableStream } from "node:stream/web";
 import { gzipSync } from "node:zlib";
 import { afterEach, beforeEach, describe, expect, it, vi } from "vitest";
-import Tesseract, { Language } from "../../lib/index";
-import { isValidTraineddata } from "../../lib/utils";
+import Tesseract, { Language, OcrEngineModes } from "../../lib/index";
+import {
+  INTEGRITY_MANIFEST,
+  isValidTraineddata,
+  verifyTraineddata,
+} from "../../lib/utils";
+
+const inspectTraineddata = vi.hoisted(() =>
+  vi.fn((_: string) => ({ valid: true, components: 1, reason: "" })),
+);
 
 vi.mock("pkg-prebuilds", () => {
   const factory = () => ({
     Tesseract: class {
       async init() {}
+      async initCascade() {}
       async end() {}
     },
+    inspectTraineddata,
+    traineddataCompressions: ["none", "gzip"],
   });
   return factory as unknown as () => {
     Tesseract: new () => { init(): Promise<void>; end(): Promise<void> };
@@ -58,6 +78,43 @@ describe("traineddata utils", () => {
     await writeFile(filled, "ok");
     await expect(isValidTraineddata(filled)).resolves.toBe(true);
   });
+
+  it("trusts recorded traineddata after a stat", async () => {
+    const model = path.join(tempDir, "eng.traineddata");
+    await writeFile(model, "model-a");
+    const inspect = vi.fn(() => ({ valid: true, components: 1, reason: "" }));
+
+    await expect(verifyTraineddata(model, inspect)).resolves.toBe(true);
+    expect(inspect).toHaveBeenCalledTimes(1);
+    const manifest = JSON.parse(
+      await readFile(path.join(tempDir, INTEGRITY_MANIFEST), "utf8"),
+    );
+    expect(manifest.files["eng.traineddata"].sha256).toMatch(/^[0-9a-f]{64}$/);
+
+    await expect(verifyTraineddata(model, inspect)).resolves.toBe(true);
+    expect(inspect).toHaveBeenCalledTimes(1);
+
+    // same size, new content and mtime: modified in place
+    await writeFile(model, "model-b");
+    const later = new Date(Date.now() + 5000);
+    await utimes(model, later, later);
+    await expect(verifyTraineddata(model, inspect)).resolves.toBe(false);
+  });
+
+  it("rejects traineddata with a broken component table", async () => {
+    const model = path.join(tempDir, "eng.traineddata");
+    await writeFile(model, "garbage");
+    const inspect = vi.fn(() => ({
+      valid: false,
+      components: 0,
+      reason: "implausible component count",
+    }));
+
+    await expect(verifyTraineddata(model, inspect)).resolves.toBe(false);
+    await expect(
+      readFile(path.join(tempDir, INTEGRITY_MANIFEST), "utf8"),
+    ).rejects.toThrow();
+  });
 });
 
 describe("ensureTrainingData", () => {
@@ -102,6 +159,68 @@ describe("ensureTrainingData", () => {
     expect(fetchSpy).not.toHaveBeenCalled();
     expect(resultPath).toBe(path.join(dataDir, `${lang}.traineddata`));
     await expect(readFile(resultPath, "utf8")).resolves.toBe("cached");
+
+    // same device: linked, not copied
+    const [cached, linked] = await Promise.all([
+      stat(cachedPath),
+      stat(resultPath),
+    ]);
+    expect(linked.ino).toBe(cached.ino);
+  });
+
+  it("provisions from a file:// mirror without fetching", async () => {
+    const mirrorDir = await mkdtemp(path.join(os.tmpdir(), "tess-mirror-"));
+    try {
+      await writeFile(
+        path.join(mirrorDir, `${lang}.traineddata.gz`),
+        gzipSync(Buffer.from("mirrored")),
+      );
+      await writeFile(path.join(mirrorDir, "deu.traineddata"), "plain");
+
+      const fetchSpy = vi.fn();
+      vi.stubGlobal("fetch", fetchSpy);
+
+      const instance = new Tesseract();
+      const downloadBaseUrl = `${pathToFileURL(mirrorDir)}/`;
+      const [engPath, deuPath] = await Promise.all([
+        instance.ensureTrainingData({
+          lang,
+          dataPath: dataDir,
+          cachePath: cacheDir,
+          downloadBaseUrl,
+        }),
+        instance.ensureTrainingData({
+          lang: "deu" as Language,
+          dataPath: dataDir,
+          cachePath: cacheDir,
+          downloadBaseUrl,
+        }),
+      ]);
+
+      expect(fetchSpy).not.toHaveBeenCalled();
+      await expect(readFile(engPath, "utf8")).resolves.toBe("mirrored");
+      await expect(readFile(deuPath, "utf8")).resolves.toBe("plain");
+    } finally {
+      await rm(mirrorDir, { recursive: true, force: true });
+    }
+  });
+
+  it("picks the fast or best models of a mirror by engine mode", async () => {
+    const instance = new Tesseract();
+    const ensure = vi
+      .spyOn(instance, "ensureTrainingData")
+      .mockResolvedValue(path.join(dataDir, `${lang}.traineddata`));
+    const mirror = "https://mirror.example/tessdata";
+    const options = { langs: [lang], mirror, dataPath: dataDir };
+
+    await instance.init({ ...options });
+    await instance.init({ ...options, oem: OcrEngineModes.OEM_LSTM_ONLY });
+    await instance.initCascade({ ...options });
+
+    const urls = ensure.mock.calls
+      .filter(([request]) => request.lang === lang)
+      .map(([request]) => request.downloadBaseUrl);
+    expect(urls).toEqual([`${mirror}/`, `${mirror}/best/`, `${mirror}/best/`]);
   });
 
   it("downloads, decompresses, and reports progress", async () => {
@@ -148,4 +267,103 @@ describe("ensureTrainingData", () => {
     expect(lastCall?.totalBytes).toBe(gzipped.length);
     expect(lastCall?.percent).toBeCloseTo(100, 1);
   });
+
+  it("keeps gzip-compressed traineddata compressed", async () => {
+    const gzipped = gzipSync(Buffer.from("traineddata"));
+    vi.stubGlobal(
+      "fetch",
+      vi.fn().mockResolvedValue(
+        // @ts-expect-error
+        new Response(gzipped, { status: 200 }),
+      ),
+    );
+
+    const instance = new Tesseract();
+    const resultPath = await instance.ensureTrainingData({
+      lang,
+      dataPath: dataDir,
+      cachePath: cacheDir,
+      downloadBaseUrl,
+      compression: "gzip",
+    });
+
+    expect(resultPath).toBe(path.join(dataDir, `${lang}.traineddata.gz`));
+    await expect(readFile(resultPath)).resolves.toEqual(gzipped);
+    expect(inspectTraineddata).toHaveBeenLastCalledWith(
+      expect.stringMatching(/\.tmp\.gz$/),
+    );
+    await expect(
+      isValidTraineddata(path.join(dataDir, `${lang}.traineddata`)),
+    ).resolves.toBe(false);
+  });
+
+  it("refuses zstd when the addon cannot read it", async () => {
+    const fetchMock = vi.fn();
+    vi.stubGlobal("fetch", fetchMock);
+
+    const instance = new Tesseract();
+    await expect(
+      instance.ensureTrainingData({
+        lang,
+        dataPath: dataDir,
+        cachePath: cacheDir,
+        downloadBaseUrl,
+        compression: "zstd",
+      }),
+    ).rejects.toThrow(/without zstd support/);
+    expect(fetchMock).not.toHaveBeenCalled();
+  });
+
+  it("links a mirrored .gz in as it is when keeping gzip", async () => {
+    const mirrorDir = await mkdtemp(path.join(os.tmpdir(), "tess-mirror-"));
+    try {
+      const mirrored = path.join(mirrorDir, `${lang}.traineddata.gz`);
+      await writeFile(mirrored, gzipSync(Buffer.from("mirrored")));
+
+      const instance = new Tesseract();
+      const resultPath = await instance.ensureTrainingData({
+        lang,
+        dataPath: dataDir,
+        cachePath: cacheDir,
+        downloadBaseUrl: `${pathToFileURL(mirrorDir)}/`,
+        compression: "gzip",
+      });
+
+      const [source, linked] = await Promise.all([
+        stat(mirrored),
+        stat(resultPath),
+      ]);
+      expect(linked.ino).toBe(source.ino);
+    } finally {
+      await rm(mirrorDir, { recursive: true, force: true });
+    }
+  });
+
+  it("discards downloads with a corrupt component table", async () => {
+    vi.stubGlobal(
+      "fetch",
+      vi.fn().mockResolvedValue(
+        // @ts-expect-error
+        new Response(gzipSync(Buffer.from("truncated")), { status: 200 }),
+      ),
+    );
+    inspectTraineddata.mockReturnValueOnce({
+      valid: false,
+      components: 0,
+      reason: "shorter than the component table",
+    });
+
+    const instance = new Tesseract();
+    await expect(
+      instance.ensureTrainingData({
+        lang,
+        dataPath: dataDir,
+        cachePath: cacheDir,
+        downloadBaseUrl,
+      }),
+    ).rejects.toThrow(/corrupt: shorter than the component table/);
+    await expect(
+      isValidTraineddata(path.join(dataDir, `${lang}.traineddata`)),
+    ).resolves.toBe(false);
+  });
 });